@@ -0,0 +1,256 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/analysis.h>
+#include <cee/mppm/config.h>
+
+#include <cee/core/thread_pool.h>
+
+#include <fmt/format.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+
+/*
+ * Batch analysis of recordings made with --record, through the same
+ * signal chain as the monitor. Prints one CSV row per recording, and
+ * optionally every NIBP measurement, then a summary on stderr.
+ */
+
+enum {
+	ARG_MAINS = 1,
+	ARG_OVERSAMPLE,
+	ARG_DECIMATOR,
+	ARG_SEGMENT,
+	ARG_WARMUP,
+	ARG_NIBP
+};
+
+static const char *g_OptString = "j:o:hv";
+static const option g_LongOptions[] = {
+	{ "help", no_argument, nullptr, 'h' },
+	{ "version", no_argument, nullptr, 'v' },
+	{ "threads", required_argument, nullptr, 'j' },
+	{ "output", required_argument, nullptr, 'o' },
+	{ "mains", required_argument, nullptr, ARG_MAINS },
+	{ "oversample", required_argument, nullptr, ARG_OVERSAMPLE },
+	{ "decimator", required_argument, nullptr, ARG_DECIMATOR },
+	{ "segment", required_argument, nullptr, ARG_SEGMENT },
+	{ "warmup", required_argument, nullptr, ARG_WARMUP },
+	{ "nibp", required_argument, nullptr, ARG_NIBP },
+	{ nullptr, 0, nullptr, 0 }
+};
+
+static const char *CHANNEL_NAMES[cee::SignalChain::CHANNEL_COUNT] = { "lead_ii", "pressure", "oscillation" };
+
+static void PrintHelpMessage(const char *cmd) {
+	std::printf("Usage: %s [options] <recording>...\n", cmd);
+	std::printf("Options:\n");
+	std::printf("\t-h, --help       Show this help message and exit\n");
+	std::printf("\t-j, --threads=<n> Worker threads, default: one per core\n");
+	std::printf("\t-o, --output=<file> Write the per-recording results there. default: stdout\n");
+	std::printf("\t--nibp=<file>    Also write every NIBP measurement\n");
+	std::printf("\t--mains=<hz>     Mains frequency to notch out {50|60} default: 50\n");
+	std::printf("\t--oversample=<n> Override the oversampling the recordings were made with {1-64}\n");
+	std::printf("\t                 default: from the recording, 1 if it doesn't say\n");
+	std::printf("\t--decimator=<filter> Override the decimation filter {average|cic|fir}\n");
+	std::printf("\t                 default: from the recording, cic if it doesn't say\n");
+	std::printf("\t--segment=<s>    Seconds of recording per task. default: 600\n");
+	std::printf("\t--warmup=<s>     Seconds processed and discarded ahead of each segment. default: 120\n");
+	std::printf("\t-v, --version    Show version information and exit\n");
+	std::exit(0);
+}
+
+static void PrintVersion() {
+	std::printf("ceeMPPM analysis version %d.%d\n", MPPM_VERSION_MAJOR, MPPM_VERSION_MINOR);
+	std::exit(0);
+}
+
+static double ParseSeconds(const char *arg, const char *what, const char *cmd) {
+	char *end = nullptr;
+	double seconds = std::strtod(arg, &end);
+	if (end == arg || *end != '\0' || !(seconds >= 0.0)) {
+		std::fprintf(stderr, "Invalid %s: %s\n", what, arg);
+		PrintHelpMessage(cmd);
+	}
+	return seconds;
+}
+
+static FILE *OpenOutput(const std::string &path) {
+	if (path.empty() || path == "-")
+		return stdout;
+	FILE *file = std::fopen(path.c_str(), "w");
+	if (!file) {
+		std::fprintf(stderr, "Failed to open %s: %s\n", path.c_str(), std::strerror(errno));
+		std::exit(EXIT_FAILURE);
+	}
+	return file;
+}
+
+static void WriteResults(FILE *out, const std::vector<cee::AnalysisResult> &results) {
+	fmt::print(out, "path,status,duration_s,samples,segments,beats,hr_min,hr_mean,hr_max,nibp_ok,nibp_failed");
+	for (const char *name : CHANNEL_NAMES)
+		fmt::print(out, ",{0}_min,{0}_mean,{0}_max,{0}_std", name);
+	fmt::print(out, "\n");
+
+	for (const cee::AnalysisResult &result : results) {
+		std::size_t valid = 0;
+		for (const cee::NibpMeasurement &measurement : result.nibp)
+			valid += measurement.result.IsValid() ? 1 : 0;
+		const char *status = !result.IsValid() ? "error" : result.recovered ? "recovered" : "ok";
+		fmt::print(out, "{},{},{:.3f},{},{},{},{:.1f},{:.1f},{:.1f},{},{}", result.path, status, result.duration,
+				result.sampleCount, result.segmentCount, result.beatCount, result.minHeartRate,
+				result.meanHeartRate, result.maxHeartRate, valid, result.nibp.size() - valid);
+		for (const cee::ChannelSummary &channel : result.channels)
+			fmt::print(out, ",{:.5f},{:.5f},{:.5f},{:.5f}", channel.min, channel.mean, channel.max, channel.stdDev);
+		fmt::print(out, "\n");
+	}
+}
+
+static void WriteNibp(FILE *out, const std::vector<cee::AnalysisResult> &results) {
+	fmt::print(out, "path,timestamp_ns,status,systolic,diastolic,mean,pulses\n");
+	for (const cee::AnalysisResult &result : results) {
+		for (const cee::NibpMeasurement &measurement : result.nibp) {
+			const cee::dsp::NibpResult &nibp = measurement.result;
+			fmt::print(out, "{},{},{},{:.1f},{:.1f},{:.1f},{}\n", result.path, measurement.timestamp,
+					cee::dsp::NibpResult::StatusName(nibp.status), nibp.systolic, nibp.diastolic, nibp.mean,
+					nibp.pulseCount);
+		}
+	}
+}
+
+int main(int argc, char **argv) {
+	cee::AnalysisOptions options;
+	std::size_t threads = 0;
+	std::string outputPath;
+	std::string nibpPath;
+
+	int opt;
+	while ((opt = getopt_long(argc, argv, g_OptString, g_LongOptions, nullptr)) != -1) {
+		switch (opt) {
+		case 'j': {
+			char *end = nullptr;
+			long count = std::strtol(optarg, &end, 10);
+			if (end == optarg || *end != '\0' || count < 1) {
+				std::fprintf(stderr, "Invalid thread count: %s\n", optarg);
+				PrintHelpMessage(argv[0]);
+			}
+			threads = static_cast<std::size_t>(count);
+			break;
+		}
+		case 'o':
+			outputPath = optarg;
+			break;
+		case ARG_NIBP:
+			nibpPath = optarg;
+			break;
+		case ARG_MAINS:
+			if (strcmp(optarg, "50") == 0) {
+				options.mainsFrequency = 50.f;
+			} else if (strcmp(optarg, "60") == 0) {
+				options.mainsFrequency = 60.f;
+			} else {
+				std::fprintf(stderr, "Invalid mains frequency: %s\n", optarg);
+				PrintHelpMessage(argv[0]);
+			}
+			break;
+		case ARG_OVERSAMPLE: {
+			char *end = nullptr;
+			long factor = std::strtol(optarg, &end, 10);
+			if (end == optarg || *end != '\0' || factor < 1 ||
+					factor > static_cast<long>(cee::dsp::Decimator<float>::MAX_FACTOR)) {
+				std::fprintf(stderr, "Invalid oversampling factor: %s\n", optarg);
+				PrintHelpMessage(argv[0]);
+			}
+			options.oversampling = static_cast<std::size_t>(factor);
+			break;
+		}
+		case ARG_DECIMATOR:
+			if (strcmp(optarg, "average") == 0) {
+				options.decimator = cee::dsp::DecimatorKind::AVERAGE;
+			} else if (strcmp(optarg, "cic") == 0) {
+				options.decimator = cee::dsp::DecimatorKind::CIC;
+			} else if (strcmp(optarg, "fir") == 0) {
+				options.decimator = cee::dsp::DecimatorKind::FIR;
+			} else {
+				std::fprintf(stderr, "Invalid decimator: %s\n", optarg);
+				PrintHelpMessage(argv[0]);
+			}
+			break;
+		case ARG_SEGMENT:
+			options.segmentDuration = ParseSeconds(optarg, "segment duration", argv[0]);
+			break;
+		case ARG_WARMUP:
+			options.warmup = ParseSeconds(optarg, "warmup", argv[0]);
+			break;
+		case 'v':
+			PrintVersion();
+			break;
+		case 'h':
+		default:
+			PrintHelpMessage(argv[0]);
+			break;
+		}
+	}
+	if (optind == argc) {
+		std::fprintf(stderr, "No recordings given\n");
+		PrintHelpMessage(argv[0]);
+	}
+	std::vector<std::string> paths(argv + optind, argv + argc);
+
+	cee::ThreadPool pool(threads);
+	auto start = std::chrono::steady_clock::now();
+	std::vector<cee::AnalysisResult> results = cee::AnalyseRecordings(pool, paths, options);
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	FILE *out = OpenOutput(outputPath);
+	WriteResults(out, results);
+	if (out != stdout)
+		std::fclose(out);
+	if (!nibpPath.empty()) {
+		FILE *nibp = OpenOutput(nibpPath);
+		WriteNibp(nibp, results);
+		if (nibp != stdout)
+			std::fclose(nibp);
+	}
+
+	double recorded = 0.0;
+	std::size_t segments = 0;
+	int failed = 0;
+	for (const cee::AnalysisResult &result : results) {
+		recorded += result.duration;
+		segments += result.segmentCount;
+		if (!result.IsValid()) {
+			std::fprintf(stderr, "%s: %s\n", result.path.c_str(), result.error.c_str());
+			++failed;
+		}
+	}
+	std::fprintf(stderr, "Analysed %.1f h of %zu recordings in %zu segments in %.1f s on %zu threads, "
+			"%.0fx real time, %llu segments stolen\n", recorded / 3600.0, results.size(), segments, elapsed,
+			pool.GetThreadCount(), elapsed > 0.0 ? recorded / elapsed : 0.0,
+			static_cast<unsigned long long>(pool.GetStolenCount()));
+
+	return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
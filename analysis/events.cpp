@@ -0,0 +1,138 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/config.h>
+
+#include <cee/core/event_log.h>
+
+#include <fmt/format.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <string>
+
+#include <getopt.h>
+
+/*
+ * Decodes event logs written with --events to text, one line per event
+ * with its wall clock time and the seconds since the log started.
+ */
+
+enum {
+	ARG_MONOTONIC = 1
+};
+
+static const char *g_OptString = "o:hv";
+static const option g_LongOptions[] = {
+	{ "help", no_argument, nullptr, 'h' },
+	{ "version", no_argument, nullptr, 'v' },
+	{ "output", required_argument, nullptr, 'o' },
+	{ "monotonic", no_argument, nullptr, ARG_MONOTONIC },
+	{ nullptr, 0, nullptr, 0 }
+};
+
+static void PrintHelpMessage(const char *cmd) {
+	std::printf("Usage: %s [options] <event log>...\n", cmd);
+	std::printf("Options:\n");
+	std::printf("\t-h, --help       Show this help message and exit\n");
+	std::printf("\t-o, --output=<file> Write the events there. default: stdout\n");
+	std::printf("\t--monotonic      Print CLOCK_MONOTONIC timestamps instead of the wall clock\n");
+	std::printf("\t-v, --version    Show version information and exit\n");
+	std::exit(0);
+}
+
+static void PrintVersion() {
+	std::printf("ceeMPPM event decoder version %d.%d\n", MPPM_VERSION_MAJOR, MPPM_VERSION_MINOR);
+	std::exit(0);
+}
+
+static std::string WallClock(const cee::EventLogHeader &header, uint64_t timestamp) {
+	int64_t realtime = static_cast<int64_t>(header.startTime)
+		+ (static_cast<int64_t>(timestamp) - static_cast<int64_t>(header.startMonotonic));
+	std::time_t seconds = static_cast<std::time_t>(realtime / 1000000000);
+	std::tm time{};
+	localtime_r(&seconds, &time);
+	return fmt::format("{:04}-{:02}-{:02} {:02}:{:02}:{:02}.{:06}", time.tm_year + 1900, time.tm_mon + 1,
+			time.tm_mday, time.tm_hour, time.tm_min, time.tm_sec, (realtime % 1000000000) / 1000);
+}
+
+int main(int argc, char **argv) {
+	std::string outputPath;
+	bool monotonic = false;
+
+	int opt;
+	while ((opt = getopt_long(argc, argv, g_OptString, g_LongOptions, nullptr)) != -1) {
+		switch (opt) {
+		case 'o':
+			outputPath = optarg;
+			break;
+		case ARG_MONOTONIC:
+			monotonic = true;
+			break;
+		case 'v':
+			PrintVersion();
+			break;
+		case 'h':
+		default:
+			PrintHelpMessage(argv[0]);
+			break;
+		}
+	}
+	if (optind == argc) {
+		std::fprintf(stderr, "No event logs given\n");
+		PrintHelpMessage(argv[0]);
+	}
+
+	FILE *out = stdout;
+	if (!outputPath.empty() && outputPath != "-") {
+		out = std::fopen(outputPath.c_str(), "w");
+		if (!out) {
+			std::fprintf(stderr, "Failed to open %s: %s\n", outputPath.c_str(), std::strerror(errno));
+			return EXIT_FAILURE;
+		}
+	}
+
+	int failed = 0;
+	for (int i = optind; i < argc; ++i) {
+		try {
+			cee::EventLogReader reader(argv[i]);
+			const cee::EventLogHeader &header = reader.GetHeader();
+			if (argc - optind > 1)
+				fmt::print(out, "# {}\n", argv[i]);
+			cee::EventLogEntry entry;
+			while (reader.Next(entry)) {
+				double elapsed = static_cast<double>(static_cast<int64_t>(entry.timestamp - header.startMonotonic)) * 1e-9;
+				std::string time = monotonic ? fmt::format("{}", entry.timestamp) : WallClock(header, entry.timestamp);
+				const char *marker = entry.kind == cee::EventLogEntry::Kind::DROPPED ? "!" : " ";
+				fmt::print(out, "{} {:+12.6f}{}{}\n", time, elapsed, marker, entry.text);
+			}
+			if (reader.IsTruncated())
+				std::fprintf(stderr, "%s: Last record cut short\n", argv[i]);
+		} catch (const std::exception &e) {
+			std::fprintf(stderr, "%s: %s\n", argv[i], e.what());
+			++failed;
+		}
+	}
+	if (out != stdout)
+		std::fclose(out);
+	return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,116 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/config.h>
+#include <cee/mppm/export.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <string>
+
+#include <getopt.h>
+
+/*
+ * Converts recordings made with --record to EDF+ or WFDB, one output per
+ * recording named after it.
+ */
+
+enum class Format {
+	EDF,
+	WFDB
+};
+
+static const char *g_OptString = "f:o:hv";
+static const option g_LongOptions[] = {
+	{ "help", no_argument, nullptr, 'h' },
+	{ "version", no_argument, nullptr, 'v' },
+	{ "format", required_argument, nullptr, 'f' },
+	{ "output", required_argument, nullptr, 'o' },
+	{ nullptr, 0, nullptr, 0 }
+};
+
+static void PrintHelpMessage(const char *cmd) {
+	std::printf("Usage: %s [options] <recording>...\n", cmd);
+	std::printf("Options:\n");
+	std::printf("\t-h, --help       Show this help message and exit\n");
+	std::printf("\t-f, --format=<format> Output format {edf|wfdb} default: edf\n");
+	std::printf("\t-o, --output=<dir> Directory to write the exports to. default: .\n");
+	std::printf("\t-v, --version    Show version information and exit\n");
+	std::exit(0);
+}
+
+static void PrintVersion() {
+	std::printf("ceeMPPM export version %d.%d\n", MPPM_VERSION_MAJOR, MPPM_VERSION_MINOR);
+	std::exit(0);
+}
+
+int main(int argc, char **argv) {
+	Format format = Format::EDF;
+	std::filesystem::path outputDir = ".";
+
+	int opt;
+	while ((opt = getopt_long(argc, argv, g_OptString, g_LongOptions, nullptr)) != -1) {
+		switch (opt) {
+		case 'f':
+			if (strcmp(optarg, "edf") == 0) {
+				format = Format::EDF;
+			} else if (strcmp(optarg, "wfdb") == 0) {
+				format = Format::WFDB;
+			} else {
+				std::fprintf(stderr, "Invalid format: %s\n", optarg);
+				PrintHelpMessage(argv[0]);
+			}
+			break;
+		case 'o':
+			outputDir = optarg;
+			break;
+		case 'v':
+			PrintVersion();
+			break;
+		case 'h':
+		default:
+			PrintHelpMessage(argv[0]);
+			break;
+		}
+	}
+	if (optind == argc) {
+		std::fprintf(stderr, "No recordings given\n");
+		PrintHelpMessage(argv[0]);
+	}
+
+	int failed = 0;
+	for (int i = optind; i < argc; ++i) {
+		std::filesystem::path output = outputDir / std::filesystem::path(argv[i]).stem();
+		try {
+			if (format == Format::EDF) {
+				output += ".edf";
+				cee::ExportEdf(argv[i], output.string());
+			} else {
+				cee::ExportWfdb(argv[i], output.string());
+			}
+			std::fprintf(stderr, "%s -> %s\n", argv[i], output.c_str());
+		} catch (const std::exception &e) {
+			std::fprintf(stderr, "%s: %s\n", argv[i], e.what());
+			++failed;
+		}
+	}
+	return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,300 @@
+/*
+ * ceeCore
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/core/event_log.h>
+#include <cee/core/except.h>
+
+#include <fmt/args.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <limits>
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace cee {
+	struct EventDefinition {
+		std::string format;
+		std::vector<EventArgType> args;
+	};
+
+	// Formats of the whole process, never shrinks so ids stay valid
+	static std::mutex g_DefinitionsMutex;
+	static std::vector<EventDefinition> g_Definitions;
+
+	static constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+
+	static uint64_t ClockNow(clockid_t clock) {
+		timespec ts;
+		clock_gettime(clock, &ts);
+		return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+	}
+
+	bool EventLogHeader::IsValid() const {
+		return std::equal(std::begin(magic), std::end(magic), std::begin(MAGIC)) && version == VERSION
+			&& endianMark == ENDIAN_MARK;
+	}
+
+	EventLog::Id EventLog::Define(std::string_view format, std::span<const EventArgType> args) {
+		if (format.size() > std::numeric_limits<uint16_t>::max() || args.size() > std::numeric_limits<uint8_t>::max())
+			throw core::InvalidParameter("EventLog::Define(): Format too long");
+		std::lock_guard<std::mutex> lock(g_DefinitionsMutex);
+		if (g_Definitions.size() == MAX_FORMATS)
+			throw core::InvalidParameter("EventLog::Define(): Too many formats");
+		g_Definitions.push_back({ std::string(format), std::vector<EventArgType>(args.begin(), args.end()) });
+		return static_cast<Id>(g_Definitions.size() - 1);
+	}
+
+	EventLog::EventLog(const std::string &path)
+	 : m_Path(path), m_Fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)),
+	 m_DroppedCount(0), m_Stopping(false), m_DefinedCount(0), m_ReportedDropped(0) {
+		if (m_Fd < 0)
+			throw core::FileError(fmt::format("Cannot create event log {} ({})", m_Path, strerror(errno)));
+		m_Buffer.reserve(BUFFER_SIZE);
+
+		EventLogHeader header{};
+		std::copy(std::begin(EventLogHeader::MAGIC), std::end(EventLogHeader::MAGIC), header.magic);
+		header.version = EventLogHeader::VERSION;
+		header.endianMark = EventLogHeader::ENDIAN_MARK;
+		header.startTime = ClockNow(CLOCK_REALTIME);
+		header.startMonotonic = ClockNow(CLOCK_MONOTONIC);
+		m_Timestamp = header.startMonotonic;
+		Append(&header, sizeof(header));
+		try {
+			Flush();
+		} catch (...) {
+			::close(m_Fd);
+			throw;
+		}
+
+		m_Thread = std::thread(&EventLog::WriterMain, this);
+	}
+
+	EventLog::~EventLog() {
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Stopping.store(true, std::memory_order_release);
+		}
+		m_Wake.notify_one();
+		m_Thread.join();
+		try {
+			// Anything queued by a thread still writing as the log stopped
+			Drain();
+			Flush();
+		} catch (const core::Error &) {
+		}
+		::close(m_Fd);
+	}
+
+	void EventLog::WriterMain() {
+		try {
+			for (;;) {
+				bool stopping = m_Stopping.load(std::memory_order_acquire);
+				bool wrote = Drain();
+				Flush();
+				if (stopping)
+					return;
+				if (wrote)
+					continue;
+
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Wake.wait_for(lock, POLL_INTERVAL, [this] { return m_Stopping.load(std::memory_order_acquire); });
+			}
+		} catch (const core::Error &) {
+			// The file can't be written any more, count what is left as
+			// dropped rather than let the queue fill up silently
+			while (!m_Stopping.load(std::memory_order_acquire)) {
+				while (m_Queue.TryDequeue(m_Event))
+					m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Wake.wait_for(lock, POLL_INTERVAL, [this] { return m_Stopping.load(std::memory_order_acquire); });
+			}
+		}
+	}
+
+	bool EventLog::Drain() {
+		bool wrote = false;
+		while (m_Queue.TryDequeue(m_Event)) {
+			wrote = true;
+			if (m_Event.id >= m_DefinedCount) {
+				std::lock_guard<std::mutex> lock(g_DefinitionsMutex);
+				if (m_Event.id >= g_Definitions.size())
+					continue;
+				for (; m_DefinedCount <= m_Event.id; ++m_DefinedCount) {
+					const EventDefinition &definition = g_Definitions[m_DefinedCount];
+					Append(DEFINE);
+					Append(static_cast<Id>(m_DefinedCount));
+					Append(static_cast<uint8_t>(definition.args.size()));
+					Append(static_cast<uint16_t>(definition.format.size()));
+					Append(definition.args.data(), definition.args.size());
+					Append(definition.format.data(), definition.format.size());
+				}
+			}
+
+			// Threads take their timestamps before they race to the queue,
+			// so events can be slightly out of order
+			int64_t delta = static_cast<int64_t>(m_Event.timestamp - m_Timestamp);
+			if (delta < std::numeric_limits<int32_t>::min() || delta > std::numeric_limits<int32_t>::max()) {
+				Append(TIME);
+				Append(m_Event.timestamp);
+				delta = 0;
+			}
+			m_Timestamp = m_Event.timestamp;
+			Append(m_Event.id);
+			Append(static_cast<int32_t>(delta));
+			Append(m_Event.args, m_Event.size);
+			if (m_Buffer.size() >= BUFFER_SIZE)
+				Flush();
+		}
+
+		uint64_t dropped = m_DroppedCount.load(std::memory_order_relaxed);
+		if (dropped != m_ReportedDropped) {
+			Append(DROPPED);
+			Append(dropped - m_ReportedDropped);
+			m_ReportedDropped = dropped;
+		}
+		return wrote;
+	}
+
+	void EventLog::Append(const void *data, std::size_t size) {
+		const uint8_t *bytes = static_cast<const uint8_t *>(data);
+		m_Buffer.insert(m_Buffer.end(), bytes, bytes + size);
+	}
+
+	void EventLog::Flush() {
+		std::size_t written = 0;
+		while (written < m_Buffer.size()) {
+			ssize_t result = ::write(m_Fd, m_Buffer.data() + written, m_Buffer.size() - written);
+			if (result < 0 && errno == EINTR)
+				continue;
+			if (result <= 0)
+				throw core::FileError(fmt::format("Failed to write event log {} ({})", m_Path, strerror(errno)));
+			written += static_cast<std::size_t>(result);
+		}
+		m_Buffer.clear();
+	}
+
+	EventLogReader::EventLogReader(const std::string &path)
+	 : m_Path(path), m_File(path, std::ios::binary), m_Header{}, m_Timestamp(0), m_Truncated(false) {
+		if (!m_File)
+			throw core::FileError(fmt::format("Cannot open event log {}", m_Path));
+		if (!Read(m_Header) || !m_Header.IsValid())
+			throw core::FileError(fmt::format("{} is not an event log", m_Path));
+		m_Timestamp = m_Header.startMonotonic;
+	}
+
+	bool EventLogReader::Next(EventLogEntry &entry) {
+		EventLog::Id id;
+		while (Read(id)) {
+			switch (id) {
+			case EventLog::DEFINE: {
+				EventLog::Id defined;
+				uint8_t argCount;
+				uint16_t length;
+				if (!Read(defined) || !Read(argCount) || !Read(length))
+					return false;
+				Format format;
+				format.args.resize(argCount);
+				format.format.resize(length);
+				if (!Read(format.args.data(), argCount) || !Read(format.format.data(), length))
+					return false;
+				format.argsSize = 0;
+				for (EventArgType type : format.args)
+					format.argsSize += EventArgSize(type);
+				if (defined != m_Formats.size())
+					throw core::FileError(fmt::format("{}: Format {} defined out of order", m_Path, defined));
+				m_Formats.push_back(std::move(format));
+				break;
+			}
+			case EventLog::TIME:
+				if (!Read(m_Timestamp))
+					return false;
+				break;
+			case EventLog::DROPPED:
+				if (!Read(entry.droppedCount))
+					return false;
+				entry.kind = EventLogEntry::Kind::DROPPED;
+				entry.timestamp = m_Timestamp;
+				entry.id = EventLog::DROPPED;
+				entry.text = fmt::format("{} events dropped", entry.droppedCount);
+				return true;
+			default: {
+				if (id >= m_Formats.size())
+					throw core::FileError(fmt::format("{}: Event of undefined format {}", m_Path, id));
+				const Format &format = m_Formats[id];
+				int32_t delta;
+				uint8_t args[EventLog::MAX_ARGS_SIZE];
+				if (format.argsSize > sizeof(args))
+					throw core::FileError(fmt::format("{}: Format {} has too many arguments", m_Path, id));
+				if (!Read(delta) || !Read(args, format.argsSize))
+					return false;
+
+				fmt::dynamic_format_arg_store<fmt::format_context> store;
+				const uint8_t *arg = args;
+				for (EventArgType type : format.args) {
+					auto push = [&]<typename T>(T) {
+						T value;
+						std::memcpy(&value, arg, sizeof(T));
+						store.push_back(value);
+					};
+					switch (type) {
+					case EventArgType::BOOL: push(bool()); break;
+					case EventArgType::I8: push(int8_t()); break;
+					case EventArgType::U8: push(uint8_t()); break;
+					case EventArgType::I16: push(int16_t()); break;
+					case EventArgType::U16: push(uint16_t()); break;
+					case EventArgType::I32: push(int32_t()); break;
+					case EventArgType::U32: push(uint32_t()); break;
+					case EventArgType::I64: push(int64_t()); break;
+					case EventArgType::U64: push(uint64_t()); break;
+					case EventArgType::F32: push(float()); break;
+					case EventArgType::F64: push(double()); break;
+					}
+					arg += EventArgSize(type);
+				}
+
+				m_Timestamp += static_cast<uint64_t>(static_cast<int64_t>(delta));
+				entry.kind = EventLogEntry::Kind::EVENT;
+				entry.timestamp = m_Timestamp;
+				entry.id = id;
+				entry.droppedCount = 0;
+				try {
+					entry.text = fmt::vformat(format.format, store);
+				} catch (const fmt::format_error &e) {
+					entry.text = fmt::format("{} <{}>", format.format, e.what());
+				}
+				return true;
+			}
+			}
+		}
+		return false;
+	}
+
+	bool EventLogReader::Read(void *data, std::size_t size) {
+		if (size == 0)
+			return true;
+		m_File.read(static_cast<char *>(data), static_cast<std::streamsize>(size));
+		if (m_File.gcount() == static_cast<std::streamsize>(size))
+			return true;
+		// Part of a record at the end of the file
+		m_Truncated = m_File.gcount() > 0 || m_Truncated;
+		return false;
+	}
+}
@@ -0,0 +1,59 @@
+/*
+ * ceeCore
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_CORE_CRC_H_
+#define CEE_CORE_CRC_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace cee {
+	namespace detail {
+		constexpr std::array<uint32_t, 256> MakeCrc32Table() {
+			std::array<uint32_t, 256> table{};
+			for (uint32_t i = 0; i < 256; ++i) {
+				uint32_t crc = i;
+				for (int bit = 0; bit < 8; ++bit)
+					crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+				table[i] = crc;
+			}
+			return table;
+		}
+
+		inline constexpr std::array<uint32_t, 256> CRC32_TABLE = MakeCrc32Table();
+	}
+
+	/*
+	 * CRC-32 as used by zlib and PNG. Pass the result of a previous call as
+	 * crc to continue over data that isn't contiguous.
+	 */
+	constexpr uint32_t Crc32(std::span<const uint8_t> data, uint32_t crc = 0) {
+		crc = ~crc;
+		for (uint8_t byte : data)
+			crc = detail::CRC32_TABLE[(crc ^ byte) & 0xFF] ^ (crc >> 8);
+		return ~crc;
+	}
+
+	inline uint32_t Crc32(const void *data, std::size_t size, uint32_t crc = 0) {
+		return Crc32(std::span<const uint8_t>(static_cast<const uint8_t *>(data), size), crc);
+	}
+}
+
+#endif
@@ -0,0 +1,305 @@
+/*
+ * ceeCore
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_CORE_EVENT_LOG_H_
+#define CEE_CORE_EVENT_LOG_H_
+
+#include <cee/core/ringbuffer.h>
+
+#include <fmt/format.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Writes an event to an EventLog. The format is checked against the
+ * arguments at compile time and given an id the first time the call is
+ * reached, after that each call only copies its arguments into the
+ * log's queue. Arguments must be arithmetic.
+ *
+ *     CEE_EVENT(events, "ADC read failed at sample {}", sampleCount);
+ */
+#define CEE_EVENT(log, format, ...) \
+	do { \
+		static const ::cee::EventLog::Id ceeEventId = ::cee::EventLog::Define( \
+				decltype(::cee::detail::EventArgs(__VA_ARGS__)){}, format); \
+		(log).Write(ceeEventId __VA_OPT__(,) __VA_ARGS__); \
+	} while (0)
+
+namespace cee {
+	enum class EventArgType : uint8_t {
+		BOOL = 0,
+		I8,
+		U8,
+		I16,
+		U16,
+		I32,
+		U32,
+		I64,
+		U64,
+		F32,
+		F64,
+	};
+
+	namespace detail {
+		template<typename ...Args>
+		struct EventArgList {};
+
+		// Only used unevaluated, to name the types of a macro's arguments
+		template<typename ...Args>
+		EventArgList<std::remove_cvref_t<Args>...> EventArgs(Args &&...args);
+
+		template<typename T>
+		constexpr EventArgType EventArgTypeOf() {
+			static_assert(std::is_arithmetic_v<T>, "Event arguments must be arithmetic");
+			static_assert(sizeof(T) <= 8, "Event arguments are at most 64 bits");
+			if constexpr (std::is_same_v<T, bool>)
+				return EventArgType::BOOL;
+			else if constexpr (std::is_floating_point_v<T>)
+				return sizeof(T) == 4 ? EventArgType::F32 : EventArgType::F64;
+			else if constexpr (std::is_signed_v<T>)
+				return sizeof(T) == 1 ? EventArgType::I8 : sizeof(T) == 2 ? EventArgType::I16
+					: sizeof(T) == 4 ? EventArgType::I32 : EventArgType::I64;
+			else
+				return sizeof(T) == 1 ? EventArgType::U8 : sizeof(T) == 2 ? EventArgType::U16
+					: sizeof(T) == 4 ? EventArgType::U32 : EventArgType::U64;
+		}
+	}
+
+	constexpr std::size_t EventArgSize(EventArgType type) {
+		switch (type) {
+		case EventArgType::BOOL:
+		case EventArgType::I8:
+		case EventArgType::U8:
+			return 1;
+		case EventArgType::I16:
+		case EventArgType::U16:
+			return 2;
+		case EventArgType::I32:
+		case EventArgType::U32:
+		case EventArgType::F32:
+			return 4;
+		case EventArgType::I64:
+		case EventArgType::U64:
+		case EventArgType::F64:
+			return 8;
+		}
+		return 0;
+	}
+
+	/*
+	 * Event log file layout, in the byte order of the machine that wrote
+	 * it. The header is followed by records, each starting with a 16 bit
+	 * id:
+	 *
+	 *     DEFINE   u16 id, u8 argument count, u16 format length, the
+	 *              EventArgType of each argument, then the format
+	 *     TIME     u64 CLOCK_MONOTONIC timestamp the next event is
+	 *              relative to
+	 *     DROPPED  u64 events lost to a full queue since the last one
+	 *     other    an event of a defined format: i32 nanoseconds since
+	 *              the previous timestamp, then the raw arguments
+	 *
+	 * Formats are defined in the file before their first event.
+	 */
+	struct EventLogHeader {
+		static constexpr char MAGIC[8] = { 'C', 'E', 'E', 'E', 'V', 'E', 'N', 'T' };
+		static constexpr uint32_t VERSION = 1;
+		static constexpr uint32_t ENDIAN_MARK = 0x01020304;
+
+		char magic[8];
+		uint32_t version;
+		uint32_t endianMark;     // ENDIAN_MARK as written
+		uint64_t startTime;      // CLOCK_REALTIME at startMonotonic, nanoseconds
+		uint64_t startMonotonic; // CLOCK_MONOTONIC, nanoseconds
+
+		bool IsValid() const;
+	};
+	static_assert(sizeof(EventLogHeader) == 32, "Event log header layout changed");
+
+	/*
+	 * Binary log for diagnostics too frequent to format as text, such as
+	 * per-sample or per-frame events. Writing an event copies a timestamp,
+	 * the id of its format and its raw arguments into a lock-free queue,
+	 * which never blocks: a full queue drops the event and counts it. A
+	 * writer thread packs the queue into the file, and EventLogReader or
+	 * the mppm-events tool turn it into text afterwards.
+	 *
+	 * Formats are registered once per process, shared by every EventLog,
+	 * and written to each file the first time it is needed so files are
+	 * self-describing.
+	 */
+	class EventLog {
+	public:
+		using Id = uint16_t;
+		// Ids from here up are records of the file format
+		static constexpr Id MAX_FORMATS = 0xFFF0;
+		static constexpr Id DEFINE = 0xFFFF;
+		static constexpr Id TIME = 0xFFFE;
+		static constexpr Id DROPPED = 0xFFFD;
+
+		static constexpr std::size_t QUEUE_SIZE = 4096;
+		static constexpr std::size_t MAX_ARGS_SIZE = 48;
+		static constexpr std::chrono::milliseconds POLL_INTERVAL{ 10 };
+
+	public:
+		// Throws core::FileError if the file can't be created
+		explicit EventLog(const std::string &path);
+		// Writes out what is still queued
+		~EventLog();
+
+		EventLog(const EventLog &) = delete;
+		EventLog &operator=(const EventLog &) = delete;
+
+		// Any thread. Throws core::InvalidParameter when MAX_FORMATS are
+		// registered. Meant to be called once per call site, CEE_EVENT
+		// keeps the id in a static.
+		static Id Define(std::string_view format, std::span<const EventArgType> args);
+
+		template<typename ...Args>
+		static Id Define(detail::EventArgList<Args...>, fmt::format_string<Args...> format) {
+			static constexpr std::array<EventArgType, sizeof...(Args)> TYPES = {
+				detail::EventArgTypeOf<Args>()...
+			};
+			fmt::string_view text = format;
+			return Define(std::string_view(text.data(), text.size()), TYPES);
+		}
+
+		// Any thread, never blocks. The arguments must have the types id was
+		// defined with, which CEE_EVENT takes care of.
+		template<typename ...Args>
+		void Write(Id id, const Args &...args) {
+			static_assert((sizeof(Args) + ... + 0) <= MAX_ARGS_SIZE, "Event arguments too large");
+			Event event;
+			event.timestamp = Now();
+			event.id = id;
+			event.size = 0;
+			((std::memcpy(event.args + event.size, &args, sizeof(Args)), event.size += sizeof(Args)), ...);
+			if (!m_Queue.TryEnqueue(event))
+				m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		const std::string &GetPath() const { return m_Path; }
+		uint64_t GetDroppedCount() const { return m_DroppedCount.load(std::memory_order_relaxed); }
+
+	private:
+		struct Event {
+			uint64_t timestamp;
+			Id id;
+			uint8_t size;
+			uint8_t args[MAX_ARGS_SIZE];
+		};
+
+		static uint64_t Now() {
+			return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+						std::chrono::steady_clock::now().time_since_epoch()).count());
+		}
+
+		void WriterMain();
+		bool Drain();
+		void Append(const void *data, std::size_t size);
+		template<typename T>
+		void Append(T value) { Append(&value, sizeof(T)); }
+		void Flush();
+
+	private:
+		std::string m_Path;
+		int m_Fd;
+		MPSCRingBuffer<Event, QUEUE_SIZE> m_Queue;
+		std::atomic<uint64_t> m_DroppedCount;
+
+		std::thread m_Thread;
+		std::mutex m_Mutex;
+		std::condition_variable m_Wake;
+		std::atomic<bool> m_Stopping;
+
+		// Writer thread only
+		std::vector<uint8_t> m_Buffer;
+		std::size_t m_DefinedCount;
+		uint64_t m_Timestamp;
+		uint64_t m_ReportedDropped;
+		Event m_Event;
+	};
+
+	struct EventLogEntry {
+		enum class Kind {
+			EVENT = 0,
+			DROPPED,
+		};
+
+		Kind kind;
+		uint64_t timestamp;     // CLOCK_MONOTONIC of the writer, nanoseconds
+		EventLog::Id id;
+		uint64_t droppedCount;  // DROPPED entries only
+		std::string text;
+	};
+
+	/*
+	 * Reads an event log back, formatting each event with the format it
+	 * was defined with. A log cut short by a crash reads up to its last
+	 * complete record.
+	 */
+	class EventLogReader {
+	public:
+		// Throws core::FileError if the file can't be read or has no valid
+		// header
+		explicit EventLogReader(const std::string &path);
+
+		// False at the end of the log. Throws core::FileError on an event of
+		// an undefined format.
+		bool Next(EventLogEntry &entry);
+
+		const EventLogHeader &GetHeader() const { return m_Header; }
+		bool IsTruncated() const { return m_Truncated; }
+		std::size_t GetFormatCount() const { return m_Formats.size(); }
+
+	private:
+		struct Format {
+			std::string format;
+			std::vector<EventArgType> args;
+			std::size_t argsSize;
+		};
+
+		bool Read(void *data, std::size_t size);
+		template<typename T>
+		bool Read(T &value) { return Read(&value, sizeof(T)); }
+
+	private:
+		std::string m_Path;
+		std::ifstream m_File;
+		EventLogHeader m_Header;
+		std::vector<Format> m_Formats;
+		uint64_t m_Timestamp;
+		bool m_Truncated;
+	};
+}
+
+#endif
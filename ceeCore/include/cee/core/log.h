@@ -19,28 +19,111 @@
 #ifndef CEE_CORE_LOG_H_
 #define CEE_CORE_LOG_H_
 
+#include <cee/core/config.h>
+
 #include <spdlog/spdlog.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
+/*
+ * Logging calls below CEE_LOG_ACTIVE_LEVEL, set when ceeCore is
+ * configured, compile to nothing and their arguments are not evaluated.
+ * Anything at or above it is still filtered by the logger's level at run
+ * time.
+ */
+#if CEE_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define CEE_LOG_TRACE(logger, ...)    (logger)->trace(__VA_ARGS__)
+#else
+#define CEE_LOG_TRACE(logger, ...)    (void)0
+#endif
+#if CEE_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define CEE_LOG_DEBUG(logger, ...)    (logger)->debug(__VA_ARGS__)
+#else
+#define CEE_LOG_DEBUG(logger, ...)    (void)0
+#endif
+#if CEE_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define CEE_LOG_INFO(logger, ...)     (logger)->info(__VA_ARGS__)
+#else
+#define CEE_LOG_INFO(logger, ...)     (void)0
+#endif
+#if CEE_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define CEE_LOG_WARN(logger, ...)     (logger)->warn(__VA_ARGS__)
+#else
+#define CEE_LOG_WARN(logger, ...)     (void)0
+#endif
+#if CEE_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define CEE_LOG_ERROR(logger, ...)    (logger)->error(__VA_ARGS__)
+#else
+#define CEE_LOG_ERROR(logger, ...)    (void)0
+#endif
+#if CEE_LOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
+#define CEE_LOG_CRITICAL(logger, ...) (logger)->critical(__VA_ARGS__)
+#else
+#define CEE_LOG_CRITICAL(logger, ...) (void)0
+#endif
+
 namespace cee {
 	using Logger = std::shared_ptr<spdlog::logger>;
 
+	class AsyncLogSink;
+
+	enum class LogMode {
+		// Messages are written to the console and file by the thread that
+		// logs them
+		SYNC,
+		// Messages are queued for a writer thread, and dropped when the
+		// queue is full
+		ASYNC_DROP,
+		// As ASYNC_DROP, but logging waits for room in the queue, spinning
+		// briefly and then sleeping until the writer thread catches up
+		ASYNC_BLOCK,
+	};
+
+	/*
+	 * Console and file logging. In the asynchronous modes a message is
+	 * formatted by the thread that logs it, copied into a lock-free queue,
+	 * and written out by a background thread, so logging never waits on I/O
+	 * or a lock. Messages longer than MESSAGE_SIZE are cut short on the way
+	 * through the queue.
+	 *
+	 * logFile may be a file or a directory to put <name>.log in, and
+	 * defaults to $HOME/.local/share/cee/<name>.log.
+	 */
 	class Log {
+	public:
+		// Messages the queue holds in the asynchronous modes
+		static constexpr std::size_t QUEUE_SIZE = 1024;
+		// Longest message that is queued whole, in bytes
+		static constexpr std::size_t MESSAGE_SIZE = 200;
+
 	public:
 		Log(const std::string &name,
 				const std::string &logFile,
-				spdlog::level::level_enum level = spdlog::level::info);
+				spdlog::level::level_enum level = spdlog::level::info,
+				LogMode mode = LogMode::SYNC);
+		// Writes out what is still queued
+		~Log();
+
+		Log(const Log &) = delete;
+		Log &operator=(const Log &) = delete;
 
 		Logger CreateChild(const std::string &name);
 
 		Logger &GetLogger() { return m_CoreLogger; }
-		
+
+		LogMode GetMode() const { return m_Mode; }
+		// Messages lost to a full queue, only ever non-zero in ASYNC_DROP
+		uint64_t GetDroppedCount() const;
+
 	private:
 		std::string m_LogFile;
 		spdlog::level::level_enum m_LogLevel;
+		LogMode m_Mode;
 		std::vector<spdlog::sink_ptr> m_Sinks;
+		std::shared_ptr<AsyncLogSink> m_AsyncSink;
 		Logger m_CoreLogger;
 		std::vector<std::weak_ptr<spdlog::logger>> m_Children;
 	};
@@ -16,9 +16,16 @@
  * with this program. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#ifndef CEE_CORE_RINGBUFFER_H_
+#define CEE_CORE_RINGBUFFER_H_
+
 #include <cee/core/except.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <span>
+#include <utility>
 
 namespace cee {
 	template<typename T, std::size_t N>
@@ -41,6 +48,7 @@ namespace cee {
 			m_ReadOffset = other.m_ReadOffset;
 			m_WriteOffset = other.m_WriteOffset;
 			m_Size = other.m_Size;
+			return *this;
 		}
 
 		RingBuffer &operator=(RingBuffer &&other) {
@@ -48,6 +56,7 @@ namespace cee {
 			m_ReadOffset = other.m_ReadOffset;
 			m_WriteOffset = other.m_WriteOffset;
 			m_Size = other.m_Size;
+			return *this;
 		}
 
 		bool Empty() const { return m_Size == 0; }
@@ -107,5 +116,242 @@ namespace cee {
 		std::size_t m_WriteOffset;
 		std::size_t m_Size;
 	};
+
+	/*
+	 * Destructive interference size used to keep the producer and consumer
+	 * indices of the concurrent ring buffers on separate cache lines.
+	 * std::hardware_destructive_interference_size is not used as its value
+	 * is allowed to change between compiler flags, which would change the
+	 * layout of these types across translation units.
+	 */
+	constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+	/*
+	 * Lock-free single producer, single consumer ring buffer. Exactly one
+	 * thread may enqueue and exactly one (other) thread may dequeue. None of
+	 * the operations block or throw; a full or empty buffer is reported
+	 * through the return value. N must be a power of two.
+	 */
+	template<typename T, std::size_t N>
+	class SPSCRingBuffer {
+		static_assert(N > 0 && (N & (N - 1)) == 0, "SPSCRingBuffer size must be a power of two");
+		static constexpr std::size_t MASK = N - 1;
+
+	public:
+		SPSCRingBuffer()
+		 : m_WriteOffset(0), m_CachedReadOffset(0), m_ReadOffset(0), m_CachedWriteOffset(0) {
+		}
+
+		SPSCRingBuffer(const SPSCRingBuffer &) = delete;
+		SPSCRingBuffer &operator=(const SPSCRingBuffer &) = delete;
+
+		bool Empty() const { return Size() == 0; }
+		bool Full() const { return Size() == N; }
+		std::size_t Size() const {
+			std::size_t read = m_ReadOffset.load(std::memory_order_acquire);
+			return m_WriteOffset.load(std::memory_order_acquire) - read;
+		}
+		static constexpr std::size_t Capacity() { return N; }
+
+		bool TryEnqueue(const T &val) {
+			std::size_t write = m_WriteOffset.load(std::memory_order_relaxed);
+			if (ProducerSpace(write, 1) == 0)
+				return false;
+			m_Buffer[write & MASK] = val;
+			m_WriteOffset.store(write + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool TryEnqueue(T &&val) {
+			std::size_t write = m_WriteOffset.load(std::memory_order_relaxed);
+			if (ProducerSpace(write, 1) == 0)
+				return false;
+			m_Buffer[write & MASK] = std::move(val);
+			m_WriteOffset.store(write + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool TryDequeue(T &val) {
+			std::size_t read = m_ReadOffset.load(std::memory_order_relaxed);
+			if (ConsumerAvailable(read, 1) == 0)
+				return false;
+			val = std::move(m_Buffer[read & MASK]);
+			m_ReadOffset.store(read + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Enqueues as many elements from the front of vals as fit and returns
+		// how many were enqueued. The elements are published all at once.
+		std::size_t EnqueueSpan(std::span<const T> vals) {
+			std::size_t write = m_WriteOffset.load(std::memory_order_relaxed);
+			std::size_t count = std::min(vals.size(), ProducerSpace(write, vals.size()));
+			if (count == 0)
+				return 0;
+			std::size_t first = std::min(count, N - (write & MASK));
+			std::copy_n(vals.begin(), first, m_Buffer.begin() + (write & MASK));
+			std::copy_n(vals.begin() + first, count - first, m_Buffer.begin());
+			m_WriteOffset.store(write + count, std::memory_order_release);
+			return count;
+		}
+
+		// Dequeues up to out.size() elements into out and returns how many
+		// were dequeued.
+		std::size_t DequeueSpan(std::span<T> out) {
+			std::size_t read = m_ReadOffset.load(std::memory_order_relaxed);
+			std::size_t count = std::min(out.size(), ConsumerAvailable(read, out.size()));
+			if (count == 0)
+				return 0;
+			std::size_t first = std::min(count, N - (read & MASK));
+			std::move(m_Buffer.begin() + (read & MASK), m_Buffer.begin() + (read & MASK) + first, out.begin());
+			std::move(m_Buffer.begin(), m_Buffer.begin() + (count - first), out.begin() + first);
+			m_ReadOffset.store(read + count, std::memory_order_release);
+			return count;
+		}
+
+	private:
+		// Producer side. The consumer's offset is only reloaded when the
+		// cached copy says there is not enough space, keeping the consumer's
+		// cache line out of the producer's fast path.
+		std::size_t ProducerSpace(std::size_t write, std::size_t wanted) {
+			std::size_t space = N - (write - m_CachedReadOffset);
+			if (space < wanted) {
+				m_CachedReadOffset = m_ReadOffset.load(std::memory_order_acquire);
+				space = N - (write - m_CachedReadOffset);
+			}
+			return space;
+		}
+
+		// Consumer side, mirrors ProducerSpace().
+		std::size_t ConsumerAvailable(std::size_t read, std::size_t wanted) {
+			std::size_t available = m_CachedWriteOffset - read;
+			if (available < wanted) {
+				m_CachedWriteOffset = m_WriteOffset.load(std::memory_order_acquire);
+				available = m_CachedWriteOffset - read;
+			}
+			return available;
+		}
+
+	private:
+		alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_WriteOffset;
+		std::size_t m_CachedReadOffset;
+		alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_ReadOffset;
+		std::size_t m_CachedWriteOffset;
+		alignas(CACHE_LINE_SIZE) std::array<T, N> m_Buffer;
+	};
+
+	/*
+	 * Lock-free multiple producer, single consumer ring buffer. Any number
+	 * of threads may enqueue concurrently, exactly one thread may dequeue.
+	 * Producers reserve a range of slots with a single CAS and publish each
+	 * slot through its sequence number, so the consumer never observes a
+	 * partially written element. N must be a power of two.
+	 */
+	template<typename T, std::size_t N>
+	class MPSCRingBuffer {
+		static_assert(N > 0 && (N & (N - 1)) == 0, "MPSCRingBuffer size must be a power of two");
+		static constexpr std::size_t MASK = N - 1;
+
+		struct Slot {
+			std::atomic<std::size_t> sequence{ 0 };
+			T value;
+		};
+
+	public:
+		MPSCRingBuffer()
+		 : m_WriteOffset(0), m_ReadOffset(0) {
+		}
+
+		MPSCRingBuffer(const MPSCRingBuffer &) = delete;
+		MPSCRingBuffer &operator=(const MPSCRingBuffer &) = delete;
+
+		bool Empty() const { return Size() == 0; }
+		bool Full() const { return Size() >= N; }
+		std::size_t Size() const {
+			std::size_t read = m_ReadOffset.load(std::memory_order_acquire);
+			return m_WriteOffset.load(std::memory_order_acquire) - read;
+		}
+		static constexpr std::size_t Capacity() { return N; }
+
+		bool TryEnqueue(const T &val) {
+			std::size_t write;
+			if (Reserve(1, write) == 0)
+				return false;
+			Slot &slot = m_Slots[write & MASK];
+			slot.value = val;
+			slot.sequence.store(write + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool TryEnqueue(T &&val) {
+			std::size_t write;
+			if (Reserve(1, write) == 0)
+				return false;
+			Slot &slot = m_Slots[write & MASK];
+			slot.value = std::move(val);
+			slot.sequence.store(write + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Enqueues as many elements from the front of vals as fit and returns
+		// how many were enqueued. The enqueued elements are contiguous in the
+		// buffer, elements from other producers will not be interleaved.
+		std::size_t EnqueueSpan(std::span<const T> vals) {
+			std::size_t write;
+			std::size_t count = Reserve(vals.size(), write);
+			for (std::size_t i = 0; i < count; ++i) {
+				Slot &slot = m_Slots[(write + i) & MASK];
+				slot.value = vals[i];
+				slot.sequence.store(write + i + 1, std::memory_order_release);
+			}
+			return count;
+		}
+
+		bool TryDequeue(T &val) {
+			std::size_t read = m_ReadOffset.load(std::memory_order_relaxed);
+			Slot &slot = m_Slots[read & MASK];
+			if (slot.sequence.load(std::memory_order_acquire) != read + 1)
+				return false;
+			val = std::move(slot.value);
+			m_ReadOffset.store(read + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Dequeues up to out.size() published elements into out and returns
+		// how many were dequeued. Stops early at the first slot a producer
+		// has reserved but not yet published.
+		std::size_t DequeueSpan(std::span<T> out) {
+			std::size_t read = m_ReadOffset.load(std::memory_order_relaxed);
+			std::size_t count = 0;
+			for (; count < out.size(); ++count) {
+				Slot &slot = m_Slots[(read + count) & MASK];
+				if (slot.sequence.load(std::memory_order_acquire) != read + count + 1)
+					break;
+				out[count] = std::move(slot.value);
+			}
+			if (count)
+				m_ReadOffset.store(read + count, std::memory_order_release);
+			return count;
+		}
+
+	private:
+		std::size_t Reserve(std::size_t count, std::size_t &write) {
+			write = m_WriteOffset.load(std::memory_order_relaxed);
+			std::size_t reserved;
+			do {
+				std::size_t read = m_ReadOffset.load(std::memory_order_acquire);
+				reserved = std::min(count, N - (write - read));
+				if (reserved == 0)
+					return 0;
+			} while (!m_WriteOffset.compare_exchange_weak(write, write + reserved,
+						std::memory_order_relaxed, std::memory_order_relaxed));
+			return reserved;
+		}
+
+	private:
+		alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_WriteOffset;
+		alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> m_ReadOffset;
+		alignas(CACHE_LINE_SIZE) std::array<Slot, N> m_Slots;
+	};
 }
 
+#endif
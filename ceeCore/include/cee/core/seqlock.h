@@ -0,0 +1,94 @@
+/*
+ * ceeCore
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_CORE_SEQLOCK_H_
+#define CEE_CORE_SEQLOCK_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace cee {
+	/*
+	 * Single writer, multiple reader publication of a small value. The
+	 * writer never waits, readers retry while a store is in progress and
+	 * always see a value from a single Store(). The value is kept in atomic
+	 * words so concurrent access is not a data race.
+	 */
+	template<typename T>
+	class SeqLock {
+		static_assert(std::is_trivially_copyable_v<T>, "SeqLock values must be trivially copyable");
+		static constexpr std::size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+	public:
+		SeqLock() : SeqLock(T{}) {}
+
+		explicit SeqLock(const T &value) : m_Sequence(0) {
+			std::array<uint64_t, WORDS> words{};
+			std::memcpy(words.data(), &value, sizeof(T));
+			for (std::size_t i = 0; i < WORDS; ++i)
+				m_Words[i].store(words[i], std::memory_order_relaxed);
+		}
+
+		SeqLock(const SeqLock &) = delete;
+		SeqLock &operator=(const SeqLock &) = delete;
+
+		// Only one thread may store
+		void Store(const T &value) {
+			std::array<uint64_t, WORDS> words{};
+			std::memcpy(words.data(), &value, sizeof(T));
+
+			uint64_t sequence = m_Sequence.load(std::memory_order_relaxed);
+			m_Sequence.store(sequence + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			for (std::size_t i = 0; i < WORDS; ++i)
+				m_Words[i].store(words[i], std::memory_order_relaxed);
+			m_Sequence.store(sequence + 2, std::memory_order_release);
+		}
+
+		T Load() const {
+			std::array<uint64_t, WORDS> words;
+			uint64_t before, after;
+			do {
+				before = m_Sequence.load(std::memory_order_acquire);
+				for (std::size_t i = 0; i < WORDS; ++i)
+					words[i] = m_Words[i].load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				after = m_Sequence.load(std::memory_order_relaxed);
+			} while ((before & 1) != 0 || before != after);
+
+			T value;
+			std::memcpy(static_cast<void *>(&value), words.data(), sizeof(T));
+			return value;
+		}
+
+		// Number of stores so far, readers can compare it to skip work
+		// when nothing changed
+		uint64_t GetVersion() const {
+			return m_Sequence.load(std::memory_order_acquire) / 2;
+		}
+
+	private:
+		std::atomic<uint64_t> m_Sequence;
+		std::array<std::atomic<uint64_t>, WORDS> m_Words;
+	};
+}
+
+#endif
@@ -0,0 +1,100 @@
+/*
+ * ceeCore
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_CORE_THREAD_POOL_H_
+#define CEE_CORE_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cee {
+	/*
+	 * Fixed set of worker threads for batch work, each with its own deque
+	 * of tasks. A worker runs its newest task first, while its caches are
+	 * warm with what queued it, and once it runs dry steals the oldest
+	 * task of another worker, which tends to be the largest piece of work
+	 * left. Tasks submitted from a worker go on that worker's deque, so a
+	 * task can split itself up and let idle workers take the pieces.
+	 *
+	 * Deques are short lived and only locked to push or take a task, so a
+	 * mutex each keeps contention low enough for tasks of milliseconds and
+	 * up. Not meant for the acquisition or render threads.
+	 */
+	class ThreadPool {
+	public:
+		using Task = std::function<void()>;
+
+	public:
+		// One worker per hardware thread when threadCount is 0
+		explicit ThreadPool(std::size_t threadCount = 0);
+		// Runs what is still queued, then joins the workers
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool &) = delete;
+		ThreadPool &operator=(const ThreadPool &) = delete;
+
+		// Any thread, tasks included
+		void Submit(Task task);
+		// Blocks until every task submitted so far, and every task those
+		// submitted, has run. Rethrows the first exception a task threw.
+		// Must not be called from a task.
+		void Wait();
+
+		std::size_t GetThreadCount() const { return m_Workers.size(); }
+		// Tasks a worker took from another's deque
+		uint64_t GetStolenCount() const { return m_StolenCount.load(std::memory_order_relaxed); }
+
+	private:
+		struct Worker {
+			std::mutex mutex;
+			std::deque<Task> tasks;
+			std::thread thread;
+		};
+
+		void WorkerMain(std::size_t index);
+		bool TryTake(std::size_t index, Task &task);
+		void Run(Task &task);
+
+	private:
+		std::vector<std::unique_ptr<Worker>> m_Workers;
+		// Deque the next task from outside the pool goes to
+		std::atomic<std::size_t> m_Next;
+		// Tasks sitting in a deque
+		std::atomic<std::size_t> m_Queued;
+		std::atomic<uint64_t> m_StolenCount;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_WorkAvailable;
+		std::condition_variable m_Finished;
+		// Submitted and not yet finished, under m_Mutex
+		std::size_t m_Pending;
+		bool m_Stopping;
+		std::exception_ptr m_Error;
+	};
+}
+
+#endif
@@ -18,53 +18,276 @@
 
 #include <cee/core/log.h>
 #include <cee/core/except.h>
+#include <cee/core/ringbuffer.h>
 
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/sinks/basic_file_sink.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iterator>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 namespace cee {
+	/*
+	 * A message as it crosses the queue, copied out of the log_msg whose
+	 * strings only live as long as the logging call.
+	 */
+	struct LogRecord {
+		static constexpr std::size_t NAME_SIZE = 24;
 
-	Log::Log(const std::string &name, const std::string &logFile, spdlog::level::level_enum level)
-	 : m_LogLevel(level) {
+		spdlog::log_clock::time_point time;
+		spdlog::source_loc source;
+		std::size_t threadId;
+		spdlog::level::level_enum level;
+		uint8_t nameLength;
+		uint8_t messageLength;
+		char name[NAME_SIZE];
+		char message[Log::MESSAGE_SIZE];
+	};
+	static_assert(Log::MESSAGE_SIZE <= 255, "Message lengths are a byte");
+
+	/*
+	 * Sink the loggers write to in the asynchronous modes. log() never
+	 * locks or does I/O, it only copies the formatted message into the
+	 * queue. A writer thread drains the queue into the console and file
+	 * sinks, waking every POLL_INTERVAL or when asked to flush, and logs a
+	 * warning with the count whenever messages were dropped.
+	 *
+	 * Once stopped, messages are written straight to the sinks by the
+	 * thread that logs them.
+	 */
+	class AsyncLogSink final : public spdlog::sinks::sink {
+	public:
+		static constexpr std::chrono::milliseconds POLL_INTERVAL{ 10 };
+		// ASYNC_BLOCK retries on a full queue with a yield this many times,
+		// then sleeps BLOCK_SLEEP between retries
+		static constexpr int BLOCK_SPINS = 64;
+		static constexpr std::chrono::microseconds BLOCK_SLEEP{ 100 };
+
+	public:
+		AsyncLogSink(std::vector<spdlog::sink_ptr> sinks, bool block)
+		 : m_Sinks(std::move(sinks)), m_Block(block), m_Stopping(false), m_FlushRequested(false),
+			m_InFlight(0), m_DroppedCount(0), m_ReportedDropped(0) {
+			m_Thread = std::thread(&AsyncLogSink::WriterMain, this);
+		}
+
+		~AsyncLogSink() override {
+			Stop();
+		}
+
+		void log(const spdlog::details::log_msg &msg) override {
+			// Counted before checking m_Stopping, so Stop() either sees this
+			// call in flight and waits for it, or this call sees the sink
+			// stopping and writes directly. Both are sequentially consistent.
+			m_InFlight.fetch_add(1);
+			if (m_Stopping.load())
+				Write(msg);
+			else
+				Enqueue(msg);
+			m_InFlight.fetch_sub(1, std::memory_order_release);
+		}
+
+		void flush() override {
+			if (m_Stopping.load(std::memory_order_acquire)) {
+				for (spdlog::sink_ptr &sink : m_Sinks)
+					sink->flush();
+				return;
+			}
+			m_FlushRequested.store(true, std::memory_order_release);
+			m_Wake.notify_one();
+		}
+
+		void set_pattern(const std::string &pattern) override {
+			for (spdlog::sink_ptr &sink : m_Sinks)
+				sink->set_pattern(pattern);
+		}
+
+		void set_formatter(std::unique_ptr<spdlog::formatter> formatter) override {
+			for (spdlog::sink_ptr &sink : m_Sinks)
+				sink->set_formatter(formatter->clone());
+		}
+
+		// Writes out what is queued and joins the writer thread
+		void Stop() {
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				m_Stopping.store(true);
+			}
+			m_Wake.notify_one();
+			if (!m_Thread.joinable())
+				return;
+			m_Thread.join();
+			// Anything queued by a thread that saw the sink still running,
+			// once every such call has returned
+			while (m_InFlight.load(std::memory_order_acquire) != 0)
+				std::this_thread::yield();
+			Drain();
+			for (spdlog::sink_ptr &sink : m_Sinks)
+				sink->flush();
+		}
+
+		uint64_t GetDroppedCount() const { return m_DroppedCount.load(std::memory_order_relaxed); }
+
+	private:
+		void Enqueue(const spdlog::details::log_msg &msg) {
+			LogRecord record;
+			record.time = msg.time;
+			record.source = msg.source;
+			record.threadId = msg.thread_id;
+			record.level = msg.level;
+			record.nameLength = static_cast<uint8_t>(std::min(msg.logger_name.size(), LogRecord::NAME_SIZE));
+			std::memcpy(record.name, msg.logger_name.data(), record.nameLength);
+			record.messageLength = static_cast<uint8_t>(std::min(msg.payload.size(), Log::MESSAGE_SIZE));
+			std::memcpy(record.message, msg.payload.data(), record.messageLength);
+			if (msg.payload.size() > Log::MESSAGE_SIZE)
+				std::memcpy(record.message + Log::MESSAGE_SIZE - 3, "...", 3);
+
+			if (m_Queue.TryEnqueue(record))
+				return;
+			if (!m_Block) {
+				m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			// Waits for as long as the writer takes to make room, which is
+			// bounded by the sinks' I/O. A few yields cover the writer
+			// being mid drain, after that the wait backs off to sleeps so
+			// blocked threads don't compete with the writer for a core.
+			m_Wake.notify_one();
+			for (int attempt = 0; !m_Queue.TryEnqueue(record); ++attempt) {
+				if (m_Stopping.load()) {
+					Write(msg);
+					return;
+				}
+				if (attempt < BLOCK_SPINS) {
+					std::this_thread::yield();
+				} else {
+					m_Wake.notify_one();
+					std::this_thread::sleep_for(BLOCK_SLEEP);
+				}
+			}
+		}
+
+		void WriterMain() {
+			for (;;) {
+				bool stopping = m_Stopping.load(std::memory_order_acquire);
+				bool wrote = Drain();
+				if (m_FlushRequested.exchange(false, std::memory_order_acq_rel) || stopping) {
+					for (spdlog::sink_ptr &sink : m_Sinks)
+						sink->flush();
+				}
+				if (stopping)
+					return;
+				if (wrote)
+					continue;
+
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Wake.wait_for(lock, POLL_INTERVAL, [this] {
+					return m_Stopping.load(std::memory_order_acquire) || m_FlushRequested.load(std::memory_order_acquire);
+				});
+			}
+		}
+
+		bool Drain() {
+			bool wrote = false;
+			while (m_Queue.TryDequeue(m_Record)) {
+				spdlog::details::log_msg msg(m_Record.time, m_Record.source,
+						spdlog::string_view_t(m_Record.name, m_Record.nameLength), m_Record.level,
+						spdlog::string_view_t(m_Record.message, m_Record.messageLength));
+				msg.thread_id = m_Record.threadId;
+				Write(msg);
+				wrote = true;
+			}
+
+			uint64_t dropped = m_DroppedCount.load(std::memory_order_relaxed);
+			if (dropped != m_ReportedDropped) {
+				std::string text = fmt::format("{} log messages dropped, the queue was full", dropped - m_ReportedDropped);
+				m_ReportedDropped = dropped;
+				Write(spdlog::details::log_msg("log", spdlog::level::warn, text));
+			}
+			return wrote;
+		}
+
+		void Write(const spdlog::details::log_msg &msg) {
+			for (spdlog::sink_ptr &sink : m_Sinks) {
+				if (sink->should_log(msg.level))
+					sink->log(msg);
+			}
+		}
+
+	private:
+		std::vector<spdlog::sink_ptr> m_Sinks;
+		const bool m_Block;
+		MPSCRingBuffer<LogRecord, Log::QUEUE_SIZE> m_Queue;
+
+		std::thread m_Thread;
+		std::mutex m_Mutex;
+		std::condition_variable m_Wake;
+		std::atomic<bool> m_Stopping;
+		std::atomic<bool> m_FlushRequested;
+		// log() calls between their m_Stopping check and returning
+		std::atomic<uint32_t> m_InFlight;
+		std::atomic<uint64_t> m_DroppedCount;
+		// Writer thread only
+		uint64_t m_ReportedDropped;
+		LogRecord m_Record;
+	};
+
+	static std::filesystem::path LogFilePath(const std::string &name, const std::string &logFile) {
 		std::filesystem::path path;
-		if (!m_LogFile.empty()) {
-			path = std::filesystem::absolute(m_LogFile);
-			std::fstream file(path, std::ios::out);
-			if (!file)
-				throw core::FileError(fmt::format("Cannot open file {}", path.string()));
+		if (!logFile.empty()) {
+			path = std::filesystem::absolute(logFile);
+			if (std::filesystem::is_directory(path))
+				path /= name + ".log";
+		} else if (const char *home = std::getenv("HOME")) {
+			path = std::filesystem::absolute(std::filesystem::path(home) / (".local/share/cee/" + name + ".log"));
 		} else {
-			const char *home = std::getenv("HOME");
-			if (home) {
-				path = std::filesystem::absolute(std::filesystem::path(home) / (".local/share/cee/" + name + ".log"));
-				std::fstream file(path, std::ios::out);
-				if (!file)
-					throw core::FileError(fmt::format("Cannot open file {}", path.string()));
-			} else { 
-				path = std::filesystem::absolute("/tmp/" + name + ".log");
-				std::fstream file(path, std::ios::out);
-				if (!file)
-					throw core::FileError(fmt::format("Cannot open file {}", path.string()));
-				}
+			path = std::filesystem::absolute("/tmp/" + name + ".log");
+		}
+		std::fstream file(path, std::ios::out);
+		if (!file)
+			throw core::FileError(fmt::format("Cannot open file {}", path.string()));
+		return path;
+	}
+
+	Log::Log(const std::string &name, const std::string &logFile, spdlog::level::level_enum level, LogMode mode)
+	 : m_LogFile(LogFilePath(name, logFile).string()), m_LogLevel(level), m_Mode(mode) {
+		std::vector<spdlog::sink_ptr> outputs;
+		outputs.emplace_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+		outputs.emplace_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>(m_LogFile, true));
+		outputs[0]->set_pattern("[%T] [%l] %^%n: %v%$");
+		outputs[1]->set_pattern("[%T] [%l] %n: %v");
+
+		if (m_Mode == LogMode::SYNC) {
+			m_Sinks = std::move(outputs);
+		} else {
+			m_AsyncSink = std::make_shared<AsyncLogSink>(std::move(outputs), m_Mode == LogMode::ASYNC_BLOCK);
+			m_Sinks.push_back(m_AsyncSink);
 		}
-		m_LogFile = path;
-		m_Sinks.emplace_back(std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
-		m_Sinks.emplace_back(std::make_shared<spdlog::sinks::basic_file_sink_mt>(m_LogFile, true));
-		m_Sinks[0]->set_pattern("[%T] [%l] %^%n: %v%$");
-		m_Sinks[1]->set_pattern("[%T] [%l] %n: %v");
 
 		m_CoreLogger = std::make_shared<spdlog::logger>(name, begin(m_Sinks), end(m_Sinks));
 		spdlog::register_logger(m_CoreLogger);
 		m_CoreLogger->set_level(m_LogLevel);
-		
+
 		m_CoreLogger->info("Writing to log file: {}", m_LogFile);
 	}
 
+	Log::~Log() {
+		// The loggers may outlive this in spdlog's registry, from here on
+		// they write synchronously
+		if (m_AsyncSink)
+			m_AsyncSink->Stop();
+	}
+
 	Logger Log::CreateChild(const std::string &name) {
 		m_CoreLogger->trace("Creating new logger {}", name);
 
@@ -75,5 +298,8 @@ namespace cee {
 
 		return logger;
 	}
-}
 
+	uint64_t Log::GetDroppedCount() const {
+		return m_AsyncSink ? m_AsyncSink->GetDroppedCount() : 0;
+	}
+}
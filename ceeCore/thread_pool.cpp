@@ -0,0 +1,138 @@
+/*
+ * ceeCore
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/core/thread_pool.h>
+
+#include <algorithm>
+
+namespace cee {
+	// Pool and deque of the worker running on this thread, if any
+	static thread_local ThreadPool *t_Pool = nullptr;
+	static thread_local std::size_t t_Worker = 0;
+
+	ThreadPool::ThreadPool(std::size_t threadCount)
+	 : m_Next(0), m_Queued(0), m_StolenCount(0), m_Pending(0), m_Stopping(false) {
+		if (threadCount == 0)
+			threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+		for (std::size_t i = 0; i < threadCount; ++i)
+			m_Workers.push_back(std::make_unique<Worker>());
+		for (std::size_t i = 0; i < threadCount; ++i)
+			m_Workers[i]->thread = std::thread(&ThreadPool::WorkerMain, this, i);
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::unique_lock lock(m_Mutex);
+			m_Finished.wait(lock, [this] { return m_Pending == 0; });
+			m_Stopping = true;
+		}
+		m_WorkAvailable.notify_all();
+		for (std::unique_ptr<Worker> &worker : m_Workers)
+			worker->thread.join();
+	}
+
+	void ThreadPool::Submit(Task task) {
+		{
+			std::lock_guard lock(m_Mutex);
+			++m_Pending;
+		}
+		std::size_t index = t_Pool == this ? t_Worker
+			: m_Next.fetch_add(1, std::memory_order_relaxed) % m_Workers.size();
+		{
+			Worker &worker = *m_Workers[index];
+			std::lock_guard lock(worker.mutex);
+			worker.tasks.push_back(std::move(task));
+		}
+		m_Queued.fetch_add(1, std::memory_order_release);
+		// Taking the lock orders this after a worker's check of m_Queued,
+		// so the notification can't fall between its check and its wait
+		{
+			std::lock_guard lock(m_Mutex);
+		}
+		m_WorkAvailable.notify_one();
+	}
+
+	void ThreadPool::Wait() {
+		std::unique_lock lock(m_Mutex);
+		m_Finished.wait(lock, [this] { return m_Pending == 0; });
+		if (m_Error) {
+			std::exception_ptr error = m_Error;
+			m_Error = nullptr;
+			std::rethrow_exception(error);
+		}
+	}
+
+	void ThreadPool::WorkerMain(std::size_t index) {
+		t_Pool = this;
+		t_Worker = index;
+		Task task;
+		for (;;) {
+			if (TryTake(index, task)) {
+				Run(task);
+				continue;
+			}
+			std::unique_lock lock(m_Mutex);
+			m_WorkAvailable.wait(lock, [this] {
+				return m_Stopping || m_Queued.load(std::memory_order_acquire) > 0;
+			});
+			if (m_Stopping && m_Queued.load(std::memory_order_acquire) == 0)
+				return;
+		}
+	}
+
+	bool ThreadPool::TryTake(std::size_t index, Task &task) {
+		{
+			Worker &own = *m_Workers[index];
+			std::lock_guard lock(own.mutex);
+			if (!own.tasks.empty()) {
+				task = std::move(own.tasks.back());
+				own.tasks.pop_back();
+				m_Queued.fetch_sub(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		for (std::size_t i = 1; i < m_Workers.size(); ++i) {
+			Worker &victim = *m_Workers[(index + i) % m_Workers.size()];
+			std::lock_guard lock(victim.mutex);
+			if (!victim.tasks.empty()) {
+				task = std::move(victim.tasks.front());
+				victim.tasks.pop_front();
+				m_Queued.fetch_sub(1, std::memory_order_relaxed);
+				m_StolenCount.fetch_add(1, std::memory_order_relaxed);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void ThreadPool::Run(Task &task) {
+		std::exception_ptr error;
+		try {
+			task();
+		} catch (...) {
+			error = std::current_exception();
+		}
+		task = nullptr;
+
+		std::lock_guard lock(m_Mutex);
+		if (error && !m_Error)
+			m_Error = error;
+		if (--m_Pending == 0)
+			m_Finished.notify_all();
+	}
+}
@@ -0,0 +1,355 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_DSP_DECIMATE_H_
+#define CEE_DSP_DECIMATE_H_
+
+#include <cee/dsp/design.h>
+#include <cee/dsp/fixed.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+/*
+ * Decimators for oversampled channels. Averaging N samples of a signal
+ * with at least an LSB of noise on it gains 0.5 log2(N) bits of
+ * resolution. More generally a filter with unity DC gain passes white
+ * noise power scaled by the sum of its squared taps, so every decimator
+ * reports the bits it gains as half the log2 of the inverse of that sum.
+ */
+namespace cee {
+namespace dsp {
+	namespace detail {
+		inline double BitsGained(std::span<const double> taps) {
+			double sum = 0.0;
+			double squares = 0.0;
+			for (double h : taps) {
+				sum += h;
+				squares += h * h;
+			}
+			if (squares <= 0.0)
+				return 0.0;
+			return 0.5 * std::log2(sum * sum / squares);
+		}
+	}
+
+	/*
+	 * Cascaded integrator-comb decimator: Order integrators at the input
+	 * rate, then every Factor-th sample through Order combs at the output
+	 * rate, with the Factor^Order gain divided out. No multiplies, and of
+	 * order one it is the plain average of each Factor inputs.
+	 *
+	 * The registers are wrapping 64 bit integers, which the CIC tolerates
+	 * as long as the output fits. Fixed point samples are integrated as
+	 * their raw value, float ones as fixed point with FLOAT_FRAC_BITS
+	 * fractional bits.
+	 */
+	template<typename T, std::size_t Order = 3>
+	class CicDecimator {
+		static_assert(Order > 0 && Order <= 6, "CIC order must be 1 to 6");
+
+	public:
+		static constexpr std::size_t ORDER = Order;
+		static constexpr std::size_t MAX_FACTOR = 64;
+		static constexpr int FLOAT_FRAC_BITS = 24;
+
+	public:
+		explicit CicDecimator(std::size_t factor = 1) {
+			SetFactor(factor);
+		}
+
+		// Clamped to [1, MAX_FACTOR], resets the filter
+		void SetFactor(std::size_t factor) {
+			m_Factor = std::clamp<std::size_t>(factor, 1, MAX_FACTOR);
+			m_Gain = 1;
+			for (std::size_t i = 0; i < Order; ++i)
+				m_Gain *= static_cast<int64_t>(m_Factor);
+			m_GainShift = (m_Gain & (m_Gain - 1)) == 0 ? std::countr_zero(static_cast<uint64_t>(m_Gain)) : -1;
+
+			// Impulse response, Order boxcars of length Factor convolved
+			std::vector<double> impulse(1, 1.0);
+			for (std::size_t i = 0; i < Order; ++i) {
+				std::vector<double> next(impulse.size() + m_Factor - 1, 0.0);
+				for (std::size_t j = 0; j < impulse.size(); ++j)
+					for (std::size_t k = 0; k < m_Factor; ++k)
+						next[j + k] += impulse[j];
+				impulse = std::move(next);
+			}
+			m_BitsGained = detail::BitsGained(impulse);
+			Reset();
+		}
+
+		std::size_t Process(std::span<T> block) {
+			std::size_t out = 0;
+			for (T x : block) {
+				uint64_t v = static_cast<uint64_t>(ToInteger(x));
+				for (uint64_t &integrator : m_Integrators) {
+					integrator += v;
+					v = integrator;
+				}
+				if (++m_Count < m_Factor)
+					continue;
+				m_Count = 0;
+				for (uint64_t &comb : m_Combs) {
+					uint64_t previous = comb;
+					comb = v;
+					v -= previous;
+				}
+				block[out++] = FromInteger(Divide(static_cast<int64_t>(v)));
+			}
+			return out;
+		}
+
+		void Reset() {
+			m_Integrators.fill(0);
+			m_Combs.fill(0);
+			m_Count = 0;
+		}
+
+		std::size_t GetFactor() const { return m_Factor; }
+		double GetBitsGained() const { return m_BitsGained; }
+
+	private:
+		static int64_t ToInteger(T x) {
+			if constexpr (FixedPoint<T>)
+				return x.raw;
+			else
+				return std::llround(static_cast<double>(x) * static_cast<double>(int64_t(1) << FLOAT_FRAC_BITS));
+		}
+
+		static T FromInteger(int64_t v) {
+			if constexpr (FixedPoint<T>)
+				return T::Saturate(v);
+			else
+				return static_cast<T>(static_cast<double>(v) / static_cast<double>(int64_t(1) << FLOAT_FRAC_BITS));
+		}
+
+		int64_t Divide(int64_t v) const {
+			if (m_GainShift >= 0)
+				return detail::RoundShift(v, m_GainShift);
+			return (v + (v < 0 ? -m_Gain : m_Gain) / 2) / m_Gain;
+		}
+
+	private:
+		std::size_t m_Factor;
+		int64_t m_Gain;
+		// log2 of the gain when it is a power of two, -1 otherwise
+		int m_GainShift;
+		double m_BitsGained;
+
+		std::array<uint64_t, Order> m_Integrators;
+		std::array<uint64_t, Order> m_Combs;
+		std::size_t m_Count;
+	};
+
+	/*
+	 * FIR decimator that only computes the outputs it keeps, Taps multiply
+	 * adds per output and none for the Factor - 1 inputs in between, which
+	 * is the saving of the polyphase form. Each input is written twice into
+	 * a doubled history so the window is always contiguous.
+	 */
+	template<typename T, std::size_t Taps>
+	class FirDecimator {
+		static_assert(Taps > 0, "A filter needs at least one tap");
+		using Coefficient = std::conditional_t<FixedPoint<T>, int32_t, float>;
+
+	public:
+		static constexpr std::size_t TAP_COUNT = Taps;
+
+	public:
+		explicit FirDecimator(std::size_t factor = 1) {
+			std::array<float, Taps> taps{};
+			taps[0] = 1.f;
+			m_Factor = std::max<std::size_t>(factor, 1);
+			SetTaps(taps);
+		}
+
+		FirDecimator(std::size_t factor, const std::array<float, Taps> &taps) {
+			m_Factor = std::max<std::size_t>(factor, 1);
+			SetTaps(taps);
+		}
+
+		void SetFactor(std::size_t factor) {
+			m_Factor = std::max<std::size_t>(factor, 1);
+			Reset();
+		}
+
+		void SetTaps(const std::array<float, Taps> &taps) {
+			std::array<double, Taps> impulse;
+			for (std::size_t k = 0; k < Taps; ++k) {
+				impulse[k] = taps[k];
+				// Reversed, so the window runs oldest to newest
+				if constexpr (FixedPoint<T>)
+					m_Taps[Taps - 1 - k] = FixedCoefficient::FromFloat(taps[k]);
+				else
+					m_Taps[Taps - 1 - k] = taps[k];
+			}
+			m_BitsGained = detail::BitsGained(impulse);
+			Reset();
+		}
+
+		std::size_t Process(std::span<T> block) {
+			std::size_t out = 0;
+			for (T x : block) {
+				m_History[m_Pos] = x;
+				m_History[m_Pos + Taps] = x;
+				m_Pos = m_Pos + 1 == Taps ? 0 : m_Pos + 1;
+				if (++m_Count < m_Factor)
+					continue;
+				m_Count = 0;
+				block[out++] = Output(m_History.data() + m_Pos);
+			}
+			return out;
+		}
+
+		void Reset() {
+			m_History.fill(T{});
+			m_Pos = 0;
+			m_Count = 0;
+		}
+
+		std::size_t GetFactor() const { return m_Factor; }
+		double GetBitsGained() const { return m_BitsGained; }
+
+	private:
+		T Output(const T *window) const {
+			if constexpr (FixedPoint<T>) {
+				constexpr int shift = FixedCoefficient::FRAC_BITS - FixedCoefficient::PRODUCT_SHIFT<T>;
+				int64_t acc = int64_t(1) << (shift - 1);
+				for (std::size_t k = 0; k < Taps; ++k)
+					acc += FixedCoefficient::Multiply(m_Taps[k], window[k]);
+				return T::Saturate(acc >> shift);
+			} else {
+				T acc = T(0);
+				for (std::size_t k = 0; k < Taps; ++k)
+					acc += static_cast<T>(m_Taps[k]) * window[k];
+				return acc;
+			}
+		}
+
+	private:
+		std::size_t m_Factor;
+		double m_BitsGained;
+		std::array<Coefficient, Taps> m_Taps;
+		std::array<T, 2 * Taps> m_History;
+		std::size_t m_Pos;
+		std::size_t m_Count;
+	};
+
+	// Plain average of each Factor inputs
+	template<typename T>
+	using AverageDecimator = CicDecimator<T, 1>;
+
+	enum class DecimatorKind {
+		AVERAGE = 0,
+		CIC,
+		FIR,
+	};
+
+	/*
+	 * Decimation stage with the filter and factor picked at run time, for
+	 * channels oversampled by a configurable amount. Only the selected
+	 * filter is held. The FIR is a windowed sinc with its cutoff at 80% of
+	 * the output Nyquist frequency. A factor of one passes blocks through.
+	 */
+	template<typename T>
+	class Decimator {
+	public:
+		static constexpr std::size_t CIC_ORDER = 3;
+		static constexpr std::size_t FIR_TAPS = 127;
+		// Factors are clamped to [1, MAX_FACTOR]
+		static constexpr std::size_t MAX_FACTOR = CicDecimator<T, CIC_ORDER>::MAX_FACTOR;
+
+	public:
+		Decimator(DecimatorKind kind = DecimatorKind::AVERAGE, std::size_t factor = 1, float sampleRate = 1.f)
+		 : m_Kind(kind), m_Factor(std::clamp<std::size_t>(factor, 1, MAX_FACTOR)) {
+			if (m_Factor == 1)
+				return;
+			switch (m_Kind) {
+			case DecimatorKind::AVERAGE:
+				m_Filter.template emplace<AverageDecimator<T>>(m_Factor);
+				break;
+			case DecimatorKind::CIC:
+				m_Filter.template emplace<CicDecimator<T, CIC_ORDER>>(m_Factor);
+				break;
+			case DecimatorKind::FIR:
+				m_Filter.template emplace<FirDecimator<T, FIR_TAPS>>(m_Factor,
+						FirLowPass<FIR_TAPS>(sampleRate, 0.4 * sampleRate / static_cast<double>(m_Factor)));
+				break;
+			}
+		}
+
+		std::size_t Process(std::span<T> block) {
+			return std::visit([block](auto &filter) -> std::size_t {
+				if constexpr (std::is_same_v<std::decay_t<decltype(filter)>, std::monostate>)
+					return block.size();
+				else
+					return filter.Process(block);
+			}, m_Filter);
+		}
+
+		void Reset() {
+			std::visit([](auto &filter) {
+				if constexpr (!std::is_same_v<std::decay_t<decltype(filter)>, std::monostate>)
+					filter.Reset();
+			}, m_Filter);
+		}
+
+		DecimatorKind GetKind() const { return m_Kind; }
+		std::size_t GetFactor() const { return m_Factor; }
+
+		double GetBitsGained() const {
+			return std::visit([](const auto &filter) -> double {
+				if constexpr (std::is_same_v<std::decay_t<decltype(filter)>, std::monostate>)
+					return 0.0;
+				else
+					return filter.GetBitsGained();
+			}, m_Filter);
+		}
+
+		static constexpr const char *KindName(DecimatorKind kind) {
+			switch (kind) {
+			case DecimatorKind::AVERAGE:
+				return "average";
+			case DecimatorKind::CIC:
+				return "cic";
+			case DecimatorKind::FIR:
+				return "fir";
+			}
+			return "unknown";
+		}
+
+	private:
+		DecimatorKind m_Kind;
+		std::size_t m_Factor;
+		// Empty when passing through
+		std::variant<std::monostate, AverageDecimator<T>, CicDecimator<T, CIC_ORDER>,
+			FirDecimator<T, FIR_TAPS>> m_Filter;
+	};
+}
+}
+
+#endif
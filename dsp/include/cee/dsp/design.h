@@ -0,0 +1,192 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_DSP_DESIGN_H_
+#define CEE_DSP_DESIGN_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+/*
+ * Filter design, usable in constant expressions so the coefficients for a
+ * known sample rate can be baked in at compile time. Biquads follow the
+ * Audio EQ Cookbook (R. Bristow-Johnson), FIRs are Hamming windowed sincs.
+ * Designs that make no sense at the given sample rate (a cutoff at or
+ * above Nyquist) degrade to a pass-through instead of becoming unstable.
+ */
+namespace cee {
+namespace dsp {
+	namespace detail {
+		constexpr double PI = 3.14159265358979323846;
+
+		constexpr double Sin(double x) {
+			// Reduce to [-pi, pi], then to [-pi/2, pi/2] where the series
+			// converges quickly
+			while (x > PI)
+				x -= 2.0 * PI;
+			while (x < -PI)
+				x += 2.0 * PI;
+			if (x > PI / 2.0)
+				x = PI - x;
+			else if (x < -PI / 2.0)
+				x = -PI - x;
+			double term = x;
+			double sum = x;
+			for (int n = 1; n < 12; ++n) {
+				term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+				sum += term;
+			}
+			return sum;
+		}
+
+		constexpr double Cos(double x) {
+			return Sin(x + PI / 2.0);
+		}
+	}
+
+	// y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+	struct BiquadCoefficients {
+		float b0, b1, b2;
+		float a1, a2;
+
+		static constexpr BiquadCoefficients Identity() { return { 1.f, 0.f, 0.f, 0.f, 0.f }; }
+	};
+
+	constexpr double BUTTERWORTH_Q = 0.70710678118654752440;
+
+	namespace detail {
+		constexpr bool InRange(double sampleRate, double frequency) {
+			return sampleRate > 0.0 && frequency > 0.0 && frequency < sampleRate / 2.0;
+		}
+
+		constexpr BiquadCoefficients Normalize(double b0, double b1, double b2,
+				double a0, double a1, double a2) {
+			return {
+				static_cast<float>(b0 / a0), static_cast<float>(b1 / a0), static_cast<float>(b2 / a0),
+				static_cast<float>(a1 / a0), static_cast<float>(a2 / a0)
+			};
+		}
+	}
+
+	constexpr BiquadCoefficients LowPass(double sampleRate, double cutoff, double q = BUTTERWORTH_Q) {
+		if (!detail::InRange(sampleRate, cutoff))
+			return BiquadCoefficients::Identity();
+		double w = 2.0 * detail::PI * cutoff / sampleRate;
+		double cw = detail::Cos(w);
+		double alpha = detail::Sin(w) / (2.0 * q);
+		return detail::Normalize((1.0 - cw) / 2.0, 1.0 - cw, (1.0 - cw) / 2.0,
+				1.0 + alpha, -2.0 * cw, 1.0 - alpha);
+	}
+
+	constexpr BiquadCoefficients HighPass(double sampleRate, double cutoff, double q = BUTTERWORTH_Q) {
+		if (!detail::InRange(sampleRate, cutoff))
+			return BiquadCoefficients::Identity();
+		double w = 2.0 * detail::PI * cutoff / sampleRate;
+		double cw = detail::Cos(w);
+		double alpha = detail::Sin(w) / (2.0 * q);
+		return detail::Normalize((1.0 + cw) / 2.0, -(1.0 + cw), (1.0 + cw) / 2.0,
+				1.0 + alpha, -2.0 * cw, 1.0 - alpha);
+	}
+
+	// Unity gain at the centre frequency
+	constexpr BiquadCoefficients BandPass(double sampleRate, double centre, double q) {
+		if (!detail::InRange(sampleRate, centre))
+			return BiquadCoefficients::Identity();
+		double w = 2.0 * detail::PI * centre / sampleRate;
+		double alpha = detail::Sin(w) / (2.0 * q);
+		return detail::Normalize(alpha, 0.0, -alpha,
+				1.0 + alpha, -2.0 * detail::Cos(w), 1.0 - alpha);
+	}
+
+	constexpr BiquadCoefficients Notch(double sampleRate, double centre, double q = 30.0) {
+		if (!detail::InRange(sampleRate, centre))
+			return BiquadCoefficients::Identity();
+		double w = 2.0 * detail::PI * centre / sampleRate;
+		double cw = detail::Cos(w);
+		double alpha = detail::Sin(w) / (2.0 * q);
+		return detail::Normalize(1.0, -2.0 * cw, 1.0,
+				1.0 + alpha, -2.0 * cw, 1.0 - alpha);
+	}
+
+	namespace detail {
+		// Q of section k of an even order Butterworth filter
+		constexpr double ButterworthQ(std::size_t order, std::size_t k) {
+			return 1.0 / (2.0 * Cos(PI * (2.0 * k + 1.0) / (2.0 * order)));
+		}
+	}
+
+	template<std::size_t Order>
+	constexpr std::array<BiquadCoefficients, Order / 2> ButterworthLowPass(double sampleRate, double cutoff) {
+		static_assert(Order > 0 && Order % 2 == 0, "Only even orders are supported");
+		std::array<BiquadCoefficients, Order / 2> sections{};
+		for (std::size_t k = 0; k < Order / 2; ++k)
+			sections[k] = LowPass(sampleRate, cutoff, detail::ButterworthQ(Order, k));
+		return sections;
+	}
+
+	template<std::size_t Order>
+	constexpr std::array<BiquadCoefficients, Order / 2> ButterworthHighPass(double sampleRate, double cutoff) {
+		static_assert(Order > 0 && Order % 2 == 0, "Only even orders are supported");
+		std::array<BiquadCoefficients, Order / 2> sections{};
+		for (std::size_t k = 0; k < Order / 2; ++k)
+			sections[k] = HighPass(sampleRate, cutoff, detail::ButterworthQ(Order, k));
+		return sections;
+	}
+
+	// Joins designs into the section list of a single cascade
+	template<std::size_t ...N>
+	constexpr auto Cascade(const std::array<BiquadCoefficients, N> &...parts) {
+		std::array<BiquadCoefficients, (N + ... + 0)> sections{};
+		std::size_t i = 0;
+		((std::copy(parts.begin(), parts.end(), sections.begin() + i), i += N), ...);
+		return sections;
+	}
+
+	constexpr std::array<BiquadCoefficients, 1> Section(const BiquadCoefficients &c) {
+		return { c };
+	}
+
+	// Linear phase low-pass with unity DC gain
+	template<std::size_t Taps>
+	constexpr std::array<float, Taps> FirLowPass(double sampleRate, double cutoff) {
+		static_assert(Taps % 2 == 1, "Use an odd number of taps for a symmetric filter");
+		std::array<float, Taps> taps{};
+		if (!detail::InRange(sampleRate, cutoff)) {
+			taps[Taps / 2] = 1.f;
+			return taps;
+		}
+		double fc = cutoff / sampleRate;
+		double h[Taps] = {};
+		double sum = 0.0;
+		constexpr double M = static_cast<double>(Taps - 1);
+		for (std::size_t i = 0; i < Taps; ++i) {
+			double n = static_cast<double>(i) - M / 2.0;
+			double sinc = n == 0.0 ? 2.0 * fc : detail::Sin(2.0 * detail::PI * fc * n) / (detail::PI * n);
+			double window = 0.54 - 0.46 * detail::Cos(2.0 * detail::PI * static_cast<double>(i) / M);
+			h[i] = sinc * window;
+			sum += h[i];
+		}
+		for (std::size_t i = 0; i < Taps; ++i)
+			taps[i] = static_cast<float>(h[i] / sum);
+		return taps;
+	}
+}
+}
+
+#endif
@@ -0,0 +1,343 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_DSP_FILTER_H_
+#define CEE_DSP_FILTER_H_
+
+#include <cee/dsp/design.h>
+#include <cee/dsp/fixed.h>
+#include <cee/dsp/simd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace cee {
+namespace dsp {
+	// Sample type T is float or a Fixed type, see the specializations
+	template<std::size_t Sections, typename T = float>
+	class BiquadCascade;
+
+	template<std::size_t Taps, typename T = float>
+	class Fir;
+
+	/*
+	 * Cascade of biquad sections in transposed direct form II.
+	 *
+	 * A single channel cascade is serial, so instead of vectorising over
+	 * time the sections are pipelined across vector lanes: on every step
+	 * lane k runs section k on the output lane k-1 produced on the previous
+	 * step. All sections then advance with one vector update per sample, at
+	 * the cost of a fixed delay of Sections - 1 samples. Cascades longer
+	 * than one vector are chained through further vectors the same way.
+	 */
+	template<std::size_t Sections>
+	class BiquadCascade<Sections, float> {
+		static_assert(Sections > 0, "A cascade needs at least one section");
+
+	public:
+		static constexpr std::size_t SECTION_COUNT = Sections;
+		static constexpr std::size_t LATENCY = Sections - 1;
+
+	public:
+		BiquadCascade() {
+			std::array<BiquadCoefficients, Sections> sections;
+			sections.fill(BiquadCoefficients::Identity());
+			SetCoefficients(sections);
+		}
+
+		explicit BiquadCascade(const std::array<BiquadCoefficients, Sections> &sections) {
+			SetCoefficients(sections);
+		}
+
+		void SetCoefficients(const std::array<BiquadCoefficients, Sections> &sections) {
+			for (std::size_t g = 0; g < GROUPS; ++g) {
+				float b0[4], b1[4], b2[4], a1[4], a2[4];
+				for (std::size_t lane = 0; lane < 4; ++lane) {
+					std::size_t i = g * 4 + lane;
+					// Lanes past the last section pass their input through
+					BiquadCoefficients c = i < Sections ? sections[i] : BiquadCoefficients::Identity();
+					b0[lane] = c.b0;
+					b1[lane] = c.b1;
+					b2[lane] = c.b2;
+					a1[lane] = c.a1;
+					a2[lane] = c.a2;
+				}
+				m_B0[g] = Vec4::Load(b0);
+				m_B1[g] = Vec4::Load(b1);
+				m_B2[g] = Vec4::Load(b2);
+				m_A1[g] = Vec4::Load(a1);
+				m_A2[g] = Vec4::Load(a2);
+			}
+			Reset();
+		}
+
+		std::size_t Process(std::span<float> block) {
+			for (float &x : block) {
+				// Later groups first, they take the previous step's output
+				// of the group before them
+				for (std::size_t g = GROUPS; g-- > 0;) {
+					float in = g == 0 ? x : m_Y[g - 1].template Get<3>();
+					Vec4 v = m_Y[g].ShiftIn(in);
+					Vec4 y = Vec4::MulAdd(m_B0[g], v, m_S1[g]);
+					m_S1[g] = Vec4::MulSub(m_A1[g], y, Vec4::MulAdd(m_B1[g], v, m_S2[g]));
+					m_S2[g] = Vec4::MulSub(m_A2[g], y, m_B2[g] * v);
+					m_Y[g] = y;
+				}
+				x = m_Y[GROUPS - 1].template Get<OUTPUT_LANE>();
+			}
+			return block.size();
+		}
+
+		void Reset() {
+			for (std::size_t g = 0; g < GROUPS; ++g) {
+				m_S1[g] = Vec4::Zero();
+				m_S2[g] = Vec4::Zero();
+				m_Y[g] = Vec4::Zero();
+			}
+		}
+
+	private:
+		static constexpr std::size_t GROUPS = (Sections + 3) / 4;
+		static constexpr int OUTPUT_LANE = static_cast<int>((Sections - 1) % 4);
+
+		std::array<Vec4, GROUPS> m_B0, m_B1, m_B2, m_A1, m_A2;
+		std::array<Vec4, GROUPS> m_S1, m_S2;
+		std::array<Vec4, GROUPS> m_Y;
+	};
+
+	/*
+	 * FIR filter. Four consecutive outputs are computed per vector, each tap
+	 * being a broadcast multiply-add over a sliding window of the input, so
+	 * no horizontal sums are needed. Input is handled in chunks behind the
+	 * last Taps - 1 samples of history, keeping the block in place.
+	 */
+	template<std::size_t Taps>
+	class Fir<Taps, float> {
+		static_assert(Taps > 0, "A filter needs at least one tap");
+
+	public:
+		static constexpr std::size_t TAP_COUNT = Taps;
+
+	public:
+		Fir() {
+			std::array<float, Taps> taps{};
+			taps[0] = 1.f;
+			SetTaps(taps);
+		}
+
+		explicit Fir(const std::array<float, Taps> &taps) {
+			SetTaps(taps);
+		}
+
+		void SetTaps(const std::array<float, Taps> &taps) {
+			m_Taps = taps;
+			for (std::size_t k = 0; k < Taps; ++k)
+				m_Broadcast[k] = Vec4::Set1(taps[k]);
+			Reset();
+		}
+
+		std::size_t Process(std::span<float> block) {
+			for (std::size_t offset = 0; offset < block.size(); offset += CHUNK) {
+				std::size_t count = std::min(CHUNK, block.size() - offset);
+				float *out = block.data() + offset;
+				float *in = m_Buffer.data() + HISTORY;
+				std::copy_n(out, count, in);
+
+				std::size_t n = 0;
+				for (; n + 4 <= count; n += 4) {
+					Vec4 acc = Vec4::Zero();
+					for (std::size_t k = 0; k < Taps; ++k)
+						acc = Vec4::MulAdd(m_Broadcast[k], Vec4::Load(in + n - k), acc);
+					acc.Store(out + n);
+				}
+				for (; n < count; ++n) {
+					float acc = 0.f;
+					for (std::size_t k = 0; k < Taps; ++k)
+						acc += m_Taps[k] * in[n - k];
+					out[n] = acc;
+				}
+
+				std::copy_n(m_Buffer.data() + count, HISTORY, m_Buffer.data());
+			}
+			return block.size();
+		}
+
+		void Reset() {
+			m_Buffer.fill(0.f);
+		}
+
+	private:
+		static constexpr std::size_t CHUNK = 32;
+		static constexpr std::size_t HISTORY = Taps - 1;
+
+		std::array<float, Taps> m_Taps;
+		std::array<Vec4, Taps> m_Broadcast;
+		std::array<float, HISTORY + CHUNK> m_Buffer;
+	};
+
+	/*
+	 * Fixed point cascade of biquads in direct form I, one section after
+	 * another with no added delay. Sections keep their inputs and outputs
+	 * at sample precision and sum in 64 bits with Q2.30 coefficients. The
+	 * rounding error of each output is fed back into the next one, which
+	 * keeps sections with poles close to the unit circle, such as a
+	 * baseline high-pass, from drifting on their own quantisation noise.
+	 */
+	template<std::size_t Sections, typename S, int F>
+	class BiquadCascade<Sections, Fixed<S, F>> {
+		static_assert(Sections > 0, "A cascade needs at least one section");
+		using ValueType = Fixed<S, F>;
+
+	public:
+		static constexpr std::size_t SECTION_COUNT = Sections;
+		static constexpr std::size_t LATENCY = 0;
+
+	public:
+		BiquadCascade() {
+			std::array<BiquadCoefficients, Sections> sections;
+			sections.fill(BiquadCoefficients::Identity());
+			SetCoefficients(sections);
+		}
+
+		explicit BiquadCascade(const std::array<BiquadCoefficients, Sections> &sections) {
+			SetCoefficients(sections);
+		}
+
+		void SetCoefficients(const std::array<BiquadCoefficients, Sections> &sections) {
+			for (std::size_t i = 0; i < Sections; ++i) {
+				m_Sections[i] = {
+					FixedCoefficient::FromFloat(sections[i].b0),
+					FixedCoefficient::FromFloat(sections[i].b1),
+					FixedCoefficient::FromFloat(sections[i].b2),
+					FixedCoefficient::FromFloat(sections[i].a1),
+					FixedCoefficient::FromFloat(sections[i].a2),
+				};
+			}
+			Reset();
+		}
+
+		std::size_t Process(std::span<ValueType> block) {
+			for (ValueType &x : block) {
+				ValueType in = x;
+				for (std::size_t i = 0; i < Sections; ++i) {
+					const Coefficients &c = m_Sections[i];
+					State &state = m_State[i];
+					int64_t acc = state.error
+						+ FixedCoefficient::Multiply(c.b0, in)
+						+ FixedCoefficient::Multiply(c.b1, state.x1)
+						+ FixedCoefficient::Multiply(c.b2, state.x2)
+						- FixedCoefficient::Multiply(c.a1, state.y1)
+						- FixedCoefficient::Multiply(c.a2, state.y2);
+					ValueType out = ValueType::Saturate(acc >> SHIFT);
+					state.error = acc - (int64_t(out.raw) << SHIFT);
+					state.x2 = state.x1;
+					state.x1 = in;
+					state.y2 = state.y1;
+					state.y1 = out;
+					in = out;
+				}
+				x = in;
+			}
+			return block.size();
+		}
+
+		void Reset() {
+			m_State.fill({});
+		}
+
+	private:
+		static constexpr int SHIFT = FixedCoefficient::FRAC_BITS - FixedCoefficient::PRODUCT_SHIFT<ValueType>;
+
+		struct Coefficients {
+			int32_t b0, b1, b2;
+			int32_t a1, a2;
+		};
+
+		struct State {
+			ValueType x1, x2;
+			ValueType y1, y2;
+			int64_t error = 0;
+		};
+
+		std::array<Coefficients, Sections> m_Sections;
+		std::array<State, Sections> m_State;
+	};
+
+	/*
+	 * Fixed point FIR filter, summing Q2.30 taps over a history of the last
+	 * Taps - 1 samples in 64 bits.
+	 */
+	template<std::size_t Taps, typename S, int F>
+	class Fir<Taps, Fixed<S, F>> {
+		static_assert(Taps > 0, "A filter needs at least one tap");
+		using ValueType = Fixed<S, F>;
+
+	public:
+		static constexpr std::size_t TAP_COUNT = Taps;
+
+	public:
+		Fir() {
+			std::array<float, Taps> taps{};
+			taps[0] = 1.f;
+			SetTaps(taps);
+		}
+
+		explicit Fir(const std::array<float, Taps> &taps) {
+			SetTaps(taps);
+		}
+
+		void SetTaps(const std::array<float, Taps> &taps) {
+			for (std::size_t k = 0; k < Taps; ++k)
+				m_Taps[k] = FixedCoefficient::FromFloat(taps[k]);
+			Reset();
+		}
+
+		std::size_t Process(std::span<ValueType> block) {
+			for (ValueType &x : block) {
+				m_History[m_Pos] = x;
+				int64_t acc = int64_t(1) << (SHIFT - 1);
+				std::size_t pos = m_Pos;
+				for (std::size_t k = 0; k < Taps; ++k) {
+					acc += FixedCoefficient::Multiply(m_Taps[k], m_History[pos]);
+					pos = pos == 0 ? Taps - 1 : pos - 1;
+				}
+				x = ValueType::Saturate(acc >> SHIFT);
+				m_Pos = m_Pos + 1 == Taps ? 0 : m_Pos + 1;
+			}
+			return block.size();
+		}
+
+		void Reset() {
+			m_History.fill({});
+			m_Pos = 0;
+		}
+
+	private:
+		static constexpr int SHIFT = FixedCoefficient::FRAC_BITS - FixedCoefficient::PRODUCT_SHIFT<ValueType>;
+
+		std::array<int32_t, Taps> m_Taps;
+		std::array<ValueType, Taps> m_History;
+		std::size_t m_Pos;
+	};
+}
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_DSP_FIXED_H_
+#define CEE_DSP_FIXED_H_
+
+#include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace cee {
+namespace dsp {
+	namespace detail {
+		// x / 2^shift rounded to nearest, for shift >= 0
+		constexpr int64_t RoundShift(int64_t x, int shift) {
+			return shift == 0 ? x : (x + (int64_t(1) << (shift - 1))) >> shift;
+		}
+
+		constexpr double Round(double x) {
+			return x < 0.0 ? -static_cast<double>(static_cast<int64_t>(0.5 - x))
+				: static_cast<double>(static_cast<int64_t>(x + 0.5));
+		}
+	}
+
+	/*
+	 * Signed fixed point number with Frac fractional bits in a Storage
+	 * integer, so Q15 covers [-1, 1) in steps of 2^-15. Conversions round to
+	 * nearest and all arithmetic saturates instead of wrapping.
+	 */
+	template<typename Storage, int Frac>
+	struct Fixed {
+		static_assert(std::is_integral_v<Storage> && std::is_signed_v<Storage>, "Storage must be a signed integer");
+		static_assert(sizeof(Storage) <= 4, "Products must fit 64 bits");
+		static_assert(Frac > 0 && Frac < static_cast<int>(sizeof(Storage) * 8), "Fractional bits must fit the storage");
+
+		using StorageType = Storage;
+		static constexpr int FRAC_BITS = Frac;
+		static constexpr int64_t ONE = int64_t(1) << Frac;
+		static constexpr int64_t MIN_RAW = std::numeric_limits<Storage>::min();
+		static constexpr int64_t MAX_RAW = std::numeric_limits<Storage>::max();
+
+		Storage raw = 0;
+
+		static constexpr Fixed FromRaw(Storage raw) { return Fixed{ raw }; }
+
+		static constexpr Fixed Saturate(int64_t raw) {
+			return Fixed{ static_cast<Storage>(std::clamp(raw, MIN_RAW, MAX_RAW)) };
+		}
+
+		static constexpr Fixed FromFloat(double x) {
+			double scaled = detail::Round(x * static_cast<double>(ONE));
+			return Fixed{ static_cast<Storage>(std::clamp(scaled,
+					static_cast<double>(MIN_RAW), static_cast<double>(MAX_RAW))) };
+		}
+
+		constexpr double ToDouble() const { return static_cast<double>(raw) / static_cast<double>(ONE); }
+		constexpr float ToFloat() const { return static_cast<float>(ToDouble()); }
+
+		friend constexpr auto operator<=>(const Fixed &, const Fixed &) = default;
+
+		friend constexpr Fixed operator+(Fixed a, Fixed b) { return Saturate(int64_t(a.raw) + b.raw); }
+		friend constexpr Fixed operator-(Fixed a, Fixed b) { return Saturate(int64_t(a.raw) - b.raw); }
+		friend constexpr Fixed operator*(Fixed a, Fixed b) {
+			return Saturate(detail::RoundShift(int64_t(a.raw) * b.raw, Frac));
+		}
+	};
+
+	using Q15 = Fixed<int16_t, 15>;
+	using Q31 = Fixed<int32_t, 31>;
+
+	template<typename T>
+	struct IsFixed : std::false_type {};
+	template<typename S, int F>
+	struct IsFixed<Fixed<S, F>> : std::true_type {};
+
+	template<typename T>
+	concept FixedPoint = IsFixed<T>::value;
+
+	template<typename T>
+	concept SampleType = std::is_arithmetic_v<T> || FixedPoint<T>;
+
+	/*
+	 * Filter coefficients in fixed point stages are Q2.30, which holds the
+	 * feedback terms of any stable biquad. Products with 16 bit samples are
+	 * exact in 64 bits. Products with wider samples are shifted right by
+	 * PRODUCT_SHIFT before they are summed so a handful of them cannot
+	 * overflow, which costs nothing visible at 31 fractional bits.
+	 */
+	struct FixedCoefficient {
+		static constexpr int FRAC_BITS = 30;
+
+		template<FixedPoint T>
+		static constexpr int PRODUCT_SHIFT = sizeof(typename T::StorageType) > 2 ? 16 : 0;
+
+		static constexpr int32_t FromFloat(double x) {
+			double scaled = detail::Round(x * static_cast<double>(int64_t(1) << FRAC_BITS));
+			return static_cast<int32_t>(std::clamp(scaled,
+					static_cast<double>(std::numeric_limits<int32_t>::min()),
+					static_cast<double>(std::numeric_limits<int32_t>::max())));
+		}
+
+		template<FixedPoint T>
+		static constexpr int64_t Multiply(int32_t coefficient, T x) {
+			return (int64_t(coefficient) * x.raw) >> PRODUCT_SHIFT<T>;
+		}
+	};
+
+	/*
+	 * What generic stages need from a sample type: a type to sum samples
+	 * in without overflow and conversion to and from real values.
+	 */
+	template<typename T>
+	struct SampleTraits {
+		static_assert(std::is_arithmetic_v<T>, "Samples are arithmetic or fixed point");
+
+		using Accumulator = T;
+
+		static constexpr Accumulator Widen(T x) { return x; }
+		static constexpr T Narrow(Accumulator sum) { return sum; }
+		static constexpr T FromFloat(double x) { return static_cast<T>(x); }
+		static constexpr double ToDouble(T x) { return static_cast<double>(x); }
+	};
+
+	template<typename S, int F>
+	struct SampleTraits<Fixed<S, F>> {
+		// In raw units
+		using Accumulator = int64_t;
+
+		static constexpr Accumulator Widen(Fixed<S, F> x) { return x.raw; }
+		static constexpr Fixed<S, F> Narrow(Accumulator sum) { return Fixed<S, F>::Saturate(sum); }
+		static constexpr Fixed<S, F> FromFloat(double x) { return Fixed<S, F>::FromFloat(x); }
+		static constexpr double ToDouble(Fixed<S, F> x) { return x.ToDouble(); }
+	};
+}
+}
+
+#endif
@@ -0,0 +1,342 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_DSP_NIBP_H_
+#define CEE_DSP_NIBP_H_
+
+#include <cee/dsp/design.h>
+#include <cee/dsp/filter.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace cee {
+namespace dsp {
+	struct NibpResult {
+		enum class Status {
+			OK = 0,
+			// Not enough pulses recorded during deflation
+			TOO_FEW_PULSES,
+			// The envelope never fell to the systolic ratio, the cuff was
+			// not inflated far enough
+			NO_SYSTOLIC,
+			// Deflation ended before the envelope fell to the diastolic ratio
+			NO_DIASTOLIC,
+		};
+
+		Status status = Status::TOO_FEW_PULSES;
+		// mmHg
+		float systolic = 0.f;
+		float diastolic = 0.f;
+		float mean = 0.f;
+		std::size_t pulseCount = 0;
+
+		bool IsValid() const { return status == Status::OK; }
+
+		static constexpr const char *StatusName(Status status) {
+			switch (status) {
+			case Status::OK:
+				return "ok";
+			case Status::TOO_FEW_PULSES:
+				return "too few pulses";
+			case Status::NO_SYSTOLIC:
+				return "no systolic";
+			case Status::NO_DIASTOLIC:
+				return "no diastolic";
+			}
+			return "unknown";
+		}
+	};
+
+	/*
+	 * Oscillometric non-invasive blood pressure measurement.
+	 *
+	 * Follows the cuff pressure through inflation and deflation. While
+	 * deflating, the oscillation channel is band-passed and split into
+	 * pulses at their troughs. Every pulse adds one point to the envelope:
+	 * its trough to peak amplitude against the mean cuff pressure over the
+	 * pulse. Once the cuff is deflated, the mean pressure is taken at the
+	 * largest oscillation and systolic and diastolic where the envelope
+	 * falls to SYSTOLIC_RATIO and DIASTOLIC_RATIO of it on either side.
+	 *
+	 * Work per sample is constant, and the envelope is bounded by
+	 * MAX_PULSES so evaluating it is too. Nothing is allocated.
+	 */
+	class NibpEngine {
+	public:
+		enum class State {
+			IDLE = 0,
+			INFLATING,
+			DEFLATING,
+		};
+
+		static constexpr std::size_t MAX_PULSES = 256;
+		static constexpr std::size_t MIN_PULSES = 6;
+		static constexpr float SYSTOLIC_RATIO = 0.55f;
+		static constexpr float DIASTOLIC_RATIO = 0.85f;
+		// mmHg, a measurement starts above ARM_PRESSURE and is evaluated
+		// once deflation drops below END_PRESSURE
+		static constexpr float ARM_PRESSURE = 40.f;
+		static constexpr float END_PRESSURE = 30.f;
+		// mmHg below the inflation peak that counts as deflating
+		static constexpr float DEFLATION_DROP = 3.f;
+
+	public:
+		// pressureScale converts the pressure input to mmHg, oscillations
+		// smaller than noiseFloor are ignored
+		NibpEngine(float sampleRate, float pressureScale = 1.f, float noiseFloor = 0.f)
+		 : m_PressureScale(pressureScale), m_NoiseFloor(noiseFloor) {
+			m_BandPass.SetCoefficients({ HighPass(sampleRate, 0.5), LowPass(sampleRate, 10.0) });
+			m_Smoothing = 1.f - std::exp(-1.f / (0.25f * sampleRate));
+			m_MinPulse = static_cast<std::size_t>(std::lround(0.25f * sampleRate));
+			m_MaxPulse = static_cast<std::size_t>(std::lround(2.f * sampleRate));
+			Reset();
+		}
+
+		void Process(std::span<const float> pressure, std::span<const float> oscillation) {
+			std::array<float, CHUNK> filtered;
+			std::size_t size = std::min(pressure.size(), oscillation.size());
+			for (std::size_t offset = 0; offset < size; offset += CHUNK) {
+				std::size_t count = std::min(CHUNK, size - offset);
+				std::copy_n(oscillation.data() + offset, count, filtered.data());
+				m_BandPass.Process(std::span<float>(filtered.data(), count));
+				for (std::size_t i = 0; i < count; ++i)
+					Step(pressure[offset + i] * m_PressureScale, filtered[i]);
+			}
+		}
+
+		void Reset() {
+			m_BandPass.Reset();
+			m_State = State::IDLE;
+			m_Pressure = 0.f;
+			m_PeakPressure = 0.f;
+			m_PulseCount = 0;
+			m_Result = NibpResult();
+			m_MeasurementCount = 0;
+			ResetPulse(0.f);
+		}
+
+		State GetState() const { return m_State; }
+		// Smoothed cuff pressure in mmHg
+		float GetCuffPressure() const { return m_Pressure; }
+		// Incremented whenever a measurement finishes, valid or not
+		uint64_t GetMeasurementCount() const { return m_MeasurementCount; }
+		const NibpResult &GetResult() const { return m_Result; }
+
+	private:
+		static constexpr std::size_t CHUNK = 32;
+
+		struct Pulse {
+			float pressure;
+			float amplitude;
+		};
+
+		void Step(float pressure, float oscillation) {
+			m_Pressure += m_Smoothing * (pressure - m_Pressure);
+
+			switch (m_State) {
+			case State::IDLE:
+				if (m_Pressure > ARM_PRESSURE) {
+					m_State = State::INFLATING;
+					m_PeakPressure = m_Pressure;
+				}
+				break;
+			case State::INFLATING:
+				m_PeakPressure = std::max(m_PeakPressure, m_Pressure);
+				if (m_Pressure < m_PeakPressure - DEFLATION_DROP) {
+					m_State = State::DEFLATING;
+					m_PulseCount = 0;
+					ResetPulse(oscillation);
+				} else if (m_Pressure < END_PRESSURE) {
+					// Inflation abandoned
+					m_State = State::IDLE;
+				}
+				break;
+			case State::DEFLATING:
+				TrackPulse(pressure, oscillation);
+				if (m_Pressure < END_PRESSURE) {
+					Evaluate();
+					m_State = State::IDLE;
+				}
+				break;
+			}
+		}
+
+		void ResetPulse(float oscillation) {
+			m_Rising = true;
+			m_HavePeak = false;
+			m_HaveTrough = false;
+			m_Extreme = oscillation;
+			m_Trough = oscillation;
+			m_Peak = oscillation;
+			m_Hysteresis = m_NoiseFloor;
+			m_PulseSum = 0.0;
+			m_PulseSamples = 0;
+		}
+
+		// Splits the oscillations into pulses with a hysteresis that follows
+		// the last amplitude
+		void TrackPulse(float pressure, float oscillation) {
+			m_PulseSum += pressure;
+			++m_PulseSamples;
+
+			if (m_Rising) {
+				m_Extreme = std::max(m_Extreme, oscillation);
+				if (oscillation < m_Extreme - m_Hysteresis) {
+					m_Peak = m_Extreme;
+					m_HavePeak = true;
+					m_Rising = false;
+					m_Extreme = oscillation;
+				}
+				return;
+			}
+
+			m_Extreme = std::min(m_Extreme, oscillation);
+			if (oscillation <= m_Extreme + m_Hysteresis)
+				return;
+
+			// Trough behind us, the pulse since the previous trough is complete
+			if (m_HaveTrough && m_HavePeak && m_PulseSamples >= m_MinPulse && m_PulseSamples <= m_MaxPulse) {
+				float amplitude = m_Peak - m_Trough;
+				if (amplitude > m_NoiseFloor && m_PulseCount < MAX_PULSES) {
+					float mean = static_cast<float>(m_PulseSum / static_cast<double>(m_PulseSamples));
+					m_Pulses[m_PulseCount++] = { mean, amplitude };
+				}
+				m_Hysteresis = std::max(m_NoiseFloor, 0.3f * amplitude);
+			}
+			m_Trough = m_Extreme;
+			m_HaveTrough = true;
+			m_HavePeak = false;
+			m_Rising = true;
+			m_Extreme = oscillation;
+			m_PulseSum = 0.0;
+			m_PulseSamples = 0;
+		}
+
+		void Evaluate() {
+			NibpResult result;
+			result.pulseCount = m_PulseCount;
+			++m_MeasurementCount;
+			if (m_PulseCount < MIN_PULSES) {
+				result.status = NibpResult::Status::TOO_FEW_PULSES;
+				m_Result = result;
+				return;
+			}
+
+			// Median of three, then a three point average, against single
+			// pulses disturbed by movement
+			std::array<float, MAX_PULSES> median;
+			for (std::size_t i = 0; i < m_PulseCount; ++i) {
+				float a = m_Pulses[i == 0 ? i : i - 1].amplitude;
+				float b = m_Pulses[i].amplitude;
+				float c = m_Pulses[i + 1 == m_PulseCount ? i : i + 1].amplitude;
+				median[i] = std::max(std::min(a, b), std::min(std::max(a, b), c));
+			}
+			std::size_t peak = 0;
+			for (std::size_t i = 0; i < m_PulseCount; ++i) {
+				float sum = median[i];
+				int n = 1;
+				if (i > 0) {
+					sum += median[i - 1];
+					++n;
+				}
+				if (i + 1 < m_PulseCount) {
+					sum += median[i + 1];
+					++n;
+				}
+				m_Envelope[i] = sum / static_cast<float>(n);
+				if (m_Envelope[i] > m_Envelope[peak])
+					peak = i;
+			}
+			float maximum = m_Envelope[peak];
+			result.mean = m_Pulses[peak].pressure;
+
+			// Pulses come in order of falling pressure, systolic lies
+			// before the peak and diastolic after it
+			bool found = false;
+			for (std::size_t i = peak; i-- > 0;) {
+				if (m_Envelope[i] < SYSTOLIC_RATIO * maximum) {
+					result.systolic = Interpolate(i, i + 1, SYSTOLIC_RATIO * maximum);
+					found = true;
+					break;
+				}
+			}
+			if (!found) {
+				result.status = NibpResult::Status::NO_SYSTOLIC;
+				m_Result = result;
+				return;
+			}
+
+			found = false;
+			for (std::size_t i = peak + 1; i < m_PulseCount; ++i) {
+				if (m_Envelope[i] < DIASTOLIC_RATIO * maximum) {
+					result.diastolic = Interpolate(i, i - 1, DIASTOLIC_RATIO * maximum);
+					found = true;
+					break;
+				}
+			}
+			result.status = found ? NibpResult::Status::OK : NibpResult::Status::NO_DIASTOLIC;
+			m_Result = result;
+		}
+
+		// Pressure where the envelope crosses level between pulse below,
+		// under the level, and pulse above it
+		float Interpolate(std::size_t below, std::size_t above, float level) const {
+			float a = m_Envelope[below];
+			float b = m_Envelope[above];
+			float t = b > a ? (level - a) / (b - a) : 0.f;
+			return m_Pulses[below].pressure + t * (m_Pulses[above].pressure - m_Pulses[below].pressure);
+		}
+
+	private:
+		float m_PressureScale;
+		float m_NoiseFloor;
+		float m_Smoothing;
+		std::size_t m_MinPulse;
+		std::size_t m_MaxPulse;
+		BiquadCascade<2> m_BandPass;
+
+		State m_State;
+		float m_Pressure;
+		float m_PeakPressure;
+
+		bool m_Rising;
+		bool m_HavePeak;
+		bool m_HaveTrough;
+		float m_Extreme;
+		float m_Trough;
+		float m_Peak;
+		float m_Hysteresis;
+		double m_PulseSum;
+		std::size_t m_PulseSamples;
+
+		std::array<Pulse, MAX_PULSES> m_Pulses;
+		std::array<float, MAX_PULSES> m_Envelope;
+		std::size_t m_PulseCount;
+
+		NibpResult m_Result;
+		uint64_t m_MeasurementCount;
+	};
+}
+}
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_DSP_PIPELINE_H_
+#define CEE_DSP_PIPELINE_H_
+
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <utility>
+
+namespace cee {
+namespace dsp {
+	/*
+	 * A stage processes one block of a single channel in place and returns
+	 * how many samples it left at the front of the block. Most stages return
+	 * the block size, decimators return fewer and a stage returning 0 ends
+	 * processing of the block. Stages keep whatever state they need between
+	 * blocks and must not allocate in Process().
+	 */
+	template<typename S, typename T>
+	concept Stage = requires(S stage, std::span<T> block) {
+		{ stage.Process(block) } -> std::convertible_to<std::size_t>;
+		stage.Reset();
+	};
+
+	/*
+	 * Chain of stages resolved at compile time, so running a block through
+	 * the pipeline costs one inlinable call per stage and no virtual calls
+	 * or allocations. Each channel gets its own pipeline instance.
+	 */
+	template<typename T, Stage<T> ...Stages>
+	class Pipeline {
+	public:
+		using ValueType = T;
+		static constexpr std::size_t STAGE_COUNT = sizeof...(Stages);
+
+	public:
+		Pipeline() = default;
+		explicit Pipeline(Stages ...stages) : m_Stages(std::move(stages)...) {}
+
+		// Returns the number of output samples now at the front of block
+		std::size_t Process(std::span<T> block) {
+			return ProcessFrom<0>(block);
+		}
+
+		void Reset() {
+			std::apply([](auto &...stages) { (stages.Reset(), ...); }, m_Stages);
+		}
+
+		template<std::size_t I>
+		auto &Get() { return std::get<I>(m_Stages); }
+		template<std::size_t I>
+		const auto &Get() const { return std::get<I>(m_Stages); }
+
+		template<typename S>
+		S &Get() { return std::get<S>(m_Stages); }
+		template<typename S>
+		const S &Get() const { return std::get<S>(m_Stages); }
+
+	private:
+		template<std::size_t I>
+		std::size_t ProcessFrom(std::span<T> block) {
+			if constexpr (I == STAGE_COUNT) {
+				return block.size();
+			} else {
+				std::size_t count = std::get<I>(m_Stages).Process(block);
+				if (count == 0)
+					return 0;
+				return ProcessFrom<I + 1>(block.first(count));
+			}
+		}
+
+	private:
+		std::tuple<Stages...> m_Stages;
+	};
+}
+}
+
+#endif
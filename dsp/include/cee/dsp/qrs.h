@@ -0,0 +1,286 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_DSP_QRS_H_
+#define CEE_DSP_QRS_H_
+
+#include <cee/dsp/design.h>
+#include <cee/dsp/filter.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace cee {
+namespace dsp {
+	/*
+	 * Streaming QRS detector after Pan and Tompkins (1985). Each sample is
+	 * band-passed to 5-15 Hz, differentiated, squared and integrated over a
+	 * 150 ms window. Peaks of the integrated signal are classified
+	 * as QRS or noise against adaptive thresholds, with a 200 ms refractory
+	 * period, T wave rejection on slope and a search back for missed beats.
+	 *
+	 * The stage only observes the block. Work per sample is constant and
+	 * all state is fixed size, so nothing is allocated in Process().
+	 */
+	class QrsDetector {
+	public:
+		static constexpr std::size_t MAX_WINDOW = 128;
+		// Intervals averaged into the heart rate
+		static constexpr std::size_t RR_HISTORY = 8;
+
+	public:
+		explicit QrsDetector(float sampleRate) {
+			SetSampleRate(sampleRate);
+		}
+
+		void SetSampleRate(float sampleRate) {
+			m_SampleRate = sampleRate;
+			m_BandPass.SetCoefficients({ HighPass(sampleRate, 5.0), LowPass(sampleRate, 15.0) });
+			m_WindowLength = std::clamp<std::size_t>(Samples(0.150f), 1, MAX_WINDOW);
+			m_Refractory = Samples(0.200f);
+			m_TWaveWindow = Samples(0.360f);
+			m_LearningPeriod = Samples(2.f);
+			m_MinRR = Samples(0.200f);
+			m_MaxRR = Samples(3.f);
+			m_Timeout = Samples(5.f);
+			Reset();
+		}
+
+		std::size_t Process(std::span<float> block) {
+			std::array<float, CHUNK> filtered;
+			for (std::size_t offset = 0; offset < block.size(); offset += CHUNK) {
+				std::size_t count = std::min(CHUNK, block.size() - offset);
+				std::copy_n(block.data() + offset, count, filtered.data());
+				m_BandPass.Process(std::span<float>(filtered.data(), count));
+				for (std::size_t i = 0; i < count; ++i)
+					Step(filtered[i]);
+			}
+			return block.size();
+		}
+
+		void Reset() {
+			m_BandPass.Reset();
+			m_History.fill(0.f);
+			m_Window.fill(0.f);
+			m_WindowPos = 0;
+			m_WindowSum = 0.0;
+			m_Slope = 0.f;
+			m_Peak = 0.f;
+			m_PeakIndex = 0;
+			m_PeakSlope = 0.f;
+			m_SampleIndex = 0;
+			m_LearnMax = 0.f;
+			m_LearnSum = 0.0;
+			m_SignalLevel = 0.f;
+			m_NoiseLevel = 0.f;
+			m_Threshold = 0.f;
+			m_SearchBackValue = 0.f;
+			m_SearchBackIndex = 0;
+			m_SearchBackSlope = 0.f;
+			m_LastBeat = 0;
+			m_LastBeatSlope = 0.f;
+			m_BeatCount = 0;
+			m_RR.fill(0);
+			m_RRCount = 0;
+			m_RRPos = 0;
+			m_RRSum = 0;
+			m_BeatRate = 0.f;
+			m_HeartRate = 0.f;
+		}
+
+		uint64_t GetBeatCount() const { return m_BeatCount; }
+		// Sample index of the last R peak, counted from the last reset
+		uint64_t GetLastBeat() const { return m_LastBeat; }
+		// Rate from the last RR interval and from the average of the last
+		// RR_HISTORY intervals, in beats per minute. 0 when unknown.
+		float GetBeatRate() const { return m_BeatRate; }
+		float GetHeartRate() const { return m_HeartRate; }
+
+	private:
+		static constexpr std::size_t CHUNK = 32;
+
+		std::size_t Samples(float seconds) const {
+			return static_cast<std::size_t>(std::lround(seconds * m_SampleRate));
+		}
+
+		void Step(float x) {
+			// Five point derivative, x[n-1] .. x[n-4] in m_History
+			float d = (2.f * x + m_History[0] - m_History[2] - 2.f * m_History[3]) * 0.125f;
+			m_History = { x, m_History[0], m_History[1], m_History[2] };
+
+			float squared = d * d;
+			m_WindowSum += squared - m_Window[m_WindowPos];
+			m_Window[m_WindowPos] = squared;
+			if (++m_WindowPos == m_WindowLength)
+				m_WindowPos = 0;
+			float integrated = static_cast<float>(std::max(m_WindowSum, 0.0)) / static_cast<float>(m_WindowLength);
+
+			m_Slope = std::max(m_Slope, std::fabs(d));
+			uint64_t index = m_SampleIndex++;
+
+			if (index < m_LearningPeriod) {
+				m_LearnMax = std::max(m_LearnMax, integrated);
+				m_LearnSum += integrated;
+				if (index + 1 == m_LearningPeriod) {
+					m_SignalLevel = m_LearnMax / 3.f;
+					m_NoiseLevel = static_cast<float>(m_LearnSum / static_cast<double>(m_LearningPeriod)) / 2.f;
+					UpdateThreshold();
+				}
+			} else {
+				// A peak ends once the signal falls to half of it, which
+				// merges the ripples of a single complex
+				if (integrated > m_Peak) {
+					m_Peak = integrated;
+					m_PeakIndex = index;
+					m_PeakSlope = m_Slope;
+				} else if (integrated < 0.5f * m_Peak) {
+					OnPeak(m_Peak, m_PeakIndex, m_PeakSlope);
+					m_Peak = 0.f;
+					m_Slope = 0.f;
+				}
+				SearchBack(index);
+				if (m_BeatCount > 0 && index - m_LastBeat > m_Timeout)
+					Asystole();
+			}
+		}
+
+		void OnPeak(float value, uint64_t index, float slope) {
+			bool afterBeat = m_BeatCount > 0;
+			if (afterBeat && index - m_LastBeat < m_Refractory)
+				return;
+
+			bool qrs = value > m_Threshold;
+			// A peak soon after a beat with less than half its slope is a T wave
+			if (qrs && afterBeat && index - m_LastBeat < m_TWaveWindow && slope < 0.5f * m_LastBeatSlope)
+				qrs = false;
+
+			if (qrs) {
+				m_SignalLevel = 0.125f * value + 0.875f * m_SignalLevel;
+				AcceptBeat(index, slope);
+			} else {
+				m_NoiseLevel = 0.125f * value + 0.875f * m_NoiseLevel;
+				if (value > m_SearchBackValue) {
+					m_SearchBackValue = value;
+					m_SearchBackIndex = index;
+					m_SearchBackSlope = slope;
+				}
+			}
+			UpdateThreshold();
+		}
+
+		// Takes the largest noise peak as a beat once the current interval
+		// runs well past the average
+		void SearchBack(uint64_t index) {
+			if (m_RRCount == 0 || m_SearchBackValue <= 0.5f * m_Threshold)
+				return;
+			uint64_t limit = m_RRSum * 166 / (100 * m_RRCount);
+			if (index - m_LastBeat <= limit)
+				return;
+			m_SignalLevel = 0.25f * m_SearchBackValue + 0.75f * m_SignalLevel;
+			AcceptBeat(m_SearchBackIndex, m_SearchBackSlope);
+			UpdateThreshold();
+		}
+
+		void AcceptBeat(uint64_t index, float slope) {
+			if (m_BeatCount > 0) {
+				uint64_t rr = index - m_LastBeat;
+				if (rr >= m_MinRR && rr <= m_MaxRR) {
+					if (m_RRCount == RR_HISTORY) {
+						m_RRSum -= m_RR[m_RRPos];
+					} else {
+						++m_RRCount;
+					}
+					m_RR[m_RRPos] = rr;
+					m_RRSum += rr;
+					m_RRPos = (m_RRPos + 1) % RR_HISTORY;
+
+					m_BeatRate = 60.f * m_SampleRate / static_cast<float>(rr);
+					m_HeartRate = 60.f * m_SampleRate * static_cast<float>(m_RRCount) / static_cast<float>(m_RRSum);
+				}
+			}
+			m_LastBeat = index;
+			m_LastBeatSlope = slope;
+			++m_BeatCount;
+			m_SearchBackValue = 0.f;
+		}
+
+		// No beat for too long, the rates no longer mean anything
+		void Asystole() {
+			m_RR.fill(0);
+			m_RRCount = 0;
+			m_RRPos = 0;
+			m_RRSum = 0;
+			m_BeatRate = 0.f;
+			m_HeartRate = 0.f;
+		}
+
+		void UpdateThreshold() {
+			m_Threshold = m_NoiseLevel + 0.25f * (m_SignalLevel - m_NoiseLevel);
+		}
+
+	private:
+		float m_SampleRate;
+		BiquadCascade<2> m_BandPass;
+
+		std::size_t m_WindowLength;
+		std::size_t m_Refractory;
+		std::size_t m_TWaveWindow;
+		std::size_t m_LearningPeriod;
+		std::size_t m_MinRR;
+		std::size_t m_MaxRR;
+		std::size_t m_Timeout;
+
+		std::array<float, 4> m_History;
+		std::array<float, MAX_WINDOW> m_Window;
+		std::size_t m_WindowPos;
+		double m_WindowSum;
+		// Steepest slope since the last peak
+		float m_Slope;
+		float m_Peak;
+		uint64_t m_PeakIndex;
+		float m_PeakSlope;
+		uint64_t m_SampleIndex;
+
+		float m_LearnMax;
+		double m_LearnSum;
+		float m_SignalLevel;
+		float m_NoiseLevel;
+		float m_Threshold;
+
+		float m_SearchBackValue;
+		uint64_t m_SearchBackIndex;
+		float m_SearchBackSlope;
+
+		uint64_t m_LastBeat;
+		float m_LastBeatSlope;
+		uint64_t m_BeatCount;
+		std::array<uint64_t, RR_HISTORY> m_RR;
+		std::size_t m_RRCount;
+		std::size_t m_RRPos;
+		uint64_t m_RRSum;
+		float m_BeatRate;
+		float m_HeartRate;
+	};
+}
+}
+
+#endif
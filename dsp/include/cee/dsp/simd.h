@@ -0,0 +1,265 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_DSP_SIMD_H_
+#define CEE_DSP_SIMD_H_
+
+/*
+ * Minimal 4 lane float and int32 vectors used by the filter kernels and
+ * codecs, and block conversions of 8 bit ADC codes for the exporters.
+ * NEON on ARM, SSE on x86 and plain arrays everywhere else, or when
+ * CEE_DSP_NO_SIMD is defined.
+ */
+#if !defined(CEE_DSP_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define CEE_DSP_SIMD_NEON 1
+#include <arm_neon.h>
+#elif !defined(CEE_DSP_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#define CEE_DSP_SIMD_SSE 1
+#include <immintrin.h>
+#else
+#define CEE_DSP_SIMD_SCALAR 1
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cee {
+namespace dsp {
+	struct Vec4 {
+#if defined(CEE_DSP_SIMD_NEON)
+		float32x4_t v;
+
+		static Vec4 Zero() { return { vdupq_n_f32(0.f) }; }
+		static Vec4 Set1(float x) { return { vdupq_n_f32(x) }; }
+		static Vec4 Set(float a, float b, float c, float d) {
+			const float lanes[4] = { a, b, c, d };
+			return { vld1q_f32(lanes) };
+		}
+		static Vec4 Load(const float *p) { return { vld1q_f32(p) }; }
+		void Store(float *p) const { vst1q_f32(p, v); }
+
+		friend Vec4 operator+(Vec4 a, Vec4 b) { return { vaddq_f32(a.v, b.v) }; }
+		friend Vec4 operator-(Vec4 a, Vec4 b) { return { vsubq_f32(a.v, b.v) }; }
+		friend Vec4 operator*(Vec4 a, Vec4 b) { return { vmulq_f32(a.v, b.v) }; }
+		// a * b + c
+		static Vec4 MulAdd(Vec4 a, Vec4 b, Vec4 c) { return { vmlaq_f32(c.v, a.v, b.v) }; }
+		// c - a * b
+		static Vec4 MulSub(Vec4 a, Vec4 b, Vec4 c) { return { vmlsq_f32(c.v, a.v, b.v) }; }
+
+		// { x, v[0], v[1], v[2] }
+		Vec4 ShiftIn(float x) const { return { vextq_f32(vdupq_n_f32(x), v, 3) }; }
+		template<int I>
+		float Get() const { return vgetq_lane_f32(v, I); }
+#elif defined(CEE_DSP_SIMD_SSE)
+		__m128 v;
+
+		static Vec4 Zero() { return { _mm_setzero_ps() }; }
+		static Vec4 Set1(float x) { return { _mm_set1_ps(x) }; }
+		static Vec4 Set(float a, float b, float c, float d) { return { _mm_setr_ps(a, b, c, d) }; }
+		static Vec4 Load(const float *p) { return { _mm_loadu_ps(p) }; }
+		void Store(float *p) const { _mm_storeu_ps(p, v); }
+
+		friend Vec4 operator+(Vec4 a, Vec4 b) { return { _mm_add_ps(a.v, b.v) }; }
+		friend Vec4 operator-(Vec4 a, Vec4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+		friend Vec4 operator*(Vec4 a, Vec4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+		static Vec4 MulAdd(Vec4 a, Vec4 b, Vec4 c) { return { _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v) }; }
+		static Vec4 MulSub(Vec4 a, Vec4 b, Vec4 c) { return { _mm_sub_ps(c.v, _mm_mul_ps(a.v, b.v)) }; }
+
+		Vec4 ShiftIn(float x) const {
+			__m128 shifted = _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(v), 4));
+			return { _mm_move_ss(shifted, _mm_set_ss(x)) };
+		}
+		template<int I>
+		float Get() const { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(I, I, I, I))); }
+#else
+		float v[4];
+
+		static Vec4 Zero() { return { { 0.f, 0.f, 0.f, 0.f } }; }
+		static Vec4 Set1(float x) { return { { x, x, x, x } }; }
+		static Vec4 Set(float a, float b, float c, float d) { return { { a, b, c, d } }; }
+		static Vec4 Load(const float *p) { return { { p[0], p[1], p[2], p[3] } }; }
+		void Store(float *p) const {
+			for (int i = 0; i < 4; ++i)
+				p[i] = v[i];
+		}
+
+		friend Vec4 operator+(Vec4 a, Vec4 b) {
+			return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } };
+		}
+		friend Vec4 operator-(Vec4 a, Vec4 b) {
+			return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } };
+		}
+		friend Vec4 operator*(Vec4 a, Vec4 b) {
+			return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } };
+		}
+		static Vec4 MulAdd(Vec4 a, Vec4 b, Vec4 c) { return a * b + c; }
+		static Vec4 MulSub(Vec4 a, Vec4 b, Vec4 c) { return c - a * b; }
+
+		Vec4 ShiftIn(float x) const { return { { x, v[0], v[1], v[2] } }; }
+		template<int I>
+		float Get() const { return v[I]; }
+#endif
+	};
+
+	struct Int4 {
+#if defined(CEE_DSP_SIMD_NEON)
+		int32x4_t v;
+
+		static Int4 Zero() { return { vdupq_n_s32(0) }; }
+		static Int4 Set1(int32_t x) { return { vdupq_n_s32(x) }; }
+		static Int4 Load(const int32_t *p) { return { vld1q_s32(p) }; }
+		void Store(int32_t *p) const { vst1q_s32(p, v); }
+
+		friend Int4 operator+(Int4 a, Int4 b) { return { vaddq_s32(a.v, b.v) }; }
+		friend Int4 operator-(Int4 a, Int4 b) { return { vsubq_s32(a.v, b.v) }; }
+		friend Int4 operator&(Int4 a, Int4 b) { return { vandq_s32(a.v, b.v) }; }
+		friend Int4 operator^(Int4 a, Int4 b) { return { veorq_s32(a.v, b.v) }; }
+		template<int N>
+		Int4 ShiftRightLogical() const {
+			return { vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(v), N)) };
+		}
+
+		// Lanes moved up by N, zeros shifted in: { 0, v[0], v[1], v[2] } for 1
+		template<int N>
+		Int4 ShiftLanes() const { return { vextq_s32(vdupq_n_s32(0), v, 4 - N) }; }
+		template<int I>
+		Int4 Broadcast() const { return { vdupq_n_s32(vgetq_lane_s32(v, I)) }; }
+#elif defined(CEE_DSP_SIMD_SSE)
+		__m128i v;
+
+		static Int4 Zero() { return { _mm_setzero_si128() }; }
+		static Int4 Set1(int32_t x) { return { _mm_set1_epi32(x) }; }
+		static Int4 Load(const int32_t *p) { return { _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)) }; }
+		void Store(int32_t *p) const { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+
+		friend Int4 operator+(Int4 a, Int4 b) { return { _mm_add_epi32(a.v, b.v) }; }
+		friend Int4 operator-(Int4 a, Int4 b) { return { _mm_sub_epi32(a.v, b.v) }; }
+		friend Int4 operator&(Int4 a, Int4 b) { return { _mm_and_si128(a.v, b.v) }; }
+		friend Int4 operator^(Int4 a, Int4 b) { return { _mm_xor_si128(a.v, b.v) }; }
+		template<int N>
+		Int4 ShiftRightLogical() const { return { _mm_srli_epi32(v, N) }; }
+
+		template<int N>
+		Int4 ShiftLanes() const { return { _mm_slli_si128(v, 4 * N) }; }
+		template<int I>
+		Int4 Broadcast() const { return { _mm_shuffle_epi32(v, _MM_SHUFFLE(I, I, I, I)) }; }
+#else
+		int32_t v[4];
+
+		static Int4 Zero() { return { { 0, 0, 0, 0 } }; }
+		static Int4 Set1(int32_t x) { return { { x, x, x, x } }; }
+		static Int4 Load(const int32_t *p) { return { { p[0], p[1], p[2], p[3] } }; }
+		void Store(int32_t *p) const {
+			for (int i = 0; i < 4; ++i)
+				p[i] = v[i];
+		}
+
+		template<typename F>
+		static Int4 Map(Int4 a, Int4 b, F f) {
+			return { { f(a.v[0], b.v[0]), f(a.v[1], b.v[1]), f(a.v[2], b.v[2]), f(a.v[3], b.v[3]) } };
+		}
+		// Wrapping, like the vector units
+		friend Int4 operator+(Int4 a, Int4 b) {
+			return Map(a, b, [](int32_t x, int32_t y) { return static_cast<int32_t>(uint32_t(x) + uint32_t(y)); });
+		}
+		friend Int4 operator-(Int4 a, Int4 b) {
+			return Map(a, b, [](int32_t x, int32_t y) { return static_cast<int32_t>(uint32_t(x) - uint32_t(y)); });
+		}
+		friend Int4 operator&(Int4 a, Int4 b) { return Map(a, b, [](int32_t x, int32_t y) { return x & y; }); }
+		friend Int4 operator^(Int4 a, Int4 b) { return Map(a, b, [](int32_t x, int32_t y) { return x ^ y; }); }
+		template<int N>
+		Int4 ShiftRightLogical() const {
+			return Map(*this, *this, [](int32_t x, int32_t) { return static_cast<int32_t>(uint32_t(x) >> N); });
+		}
+
+		template<int N>
+		Int4 ShiftLanes() const {
+			Int4 r = Zero();
+			for (int i = N; i < 4; ++i)
+				r.v[i] = v[i - N];
+			return r;
+		}
+		template<int I>
+		Int4 Broadcast() const { return Set1(v[I]); }
+#endif
+	};
+
+	/*
+	 * ADC codes are offset binary, code 128 is mid scale. Widened to
+	 * signed 16 bit they become code - 128.
+	 */
+	inline void WidenOffset(const uint8_t *in, int16_t *out, std::size_t count) {
+		std::size_t i = 0;
+#if defined(CEE_DSP_SIMD_NEON)
+		const uint8x8_t offset = vdup_n_u8(128);
+		for (; i + 16 <= count; i += 16) {
+			uint8x16_t x = vld1q_u8(in + i);
+			vst1q_s16(out + i, vreinterpretq_s16_u16(vsubl_u8(vget_low_u8(x), offset)));
+			vst1q_s16(out + i + 8, vreinterpretq_s16_u16(vsubl_u8(vget_high_u8(x), offset)));
+		}
+#elif defined(CEE_DSP_SIMD_SSE)
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i offset = _mm_set1_epi16(128);
+		for (; i + 16 <= count; i += 16) {
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_sub_epi16(_mm_unpacklo_epi8(x, zero), offset));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 8), _mm_sub_epi16(_mm_unpackhi_epi8(x, zero), offset));
+		}
+#endif
+		for (; i < count; ++i)
+			out[i] = static_cast<int16_t>(in[i] - 128);
+	}
+
+	// Four planes of bytes into frames, out[4 * i + k] is plane k's i-th
+	inline void Interleave4(const uint8_t *a, const uint8_t *b, const uint8_t *c, const uint8_t *d,
+			uint8_t *out, std::size_t count) {
+		std::size_t i = 0;
+#if defined(CEE_DSP_SIMD_NEON)
+		for (; i + 16 <= count; i += 16) {
+			uint8x16x4_t frames = { { vld1q_u8(a + i), vld1q_u8(b + i), vld1q_u8(c + i), vld1q_u8(d + i) } };
+			vst4q_u8(out + 4 * i, frames);
+		}
+#elif defined(CEE_DSP_SIMD_SSE)
+		for (; i + 16 <= count; i += 16) {
+			__m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+			__m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+			__m128i vc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(c + i));
+			__m128i vd = _mm_loadu_si128(reinterpret_cast<const __m128i *>(d + i));
+			// a0 b0 a1 b1 ..., then c0 d0 c1 d1 ..., then whole frames
+			__m128i abLow = _mm_unpacklo_epi8(va, vb);
+			__m128i abHigh = _mm_unpackhi_epi8(va, vb);
+			__m128i cdLow = _mm_unpacklo_epi8(vc, vd);
+			__m128i cdHigh = _mm_unpackhi_epi8(vc, vd);
+			__m128i *p = reinterpret_cast<__m128i *>(out + 4 * i);
+			_mm_storeu_si128(p, _mm_unpacklo_epi16(abLow, cdLow));
+			_mm_storeu_si128(p + 1, _mm_unpackhi_epi16(abLow, cdLow));
+			_mm_storeu_si128(p + 2, _mm_unpacklo_epi16(abHigh, cdHigh));
+			_mm_storeu_si128(p + 3, _mm_unpackhi_epi16(abHigh, cdHigh));
+		}
+#endif
+		for (; i < count; ++i) {
+			out[4 * i] = a[i];
+			out[4 * i + 1] = b[i];
+			out[4 * i + 2] = c[i];
+			out[4 * i + 3] = d[i];
+		}
+	}
+}
+}
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_DSP_STAGES_H_
+#define CEE_DSP_STAGES_H_
+
+#include <cee/dsp/fixed.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+
+namespace cee {
+namespace dsp {
+	// y = x * gain + offset
+	template<typename T>
+	class Scale {
+	public:
+		constexpr Scale(T gain = T(1), T offset = T(0)) : m_Gain(gain), m_Offset(offset) {}
+
+		std::size_t Process(std::span<T> block) {
+			for (T &x : block)
+				x = x * m_Gain + m_Offset;
+			return block.size();
+		}
+		void Reset() {}
+
+		void Set(T gain, T offset) {
+			m_Gain = gain;
+			m_Offset = offset;
+		}
+
+	private:
+		T m_Gain;
+		T m_Offset;
+	};
+
+	/*
+	 * Fixed point y = x * gain + offset. The gain is kept as a 31 bit
+	 * mantissa and a shift, so gains above one, such as bringing ADC codes
+	 * to full scale, keep their precision.
+	 */
+	template<typename S, int F>
+	class Scale<Fixed<S, F>> {
+	public:
+		using ValueType = Fixed<S, F>;
+
+	public:
+		constexpr Scale(double gain = 1.0, double offset = 0.0) {
+			Set(gain, offset);
+		}
+
+		std::size_t Process(std::span<ValueType> block) {
+			for (ValueType &x : block) {
+				int64_t y = m_Shift > 0 ? detail::RoundShift(int64_t(x.raw) * m_Mantissa, m_Shift)
+					: (int64_t(x.raw) * m_Mantissa) << -m_Shift;
+				x = ValueType::Saturate(y + m_Offset.raw);
+			}
+			return block.size();
+		}
+		void Reset() {}
+
+		constexpr void Set(double gain, double offset) {
+			// gain = mantissa * 2^-shift with the mantissa in [2^30, 2^31)
+			bool negative = gain < 0.0;
+			double magnitude = negative ? -gain : gain;
+			int shift = 0;
+			if (magnitude != 0.0) {
+				while (magnitude < double(int64_t(1) << 30) && shift < 62) {
+					magnitude *= 2.0;
+					++shift;
+				}
+				while (magnitude >= double(int64_t(1) << 31) && shift > -30) {
+					magnitude *= 0.5;
+					--shift;
+				}
+			}
+			int64_t mantissa = static_cast<int64_t>(detail::Round(magnitude));
+			m_Mantissa = static_cast<int32_t>(std::min<int64_t>(mantissa, std::numeric_limits<int32_t>::max())) * (negative ? -1 : 1);
+			m_Shift = shift;
+			m_Offset = ValueType::FromFloat(offset);
+		}
+
+	private:
+		int32_t m_Mantissa = 0;
+		int m_Shift = 0;
+		ValueType m_Offset;
+	};
+
+	/*
+	 * Passes the block through unchanged after handing it to a callable,
+	 * for detectors and other stages that only observe the signal.
+	 */
+	template<typename T, typename F>
+	class Tap {
+	public:
+		explicit Tap(F fn) : m_Fn(std::move(fn)) {}
+
+		std::size_t Process(std::span<T> block) {
+			m_Fn(std::span<const T>(block));
+			return block.size();
+		}
+		void Reset() {}
+
+	private:
+		F m_Fn;
+	};
+}
+}
+
+#endif
@@ -0,0 +1,212 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_DSP_STATISTICS_H_
+#define CEE_DSP_STATISTICS_H_
+
+#include <cee/dsp/fixed.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace cee {
+namespace dsp {
+	/*
+	 * Minimum, maximum, mean and variance over the last Window samples of a
+	 * channel, Window being at most Capacity.
+	 *
+	 * Min and max come from monotonic deques of sample indices, each index
+	 * entering and leaving once, so they are O(1) amortized. Mean and
+	 * variance come from running sums taken around a shift near the mean.
+	 * The sums are rebuilt from the window once per Window samples to keep
+	 * rounding from accumulating, which is also O(1) amortized.
+	 *
+	 * For 16 bit fixed point samples the sums are exact 64 bit integers of
+	 * the raw values instead, so they need no shift, no rebuild and no
+	 * floating point until a result is read.
+	 */
+	template<typename T, std::size_t Capacity>
+	class RollingStatistics {
+		static_assert(SampleType<T>, "RollingStatistics needs an arithmetic or fixed point type");
+		static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+		static_assert(Capacity <= (std::size_t(1) << 31), "Indices are 32 bit");
+		static constexpr uint32_t MASK = static_cast<uint32_t>(Capacity - 1);
+
+		static constexpr bool EXACT = [] {
+			if constexpr (FixedPoint<T>)
+				return sizeof(typename T::StorageType) <= 2;
+			else
+				return false;
+		}();
+		using Sum = std::conditional_t<EXACT, int64_t, double>;
+
+	public:
+		static constexpr std::size_t CAPACITY = Capacity;
+
+	public:
+		explicit RollingStatistics(std::size_t window = Capacity) {
+			SetWindow(window);
+		}
+
+		// Clamped to [1, Capacity], drops the current window
+		void SetWindow(std::size_t window) {
+			m_Window = static_cast<uint32_t>(std::clamp<std::size_t>(window, 1, Capacity));
+			Reset();
+		}
+
+		void Reset() {
+			m_Index = 0;
+			m_Count = 0;
+			m_MinHead = m_MinTail = 0;
+			m_MaxHead = m_MaxTail = 0;
+			m_Shift = 0.0;
+			m_Sum = 0;
+			m_SumSquares = 0;
+			m_SinceRebuild = 0;
+		}
+
+		void Push(T x) {
+			uint32_t index = m_Index++;
+			if (m_Count == m_Window) {
+				Sum old = Shifted(m_Values[(index - m_Window) & MASK]);
+				m_Sum -= old;
+				m_SumSquares -= old * old;
+			} else {
+				if (m_Count == 0 && !EXACT)
+					m_Shift = SampleTraits<T>::ToDouble(x);
+				++m_Count;
+			}
+			m_Values[index & MASK] = x;
+			Sum shifted = Shifted(x);
+			m_Sum += shifted;
+			m_SumSquares += shifted * shifted;
+
+			// Expire first so a deque never holds more than the window
+			while (m_MinHead != m_MinTail && index - m_Min[m_MinHead & MASK] >= m_Window)
+				++m_MinHead;
+			while (m_MinTail != m_MinHead && m_Values[m_Min[(m_MinTail - 1) & MASK] & MASK] >= x)
+				--m_MinTail;
+			m_Min[m_MinTail++ & MASK] = index;
+
+			while (m_MaxHead != m_MaxTail && index - m_Max[m_MaxHead & MASK] >= m_Window)
+				++m_MaxHead;
+			while (m_MaxTail != m_MaxHead && m_Values[m_Max[(m_MaxTail - 1) & MASK] & MASK] <= x)
+				--m_MaxTail;
+			m_Max[m_MaxTail++ & MASK] = index;
+
+			if constexpr (!EXACT) {
+				if (++m_SinceRebuild >= m_Window)
+					Rebuild();
+			}
+		}
+
+		void Push(std::span<const T> block) {
+			for (T x : block)
+				Push(x);
+		}
+
+		// Observes the block as a pipeline stage
+		std::size_t Process(std::span<T> block) {
+			Push(std::span<const T>(block));
+			return block.size();
+		}
+
+		std::size_t GetWindow() const { return m_Window; }
+		// Samples in the window, less than the window until it has filled
+		std::size_t GetCount() const { return m_Count; }
+		bool Full() const { return m_Count == m_Window; }
+
+		// Valid once at least one sample was pushed
+		T GetMin() const { return m_Values[m_Min[m_MinHead & MASK] & MASK]; }
+		T GetMax() const { return m_Values[m_Max[m_MaxHead & MASK] & MASK]; }
+
+		double GetMean() const {
+			if (m_Count == 0)
+				return 0.0;
+			return m_Shift + static_cast<double>(m_Sum) / m_Count * SCALE;
+		}
+
+		// Population variance of the window
+		double GetVariance() const {
+			if (m_Count == 0)
+				return 0.0;
+			double n = static_cast<double>(m_Count);
+			double sum = static_cast<double>(m_Sum);
+			double variance = (static_cast<double>(m_SumSquares) - sum * sum / n) / n;
+			return std::max(variance * SCALE * SCALE, 0.0);
+		}
+
+		double GetStdDev() const { return std::sqrt(GetVariance()); }
+
+	private:
+		// Real value of one unit of Sum
+		static constexpr double SCALE = [] {
+			if constexpr (EXACT)
+				return 1.0 / static_cast<double>(T::ONE);
+			else
+				return 1.0;
+		}();
+
+		Sum Shifted(T x) const {
+			if constexpr (EXACT)
+				return x.raw;
+			else
+				return SampleTraits<T>::ToDouble(x) - m_Shift;
+		}
+
+		void Rebuild() {
+			m_SinceRebuild = 0;
+			m_Shift = GetMean();
+			m_Sum = 0.0;
+			m_SumSquares = 0.0;
+			for (uint32_t i = m_Index - m_Count; i != m_Index; ++i) {
+				double shifted = Shifted(m_Values[i & MASK]);
+				m_Sum += shifted;
+				m_SumSquares += shifted * shifted;
+			}
+		}
+
+	private:
+		uint32_t m_Window;
+		// Index of the next sample, indices wrap at 2^32
+		uint32_t m_Index;
+		uint32_t m_Count;
+		std::array<T, Capacity> m_Values;
+
+		// Indices with increasing values from head to tail for the minimum,
+		// decreasing for the maximum
+		std::array<uint32_t, Capacity> m_Min;
+		uint32_t m_MinHead, m_MinTail;
+		std::array<uint32_t, Capacity> m_Max;
+		uint32_t m_MaxHead, m_MaxTail;
+
+		// Always 0 for exact sums
+		double m_Shift;
+		Sum m_Sum;
+		Sum m_SumSquares;
+		uint32_t m_SinceRebuild;
+	};
+}
+}
+
+#endif
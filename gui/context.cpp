@@ -44,32 +44,15 @@ namespace gui {
 	}
 
 	Context::Context(Logger logger)
-	 : m_Logger(logger) {
+	 : m_Logger(logger), m_Layer(0) {
 		 m_FontManager = std::make_unique<font::FontManager>();
 		 m_FontManager->SetDPI(96);
 		 m_Fonts.emplace(m_Fonts.begin(), m_FontManager->CreateFont("/usr/share/fonts/Adwaita/AdwaitaSans-Regular.ttf"));
 
-		glGenBuffers(1, &m_VBO);
-		if (m_VBO == 0) {
-			throw core::InternalError("Failed to create OpenGL vertex buffer object");
-		}
-		glGenBuffers(1, &m_EBO);
-		if (m_EBO == 0) {
-			throw core::InternalError("Failed to create OpenGL index buffer object");
-		}
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-
-		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
 		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
 		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
 		glEnableVertexAttribArray(2);
 
-		glBufferData(GL_ARRAY_BUFFER, BATCH_MAX_VERTICES * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, BATCH_MAX_INDICES * sizeof(int16_t), nullptr, GL_DYNAMIC_DRAW);
-
 		const char *glslVersion = reinterpret_cast<const char *>(glGetString(GL_SHADING_LANGUAGE_VERSION));
 		if (!glslVersion)
 			throw core::InternalError("Failed to get gl shading language version string");
@@ -92,13 +75,26 @@ namespace gui {
 			default:
 				throw core::InternalError(fmt::format("GLSL version not compatible ({})", glslVersion));
 		}
+
+		// Fences and unsynchronized mappings need GLES 3, GLES 2 orphans
+		const bool useFences = ver == GLSL_ES_320;
+		m_VertexStream = std::make_unique<StreamBuffer>(GL_ARRAY_BUFFER,
+				BATCH_MAX_VERTICES * sizeof(Vertex), useFences);
+		m_IndexStream = std::make_unique<StreamBuffer>(GL_ELEMENT_ARRAY_BUFFER,
+				BATCH_MAX_INDICES * sizeof(int16_t), useFences);
+		Log(spdlog::level::debug, "Streaming vertex data {}",
+				m_VertexStream->UsesFences() ? "through fenced mappings" : "by orphaning buffers");
+
 		m_CurrentShader = GuiShader::Flat;
 
 		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		glEnable(GL_BLEND);
 
 		m_Projection = glm::ortho(0.0f, 800.0f, 600.0f, 0.0f);
-		m_ClipStack.emplace();
+		m_Clips.emplace_back();
+		m_ClipStack.push(0);
+		m_BatchVertices.reserve(BATCH_MAX_VERTICES);
+		m_BatchIndices.reserve(BATCH_MAX_INDICES);
 
 		glEnable(GL_SCISSOR_TEST);
 	}
@@ -110,10 +106,8 @@ namespace gui {
 		glUseProgram(GL_NONE);
 		m_QuadFlatShader.reset();
 		m_TextShader.reset();
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-		glDeleteBuffers(1, &m_VBO);
-		glDeleteBuffers(1, &m_EBO);
+		m_VertexStream.reset();
+		m_IndexStream.reset();
 		m_Fonts.clear();
 		m_FontManager.reset();
 	}
@@ -123,7 +117,7 @@ namespace gui {
 			return;
 		m_Viewport = viewport;
 		m_Projection = glm::ortho(0.f, m_Viewport.w, m_Viewport.h, 0.f);
-		Rect &baseClip = m_ClipStack.top();
+		Rect &baseClip = m_Clips[0];
 		baseClip.x = 0;
 		baseClip.y = 0;
 		baseClip.w = viewport.w;
@@ -131,152 +125,172 @@ namespace gui {
 	}
 
 	void Context::PushClip(const Rect &clip) {
-		if (clip != m_ClipStack.top()) {
-			Flush();
-			int l = static_cast<int>(std::floor(clip.x));
-			int r = static_cast<int>(std::ceil(clip.x + clip.w));
-			int t = static_cast<int>(std::floor(clip.y));
-			int b = static_cast<int>(std::ceil(clip.y + clip.h));
-			glScissor(l, m_Viewport.h - b, r - l, b - t);
+		if (clip == m_Clips[m_ClipStack.top()]) {
+			m_ClipStack.push(m_ClipStack.top());
+			return;
 		}
-		m_ClipStack.push(clip);
+		m_ClipStack.push(static_cast<uint32_t>(m_Clips.size()));
+		m_Clips.push_back(clip);
 	}
 
 	void Context::PopClip() {
-		Rect currentClip = m_ClipStack.top();
 		m_ClipStack.pop();
-		Rect prevClip = m_ClipStack.top();
-		if (currentClip != prevClip) {
-			Flush();
-			int l = static_cast<int>(std::floor(prevClip.x));
-			int r = static_cast<int>(std::ceil(prevClip.x + prevClip.w));
-			int t = static_cast<int>(std::floor(prevClip.y));
-			int b = static_cast<int>(std::ceil(prevClip.y + prevClip.h));
-			glScissor(l, m_Viewport.h - b, r - l, b - t);
-		}
+	}
+
+	void Context::PushLayer() {
+		if (m_Layer < UINT16_MAX)
+			++m_Layer;
+	}
+
+	void Context::PopLayer() {
+		if (m_Layer > 0)
+			--m_Layer;
 	}
 
 	void Context::PushTransform(const Size &transform) {
-		// Flush();
 		m_TransformStack.push(transform);
 		// TODO:
 	}
 
 	void Context::PopTransform() {
-		// Flush();
 		m_TransformStack.pop();
 	}
 
+	uint64_t Context::MakeKey(GuiShader shader, font::AtlasPageID atlasId) const {
+		// Layer first so overlapping layers keep their order, then
+		// whatever is most expensive to switch between draws
+		return (static_cast<uint64_t>(m_Layer) << 48) |
+			(static_cast<uint64_t>(shader) << 40) |
+			(static_cast<uint64_t>(static_cast<uint16_t>(atlasId + 1)) << 24) |
+			(m_ClipStack.top() & 0xFFFFFF);
+	}
+
+	Context::Primitive Context::Record(uint64_t key, int vertexCount, int indexCount) {
+		if (m_Commands.empty() || m_Commands.back().key != key ||
+				m_Commands.back().vertexCount + vertexCount > BATCH_MAX_VERTICES ||
+				m_Commands.back().indexCount + indexCount > BATCH_MAX_INDICES) {
+			m_Commands.push_back({
+				key,
+				static_cast<uint32_t>(m_Vertices.size()), 0,
+				static_cast<uint32_t>(m_Indices.size()), 0
+			});
+		}
+		DrawCommand &command = m_Commands.back();
+		Primitive primitive;
+		primitive.base = static_cast<int16_t>(command.vertexCount);
+		m_Vertices.resize(m_Vertices.size() + vertexCount);
+		m_Indices.resize(m_Indices.size() + indexCount);
+		primitive.vertices = m_Vertices.data() + command.firstVertex + command.vertexCount;
+		primitive.indices = m_Indices.data() + command.firstIndex + command.indexCount;
+		command.vertexCount += vertexCount;
+		command.indexCount += indexCount;
+		return primitive;
+	}
+
+	static void QuadIndices(int16_t *indices, int16_t base) {
+		indices[0] = base;
+		indices[1] = base + 1;
+		indices[2] = base + 2;
+		indices[3] = base + 2;
+		indices[4] = base + 3;
+		indices[5] = base;
+	}
+
 	void Context::DrawTriangle(const Point &a, const Point &b, const Point &c, const Color &color)
 	{
-		if (m_Triangles.vertexCount + 3 > BATCH_MAX_VERTICES) {
-			FlushTriangles();
-		}
-		m_Triangles.vertices[m_Triangles.vertexCount++] = {
+		Primitive p = Record(MakeKey(m_CurrentShader), 3, 3);
+		p.vertices[0] = {
 			{ a.x, a.y, 0.0f, 1.0f },
 			color,
 			{ 0.f, 0.f }
 		};
-		m_Triangles.vertices[m_Triangles.vertexCount++] = {
+		p.vertices[1] = {
 			{ b.x, b.y, 0.0f, 1.0f },
 			color,
 			{ 0.f, 0.f }
 		};
-		m_Triangles.vertices[m_Triangles.vertexCount++] = {
+		p.vertices[2] = {
 			{ c.x, c.y, 0.0f, 1.0f },
 			color,
 			{ 0.f, 0.f }
 		};
-		m_Triangles.indices[m_Triangles.indexCount++] = m_Triangles.vertexCount - 3;
-		m_Triangles.indices[m_Triangles.indexCount++] = m_Triangles.vertexCount - 2;
-		m_Triangles.indices[m_Triangles.indexCount++] = m_Triangles.vertexCount - 1;
+		p.indices[0] = p.base;
+		p.indices[1] = p.base + 1;
+		p.indices[2] = p.base + 2;
 	}
 
 	void Context::DrawRect(const Rect& rect, const Color& color) {
-		if (m_Rects.vertexCount + 4 > BATCH_MAX_VERTICES) {
-			FlushRects();
-		}
-		m_Rects.vertices[m_Rects.vertexCount++] = {
+		Primitive p = Record(MakeKey(m_CurrentShader), 4, 6);
+		p.vertices[0] = {
 			{ rect.x, rect.y, 0.0f, 1.0f },
 			color,
 			{ 0.f, 0.f }
 		};
-		m_Rects.vertices[m_Rects.vertexCount++] = {
+		p.vertices[1] = {
 			{ rect.x + rect.w, rect.y, 0.0f, 1.0f },
 			color,
 			{ 0.f, 0.f }
 		};
-		m_Rects.vertices[m_Rects.vertexCount++] = {
+		p.vertices[2] = {
 			{ rect.x + rect.w, rect.y + rect.h, 0.0f, 1.0f },
 			color,
 			{ 0.f, 0.f }
 		};
-		m_Rects.vertices[m_Rects.vertexCount++] = {
+		p.vertices[3] = {
 			{ rect.x, rect.y + rect.h, 0.0f, 1.0f },
 			color,
 			{ 0.f, 0.f }
 		};
-		m_Rects.indices[m_Rects.indexCount++] = m_Rects.vertexCount - 4;
-		m_Rects.indices[m_Rects.indexCount++] = m_Rects.vertexCount - 3;
-		m_Rects.indices[m_Rects.indexCount++] = m_Rects.vertexCount - 2;
-		m_Rects.indices[m_Rects.indexCount++] = m_Rects.vertexCount - 2;
-		m_Rects.indices[m_Rects.indexCount++] = m_Rects.vertexCount - 1;
-		m_Rects.indices[m_Rects.indexCount++] = m_Rects.vertexCount - 4;
+		QuadIndices(p.indices, p.base);
 	}
 
 	void Context::DrawLine(const Point &p1, const Point &p2, float width, const Color &color)
 	{
 		if (p1.x == p2.x && p1.y == p2.y)
 			return;
-		if (m_Lines.vertexCount + 4 > BATCH_MAX_VERTICES)
-			FlushLines();
 
 		glm::vec2 dir = glm::normalize(p2.vec() - p1.vec());
 		glm::vec2 normal = glm::vec2(-dir.y, dir.x) * width * 0.5f;
-		m_Lines.vertices[m_Lines.vertexCount++] = {
+		Primitive p = Record(MakeKey(m_CurrentShader), 4, 6);
+		p.vertices[0] = {
 			{ p1.vec() + normal, 0.0f, 1.0f },
 			color,
 			{ 0.f, 0.f }
 		};
-		m_Lines.vertices[m_Lines.vertexCount++] = {
+		p.vertices[1] = {
 			{ p2.vec() + normal, 0.0f, 1.0f },
 			color,
 			{ 0.f, 0.f }
 		};
-		m_Lines.vertices[m_Lines.vertexCount++] = {
+		p.vertices[2] = {
 			{ p2.vec() - normal, 0.0f, 1.0f },
 			color,
 			{ 0.f, 0.f }
 		};
-		m_Lines.vertices[m_Lines.vertexCount++] = {
+		p.vertices[3] = {
 			{ p1.vec() - normal, 0.0f, 1.0f },
 			color,
 			{ 0.f, 0.f }
 		};
-		m_Lines.indices[m_Lines.indexCount++] = m_Lines.vertexCount - 4;
-		m_Lines.indices[m_Lines.indexCount++] = m_Lines.vertexCount - 3;
-		m_Lines.indices[m_Lines.indexCount++] = m_Lines.vertexCount - 2;
-		m_Lines.indices[m_Lines.indexCount++] = m_Lines.vertexCount - 2;
-		m_Lines.indices[m_Lines.indexCount++] = m_Lines.vertexCount - 1;
-		m_Lines.indices[m_Lines.indexCount++] = m_Lines.vertexCount - 4;
+		QuadIndices(p.indices, p.base);
 	}
 
-	void Context::DrawPolyLine(std::span<const Point> inputPoints, float width, const Color &color) {
+	void Context::DrawPolyLine(std::span<const Point> inputPoints, float width, const Color &color,
+			const PointTransform &transform) {
 		if (inputPoints.size() < 2)
 			return;
 		if (inputPoints.size() < 3) {
-			DrawLine(inputPoints[0], inputPoints[1], width, color);
+			glm::vec2 p1 = transform.Apply(inputPoints[0]);
+			glm::vec2 p2 = transform.Apply(inputPoints[1]);
+			DrawLine({ p1.x, p1.y }, { p2.x, p2.y }, width, color);
 			return;
 		}
-		if ((inputPoints.size() - 1) * 6 + m_Lines.indexCount > BATCH_MAX_INDICES) {
-			FlushLines();
-		}
 		if (((inputPoints.size() - 1) * 6) > BATCH_MAX_INDICES) {
 			for (std::size_t i = 0; i < inputPoints.size(); i += BATCH_MAX_INDICES / 6) {
 				DrawPolyLine(std::span(inputPoints.begin() + i,
 							inputPoints.begin() + i + std::clamp(BATCH_MAX_INDICES / 6ul + 1,
 								0ul, inputPoints.size() - i)),
-							width, color);
+							width, color, transform);
 			}
 			return;
 		}
@@ -285,15 +299,20 @@ namespace gui {
 		std::vector<glm::vec2> points;
 		points.reserve(inputPoints.size());
 
-		for (const Point &p : inputPoints) {
+		for (const Point &input : inputPoints) {
+			const glm::vec2 p = transform.Apply(input);
 			if (!points.empty()) {
-				const glm::vec2 delta = glm::vec2{ p.x, p.y } - points.back();
+				const glm::vec2 delta = p - points.back();
 				if (glm::dot(delta, delta) <= 1e-10f)
 					continue;
 			}
-			points.emplace_back(p.x, p.y);
+			points.push_back(p);
 		}
+		if (points.size() < 2)
+			return;
 
+		Primitive p = Record(MakeKey(m_CurrentShader),
+				static_cast<int>(points.size() * 2), static_cast<int>((points.size() - 1) * 6));
 		for (std::size_t i = 0; i < points.size(); ++i) {
 			glm::vec2 offset;
 			if (i == 0) {
@@ -325,93 +344,125 @@ namespace gui {
 				}
 			}
 
-			m_Lines.vertices[m_Lines.vertexCount++] = {
+			p.vertices[i * 2] = {
 				{ points[i] + offset, 0.0f, 1.0f },
 				color,
 				{ 0.f, 0.f }
 			};
-			m_Lines.vertices[m_Lines.vertexCount++] = {
+			p.vertices[i * 2 + 1] = {
 				{ points[i] - offset, 0.0f, 1.0f },
 				color,
 				{ 0.f, 0.f }
 			};
 		}
-		std::size_t vtxOffset = m_Lines.vertexCount - points.size() * 2;
 		for (std::size_t i = 0; i + 1 < points.size(); ++i) {
-			m_Lines.indices[m_Lines.indexCount + 0] = vtxOffset + i * 2;
-			m_Lines.indices[m_Lines.indexCount + 1] = vtxOffset + i * 2 + 1;
-			m_Lines.indices[m_Lines.indexCount + 2] = vtxOffset + (i + 1) * 2;
-			m_Lines.indices[m_Lines.indexCount + 3] = vtxOffset + (i + 1) * 2;
-			m_Lines.indices[m_Lines.indexCount + 4] = vtxOffset + i * 2 + 1;
-			m_Lines.indices[m_Lines.indexCount + 5] = vtxOffset + (i + 1) * 2 + 1;
-			m_Lines.indexCount += 6;
+			int16_t *indices = p.indices + i * 6;
+			indices[0] = p.base + i * 2;
+			indices[1] = p.base + i * 2 + 1;
+			indices[2] = p.base + (i + 1) * 2;
+			indices[3] = p.base + (i + 1) * 2;
+			indices[4] = p.base + i * 2 + 1;
+			indices[5] = p.base + (i + 1) * 2 + 1;
 		}
 	}
 
 	void Context::DrawGlyph(const Point &origin, const Color& color, const font::Glyph &glyph) {
-		TextBatch *batch = nullptr;
-		for (auto& b : m_Text) {
-			if (b.atlasId == glyph.atlasId) {
-				batch = &b;
-				break;
-			}
-		}
-		if (batch == nullptr) {
-			batch = &m_Text.emplace_back();
-			batch->atlasId = glyph.atlasId;
-		}
 		const font::AtlasPage& atlas = m_FontManager->GetAtlasPage(glyph.atlasId);
-		if (batch->vertexCount + 4 > BATCH_MAX_VERTICES) {
-			FlushText(m_Text[glyph.atlasId]);
-		}
 		float x0 = origin.x + glyph.bearingX;
 		float y0 = origin.y - glyph.bearingY;
 		float x1 = x0 + glyph.width;
 		float y1 = y0 + glyph.height;
-		batch->vertices[batch->vertexCount++] = {
+		Primitive p = Record(MakeKey(GuiShader::Texture, glyph.atlasId), 4, 6);
+		p.vertices[0] = {
 			{ x0, y0, 0.0f, 1.0f },
 			color,
 			{ (float)glyph.atlasX / (float)atlas.width, (float)glyph.atlasY / (float)atlas.height }
 		};
-		batch->vertices[batch->vertexCount++] = {
+		p.vertices[1] = {
 			{ x1, y0, 0.0f, 1.0f },
 			color,
 			{ (float)(glyph.atlasX + glyph.width) / (float)atlas.width, (float)glyph.atlasY / (float)atlas.height }
 		};
-		batch->vertices[batch->vertexCount++] = {
+		p.vertices[2] = {
 			{ x1, y1, 0.0f, 1.0f },
 			color,
 			{ (float)(glyph.atlasX + glyph.width) / (float)atlas.width, (float)(glyph.atlasY + glyph.height) / (float)atlas.height }
 		};
-		batch->vertices[batch->vertexCount++] = {
+		p.vertices[3] = {
 			{ x0, y1, 0.0f, 1.0f },
 			color,
 			{ (float)glyph.atlasX / (float)atlas.width, (float)(glyph.atlasY + glyph.height) / (float)atlas.height }
 		};
-		batch->indices[batch->indexCount++] = batch->vertexCount - 4;
-		batch->indices[batch->indexCount++] = batch->vertexCount - 3;
-		batch->indices[batch->indexCount++] = batch->vertexCount - 2;
-		batch->indices[batch->indexCount++] = batch->vertexCount - 2;
-		batch->indices[batch->indexCount++] = batch->vertexCount - 1;
-		batch->indices[batch->indexCount++] = batch->vertexCount - 4;
+		QuadIndices(p.indices, p.base);
 	}
 
 	void Context::Flush() {
-		PROFILE_SCOPE("GUI flush buffers");
-		FlushTriangles();
-		FlushRects();
-		FlushLines();
-		FlushText();
+		PROFILE_SCOPE("GUI flush draw list");
+		if (m_Commands.empty())
+			return;
+
+		// Equal keys keep the order they were recorded in
+		std::stable_sort(m_Commands.begin(), m_Commands.end(),
+				[](const DrawCommand &a, const DrawCommand &b) { return a.key < b.key; });
+
+		// Sorted by layer first, neighbours with the same state can share a
+		// draw even across a layer boundary
+		constexpr uint64_t STATE_MASK = (uint64_t(1) << 48) - 1;
+		int boundShader = -1;
+		int boundAtlas = -1;
+		uint32_t boundClip = UINT32_MAX;
+		for (std::size_t i = 0; i < m_Commands.size();) {
+			const uint64_t state = m_Commands[i].key & STATE_MASK;
+			m_BatchVertices.clear();
+			m_BatchIndices.clear();
+			for (; i < m_Commands.size() && (m_Commands[i].key & STATE_MASK) == state; ++i) {
+				const DrawCommand &command = m_Commands[i];
+				if (m_BatchVertices.size() + command.vertexCount > BATCH_MAX_VERTICES ||
+						m_BatchIndices.size() + command.indexCount > BATCH_MAX_INDICES)
+					break;
+				const int16_t base = static_cast<int16_t>(m_BatchVertices.size());
+				m_BatchVertices.insert(m_BatchVertices.end(),
+						m_Vertices.begin() + command.firstVertex,
+						m_Vertices.begin() + command.firstVertex + command.vertexCount);
+				for (uint32_t k = 0; k < command.indexCount; ++k)
+					m_BatchIndices.push_back(base + m_Indices[command.firstIndex + k]);
+			}
+
+			const int shader = static_cast<int>((state >> 40) & 0xFF);
+			const int atlasId = static_cast<int>((state >> 24) & 0xFFFF) - 1;
+			const uint32_t clip = static_cast<uint32_t>(state & 0xFFFFFF);
+			if (shader != boundShader) {
+				if (static_cast<GuiShader>(shader) == GuiShader::Texture)
+					m_TextShader->Bind();
+				else
+					m_QuadFlatShader->Bind();
+				boundShader = shader;
+			}
+			if (atlasId >= 0 && atlasId != boundAtlas) {
+				BindAtlasTexture(atlasId);
+				boundAtlas = atlasId;
+			}
+			if (clip != boundClip) {
+				SetScissor(m_Clips[clip]);
+				boundClip = clip;
+			}
+
+			DrawBatch(m_BatchVertices.data(), static_cast<int>(m_BatchVertices.size()),
+					m_BatchIndices.data(), static_cast<int>(m_BatchIndices.size()));
+		}
+
+		m_Commands.clear();
+		m_Vertices.clear();
+		m_Indices.clear();
+		// Clip indices still on the stack must stay valid
+		if (m_ClipStack.size() == 1)
+			m_Clips.resize(1);
 	}
 
 	void Context::UseShader(GuiShader shader) {
-		Flush();
 		switch (shader) {
 			case GuiShader::Flat:
-				m_QuadFlatShader->Bind();
-				break;
 			case GuiShader::Texture:
-				m_TextShader->Bind();
 				break;
 			default:
 				throw core::InternalError("Unknown shader");
@@ -420,6 +471,8 @@ namespace gui {
 	}
 
 	void Context::SetUniform(GuiShader shader, const std::string& name, const glm::mat4& value) {
+		// Recorded primitives were meant to be drawn with the old value
+		Flush();
 		switch (shader) {
 			case GuiShader::Flat:
 				m_QuadFlatShader->Bind();
@@ -432,86 +485,38 @@ namespace gui {
 			default:
 				throw core::InternalError("Unknown shader");
 		}
-		UseShader(m_CurrentShader);
-	}
-
-	void Context::FlushTriangles() {
-		PROFILE_SCOPE("GUI draw triangles");
-		if (m_Triangles.indexCount == 0)
-			return;
-
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, m_Triangles.vertexCount * sizeof(Vertex), m_Triangles.vertices.data());
-		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, m_Triangles.indexCount * sizeof(int16_t), m_Triangles.indices.data());
-		glDrawElements(GL_TRIANGLES, m_Triangles.indexCount, GL_UNSIGNED_SHORT, nullptr);
-
-		m_Triangles.vertexCount = 0;
-		m_Triangles.indexCount = 0;
 	}
 
-	void Context::FlushRects() {
-		PROFILE_SCOPE("GUI draw rects");
-		if (m_Rects.indexCount == 0)
-			return;
-
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, m_Rects.vertexCount * sizeof(Vertex), m_Rects.vertices.data());
-		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, m_Rects.indexCount * sizeof(int16_t), m_Rects.indices.data());
-		glDrawElements(GL_TRIANGLES, m_Rects.indexCount, GL_UNSIGNED_SHORT, nullptr);
-
-		m_Rects.vertexCount = 0;
-		m_Rects.indexCount = 0;
-	}
-
-	void Context::FlushLines() {
-		PROFILE_SCOPE("GUI draw lines");
-		if (m_Lines.indexCount == 0)
-			return;
-
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, m_Lines.vertexCount * sizeof(Vertex), m_Lines.vertices.data());
-		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, m_Lines.indexCount * sizeof(int16_t), m_Lines.indices.data());
-		glDrawElements(GL_TRIANGLES, m_Lines.indexCount, GL_UNSIGNED_SHORT, nullptr);
-
-		m_Lines.vertexCount = 0;
-		m_Lines.indexCount = 0;
-	}
+	void Context::DrawBatch(const Vertex *vertices, int vertexCount, const int16_t *indices, int indexCount) {
+		// Indices are relative to the batch, so the attributes start at
+		// wherever its vertices landed in the stream
+		std::size_t vertexOffset = m_VertexStream->Write(vertices, vertexCount * sizeof(Vertex));
+		std::size_t indexOffset = m_IndexStream->Write(indices, indexCount * sizeof(int16_t));
 
-	void Context::FlushText() {
-		PROFILE_SCOPE("GUI draw text");
-		for (auto& batch : m_Text) {
-			FlushText(batch);
-		}
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(vertexOffset + offsetof(Vertex, position)));
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(vertexOffset + offsetof(Vertex, color)));
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(vertexOffset + offsetof(Vertex, uv)));
+		glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, (void*)indexOffset);
 	}
 
-	void Context::FlushText(TextBatch& batch) {
-		PROFILE_SCOPE_UNNAMED();
-		if (batch.indexCount == 0)
-			return;
-
-		auto it = m_TextTextures.begin();
-		for (; it != m_TextTextures.end(); it++) {
-			if (it->atlasId == batch.atlasId) {
-				if (m_FontManager->GetAtlasPage(batch.atlasId).version != it->atlasVersion)
-					InvalidateAtlasTexture(*it);
-				glBindTexture(GL_TEXTURE_2D, it->name);
-				break;
+	void Context::BindAtlasTexture(font::AtlasPageID id) {
+		for (auto& tex : m_TextTextures) {
+			if (tex.atlasId == id) {
+				glBindTexture(GL_TEXTURE_2D, tex.name);
+				if (m_FontManager->GetAtlasPage(id).version != tex.atlasVersion)
+					InvalidateAtlasTexture(tex);
+				return;
 			}
 		}
-		if (it == m_TextTextures.end())
-			m_TextTextures.emplace_back(CreateAtlasTexture(batch.atlasId));
-
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, batch.vertexCount * sizeof(Vertex), batch.vertices.data());
-		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, batch.indexCount * sizeof(int16_t), batch.indices.data());
-		glDrawElements(GL_TRIANGLES, batch.indexCount, GL_UNSIGNED_SHORT, nullptr);
+		m_TextTextures.emplace_back(CreateAtlasTexture(id));
+	}
 
-		batch.vertexCount = 0;
-		batch.indexCount = 0;
+	void Context::SetScissor(const Rect &clip) {
+		int l = static_cast<int>(std::floor(clip.x));
+		int r = static_cast<int>(std::ceil(clip.x + clip.w));
+		int t = static_cast<int>(std::floor(clip.y));
+		int b = static_cast<int>(std::ceil(clip.y + clip.h));
+		glScissor(l, m_Viewport.h - b, r - l, b - t);
 	}
 
 	Context::AtlasTexture Context::CreateAtlasTexture(font::AtlasPageID id) {
@@ -21,6 +21,7 @@
 
 #include <cee/gui/object.h>
 #include <shaders.h>
+#include <streamBuffer.h>
 
 #include <cee/core/except.h>
 
@@ -31,10 +32,12 @@
 #include <glad/gl.h>
 #include <glm/glm.hpp>
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <stack>
 #include <unordered_map>
+#include <vector>
 
 namespace cee {
 namespace gui {
@@ -47,6 +50,14 @@ namespace gui {
 		glm::vec2 uv;
 	};
 
+	// Per axis scale and offset, applied to points before they are drawn
+	struct PointTransform {
+		float sx = 1.f, sy = 1.f;
+		float tx = 0.f, ty = 0.f;
+
+		glm::vec2 Apply(const Point &p) const { return { p.x * sx + tx, p.y * sy + ty }; }
+	};
+
 	class Context {
 	public:
 		enum class GuiShader {
@@ -62,20 +73,31 @@ namespace gui {
 
 		void PushClip(const Rect &clip);
 		void PopClip();
+		// Primitives on a higher layer are drawn over those below it.
+		// Within a layer they are sorted by state and may be reordered
+		void PushLayer();
+		void PopLayer();
 		void PushTransform(const Size &transform);
 		void PopTransform();
 
 		void DrawTriangle(const Point &a, const Point &b, const Point &c, const Color &color);
 		void DrawRect(const Rect &rect, const Color &color);
 		void DrawLine(const Point &p1, const Point &p2, float width, const Color &color);
-		void DrawPolyLine(std::span<const Point> points, float width, const Color &color);
-		void DrawPolyLine(const std::vector<Point> &points, float width, const Color &color) {
-			DrawPolyLine(std::span(points.cbegin(), points.cend()), width, color);
+		// Points are mapped through transform first, the line width is in
+		// screen space regardless
+		void DrawPolyLine(std::span<const Point> points, float width, const Color &color,
+				const PointTransform &transform = {});
+		void DrawPolyLine(const std::vector<Point> &points, float width, const Color &color,
+				const PointTransform &transform = {}) {
+			DrawPolyLine(std::span(points.cbegin(), points.cend()), width, color, transform);
 		}
 		void DrawGlyph(const Point &origin, const Color& color, const font::Glyph &glyph);
 		void DrawText(const std::string &text, const Point &position, const Color &color);
+		// Sorts what was recorded since the last flush and draws it
 		void Flush();
 
+		// Shader for the primitives recorded after it, glyphs always use
+		// the texture shader
 		void UseShader(GuiShader shader);
 		void SetUniform(GuiShader shader, const std::string &name, const glm::mat4 &value);
 
@@ -95,34 +117,26 @@ namespace gui {
 		}
 
 	private:
-		struct TriangleBatch {
-			std::array<Vertex, BATCH_MAX_VERTICES> vertices;
-			std::array<int16_t, BATCH_MAX_VERTICES> indices;
-			int vertexCount = 0;
-			int indexCount = 0;
+		/*
+		 * A run of primitives recorded under one state. Its vertices and
+		 * indices are contiguous in the frame's streams, indices relative
+		 * to firstVertex.
+		 */
+		struct DrawCommand {
+			uint64_t key;
+			uint32_t firstVertex;
+			uint32_t vertexCount;
+			uint32_t firstIndex;
+			uint32_t indexCount;
 		};
 
-		struct RectBatch {
-			std::array<Vertex, BATCH_MAX_VERTICES> vertices;
-			std::array<int16_t, (BATCH_MAX_VERTICES*6)/4> indices;
-			int vertexCount = 0;
-			int indexCount = 0;
+		// Room for one primitive, indices are offset by base
+		struct Primitive {
+			Vertex *vertices;
+			int16_t *indices;
+			int16_t base;
 		};
 
-		struct LineBatch {
-			std::array<Vertex, BATCH_MAX_VERTICES> vertices;
-			std::array<int16_t, (BATCH_MAX_VERTICES*6)/4> indices;
-			int vertexCount = 0;
-			int indexCount = 0;
-		};
-
-		struct TextBatch {
-			font::AtlasPageID atlasId;
-			std::array<Vertex, BATCH_MAX_VERTICES> vertices;
-			std::array<int16_t, (BATCH_MAX_VERTICES*6)/4> indices;
-			int vertexCount = 0;
-			int indexCount = 0;
-		};
 		struct AtlasTexture {
 			int atlasId;
 			int atlasVersion;
@@ -131,11 +145,11 @@ namespace gui {
 
 	private:
 		GLint GetUniformLocation(const std::string& name);
-		void FlushTriangles();
-		void FlushRects();
-		void FlushLines();
-		void FlushText();
-		void FlushText(TextBatch& batch);
+		uint64_t MakeKey(GuiShader shader, font::AtlasPageID atlasId = -1) const;
+		Primitive Record(uint64_t key, int vertexCount, int indexCount);
+		void DrawBatch(const Vertex *vertices, int vertexCount, const int16_t *indices, int indexCount);
+		void BindAtlasTexture(font::AtlasPageID id);
+		void SetScissor(const Rect &clip);
 		AtlasTexture CreateAtlasTexture(font::AtlasPageID id);
 		void InvalidateAtlasTexture(AtlasTexture& tex);
 
@@ -146,18 +160,24 @@ namespace gui {
 		std::unique_ptr<font::FontManager> m_FontManager;
 		std::vector<std::shared_ptr<font::Font>> m_Fonts;
 		uint32_t m_FontTexture;
-		uint32_t m_VBO, m_EBO;
+		std::unique_ptr<StreamBuffer> m_VertexStream;
+		std::unique_ptr<StreamBuffer> m_IndexStream;
 		GuiShader m_CurrentShader;
 		Size m_Viewport;
 		glm::mat4 m_Projection;
 		std::unordered_map<std::string, GLint> m_UniformLocations;
-		TriangleBatch m_Triangles;
-		RectBatch m_Rects;
-		LineBatch m_Lines;
-		std::vector<TextBatch> m_Text;
+		std::vector<DrawCommand> m_Commands;
+		std::vector<Vertex> m_Vertices;
+		std::vector<int16_t> m_Indices;
+		std::vector<Vertex> m_BatchVertices;
+		std::vector<int16_t> m_BatchIndices;
 		std::vector<AtlasTexture> m_TextTextures;
 		std::stack<Size> m_TransformStack;
-		std::stack<Rect> m_ClipStack;
+		// Clip rects used since the last flush, the stack holds indices
+		// into it and index 0 is the viewport
+		std::vector<Rect> m_Clips;
+		std::stack<uint32_t> m_ClipStack;
+		uint16_t m_Layer;
 	};
 }
 }
@@ -23,6 +23,19 @@
 
 namespace cee {
 namespace gui {
+	/*
+	 * Line plot of a buffer of samples. Points are kept in data space, one
+	 * per sample, and mapped into the widget by a transform when drawn, so
+	 * changing the data only touches the changed points and changing the
+	 * range touches none.
+	 *
+	 * The vertical range is fixed ([0, 1] by default) or follows the
+	 * extrema of the visible data when auto range is enabled. The owner
+	 * reports the extrema, typically from rolling statistics it already
+	 * keeps, and the plot only moves its range once the data leaves it or
+	 * shrinks well inside it, easing towards the new range over a few
+	 * frames.
+	 */
 	class Plot : public Widget {
 	protected:
 		Plot();
@@ -30,12 +43,34 @@ namespace gui {
 		Plot(const Color &color);
 		Plot(const float *data, std::size_t count, const Color &color);
 
+	public:
+
+		// Fraction of the range left free above and below the data
+		static constexpr float AUTO_RANGE_MARGIN = 0.1f;
+		// The range is narrowed once the data spans less than this much of it
+		static constexpr float AUTO_RANGE_SHRINK = 0.5f;
+		// Per frame easing towards a wider and a narrower range
+		static constexpr float AUTO_RANGE_EXPAND_RATE = 0.3f;
+		static constexpr float AUTO_RANGE_SHRINK_RATE = 0.05f;
+
 	public:
 
 		void SetColor(const Color &color) { m_Color = color; }
 		void SetData(const float *data, std::size_t count, std::size_t offset = 0);
-		void ClearData() { m_Data.clear(); m_Points.clear(); }
-		void ResizeData(std::size_t size) { m_Data.resize(size); m_DataStale = true; }
+		void ClearData() { m_Points.clear(); }
+		void ResizeData(std::size_t size);
+
+		// Fixed vertical range, disables auto range
+		void SetRange(float min, float max);
+		void SetAutoRange(bool enable) { m_AutoRange = enable; }
+		bool IsAutoRange() const { return m_AutoRange; }
+		// Extrema of the visible data, used by auto range
+		void SetExtrema(float min, float max);
+		// Smallest span auto range zooms in to, so noise on a flat signal
+		// is not blown up to full height
+		void SetMinimumSpan(float span) { m_MinimumSpan = span; }
+		float GetRangeMin() const { return m_RangeMin; }
+		float GetRangeMax() const { return m_RangeMax; }
 
 		void SetLineBreakPos(size_t pos) { m_LineBreakPos = pos; }
 		void SetLineBreakWidth(size_t width) { m_LineBreakWidth = width; }
@@ -50,17 +85,25 @@ namespace gui {
 		virtual bool CanHaveChildren() const override { return false; }
 
 	private:
-		static std::vector<Point> &PlotPoints(Plot *o,
-				const std::vector<float> &data,
-				std::vector<Point> &points, size_t lineBreak = 0);
+		void UpdateAutoRange();
 
 	private:
 		size_t m_LineBreakPos = 0;
 		size_t m_LineBreakWidth = 4;
-		std::vector<float> m_Data;
+		// { sample index, value }
 		std::vector<Point> m_Points;
 		Color m_Color;
-		bool m_DataStale = true;
+
+		bool m_AutoRange = false;
+		bool m_HaveExtrema = false;
+		float m_ExtremaMin = 0.f;
+		float m_ExtremaMax = 1.f;
+		float m_MinimumSpan = 0.f;
+		// Range auto range is easing towards
+		float m_TargetMin = 0.f;
+		float m_TargetMax = 1.f;
+		float m_RangeMin = 0.f;
+		float m_RangeMax = 1.f;
 
 	public:
 		template<typename T, typename ...Args>
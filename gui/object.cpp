@@ -54,6 +54,8 @@ namespace gui {
 		if (!m_Enabled)
 			return;
 
+		// Children are drawn over their parent
+		ctx->PushLayer();
 		if (m_ShouldShow) {
 			if (obj.HasClip()) {
 				auto clip = obj.Clip();
@@ -75,6 +77,7 @@ namespace gui {
 				ctx->PopClip();
 			}
 		}
+		ctx->PopLayer();
 	}
 
 
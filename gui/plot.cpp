@@ -20,87 +20,76 @@
 #include <object_impl.h>
 
 #include <algorithm>
+#include <cmath>
 
 namespace cee {
 namespace gui {
-	constexpr float map(float n, float oldMin, float oldMax, float newMin, float newMax) {
-		return ((newMax - newMin) * ((n - oldMin) / (oldMax - oldMin))) + newMin;
+	Plot::Plot()
+	 : m_Color({ 1.f, 1.f, 1.f, 1.f }) {
 	}
 
-	constexpr size_t map(size_t n, size_t oldMin, size_t oldMax, size_t newMin, size_t newMax) {
-		return (static_cast<float>(newMax - newMin) * (static_cast<float>(n - oldMin) /
-					static_cast<float>(oldMax - oldMin))) + newMin;
+	Plot::Plot(const float *data, std::size_t count)
+	 : m_Color({ 1.f, 1.f, 1.f, 1.f }) {
+		SetData(data, count);
 	}
 
-	constexpr int map(int n, int oldMin, int oldMax, int newMin, int newMax) {
-		return (static_cast<float>(newMax - newMin) * (static_cast<float>(n - oldMin) /
-					static_cast<float>(oldMax - oldMin))) + newMin;
+	Plot::Plot(const Color &color)
+	 : m_Color(color) {
 	}
 
-	std::vector<Point> &Plot::PlotPoints(Plot *o,
-			const std::vector<float> &data,
-			std::vector<Point> &points, size_t lineBreak) {
-		if (data.size() == 0)
-			return points;
-
-
-		Point p1, p2;
-		float xMin = o->m_Impl->m_AbsoluteRect.x;
-		float xMax = o->m_Impl->m_AbsoluteRect.x + o->m_Impl->m_AbsoluteRect.w;
-		float yMin = o->m_Impl->m_AbsoluteRect.y;
-		float yMax = o->m_Impl->m_AbsoluteRect.y + o->m_Impl->m_AbsoluteRect.h;
-
-		if (data.size() > ((xMax - xMin) * 4))
-			throw GUIError(o->GetDebugName(), "Cannot render large buffers yet");
-
-		p1.x = map(static_cast<std::size_t>(std::floor(xMin)),
-				0ul, data.size(),
-				static_cast<size_t>(std::floor(xMin)),
-				static_cast<size_t>(std::ceil(xMax)));
-		p1.y = map(data[0],
-				0.f, 1.f,
-				std::ceil(yMax), std::floor(yMin));
-
-		points.clear();
-		points.reserve(data.size());
-		for (std::size_t i = 1; i < data.size(); ++i) {
-			p2.x = map(i,
-					0ul, data.size(),
-					static_cast<size_t>(std::floor(xMin)),
-					static_cast<size_t>(std::ceil(xMax)));
-			p2.y = map(data[i],
-					0.f, 1.f,
-					yMax, yMin);
-
-			points.push_back(p1);
-			p1.x = p2.x;
-			p1.y = p2.y;
-		}
-
-		return points;
+	Plot::Plot(const float *data, std::size_t count, const Color &color)
+	 : m_Color(color) {
+		SetData(data, count);
 	}
 
-	Plot::Plot()
-	 : m_Color({ 1.f, 1.f, 1.f, 1.f }) {
+	void Plot::SetData(const float *data, std::size_t count, std::size_t offset) {
+		if (offset + count > m_Points.size())
+			ResizeData(offset + count);
+		for (std::size_t i = 0; i < count; ++i)
+			m_Points[offset + i].y = data[i];
 	}
 
-	Plot::Plot(const float *data, std::size_t count)
-	 : m_Data(data, data + count), m_Color({ 1.f, 1.f, 1.f, 1.f }) {
+	void Plot::ResizeData(std::size_t size) {
+		std::size_t old = m_Points.size();
+		m_Points.resize(size);
+		for (std::size_t i = old; i < size; ++i)
+			m_Points[i] = { static_cast<float>(i), 0.f };
 	}
 
-	Plot::Plot(const Color &color)
-	 : m_Color(color) {
+	void Plot::SetRange(float min, float max) {
+		m_AutoRange = false;
+		m_RangeMin = m_TargetMin = min;
+		m_RangeMax = m_TargetMax = max;
 	}
 
-	Plot::Plot(const float *data, std::size_t count, const Color &color)
-	 : m_Data(data, data + count), m_Color(color) {
+	void Plot::SetExtrema(float min, float max) {
+		m_ExtremaMin = min;
+		m_ExtremaMax = max;
+		m_HaveExtrema = true;
 	}
 
-	void Plot::SetData(const float *data, std::size_t count, std::size_t offset) {
-		if (offset + count > m_Data.size())
-			m_Data.resize(offset + count);
-		std::copy_n(data, count, m_Data.begin() + offset);
-		m_DataStale = true;
+	void Plot::UpdateAutoRange() {
+		if (!m_AutoRange || !m_HaveExtrema)
+			return;
+
+		float span = std::max(m_ExtremaMax - m_ExtremaMin, m_MinimumSpan);
+		float targetSpan = m_TargetMax - m_TargetMin;
+		// Hysteresis, the target only moves once the data leaves it or
+		// takes up too little of it
+		if (m_ExtremaMin < m_TargetMin || m_ExtremaMax > m_TargetMax ||
+				span < AUTO_RANGE_SHRINK * targetSpan) {
+			float mid = 0.5f * (m_ExtremaMin + m_ExtremaMax);
+			float half = 0.5f * span * (1.f + 2.f * AUTO_RANGE_MARGIN);
+			m_TargetMin = mid - half;
+			m_TargetMax = mid + half;
+		}
+
+		// Widen quickly so clipping is brief, narrow slowly so the trace
+		// does not pump
+		float minRate = m_TargetMin < m_RangeMin ? AUTO_RANGE_EXPAND_RATE : AUTO_RANGE_SHRINK_RATE;
+		float maxRate = m_TargetMax > m_RangeMax ? AUTO_RANGE_EXPAND_RATE : AUTO_RANGE_SHRINK_RATE;
+		m_RangeMin += (m_TargetMin - m_RangeMin) * minRate;
+		m_RangeMax += (m_TargetMax - m_RangeMax) * maxRate;
 	}
 
 	Rect Plot::Clip() const {
@@ -112,23 +101,35 @@ namespace gui {
 	}
 
 	void Plot::OnRender() {
-		if (m_Data.size() == 0)
+		if (m_Points.size() == 0)
 			return;
 
-		if (m_DataStale) {
-			PlotPoints(this, m_Data, m_Points, m_LineBreakPos);
-			m_DataStale = false;
-		}
+		const Rect &rect = m_Impl->m_AbsoluteRect;
+		if (m_Points.size() > rect.w * 4)
+			throw GUIError(GetDebugName(), "Cannot render large buffers yet");
+
+		UpdateAutoRange();
+		float range = m_RangeMax - m_RangeMin;
+		if (!(range > 0.f))
+			range = 1.f;
+
+		// Sample i at the left edge of column i, the top of the range at
+		// the top of the widget
+		PointTransform transform;
+		transform.sx = rect.w / static_cast<float>(m_Points.size());
+		transform.tx = std::floor(rect.x);
+		transform.sy = -rect.h / range;
+		transform.ty = rect.y + rect.h + m_RangeMin * rect.h / range;
 
 		m_Impl->ctx->UseShader(Context::GuiShader::Flat);
 
 		if (m_LineBreakPos > m_LineBreakWidth)
 			m_Impl->ctx->DrawPolyLine(std::span(m_Points.begin(),
-						m_Points.begin() + m_LineBreakPos), 2, m_Color);
+						m_Points.begin() + m_LineBreakPos), 2, m_Color, transform);
 
 		if (m_Points.begin() + m_LineBreakPos + m_LineBreakWidth < m_Points.end())
 			m_Impl->ctx->DrawPolyLine(std::span(m_Points.begin() + m_LineBreakPos + m_LineBreakWidth,
-						m_Points.end()), 2, m_Color);
+						m_Points.end()), 2, m_Color, transform);
 	}
 
 }
@@ -0,0 +1,134 @@
+/*
+ * ceeGUI
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <streamBuffer.h>
+
+#include <cee/core/except.h>
+
+#include <cee/profiler/profiler.h>
+
+#include <fmt/format.h>
+#include <glad/egl.h>
+
+#include <cstring>
+
+namespace cee {
+namespace gui {
+	// The loader only covers GLES 2.0, the rest comes from EGL directly
+	static PFNGLFENCESYNCPROC g_FenceSync = nullptr;
+	static PFNGLCLIENTWAITSYNCPROC g_ClientWaitSync = nullptr;
+	static PFNGLDELETESYNCPROC g_DeleteSync = nullptr;
+	static PFNGLMAPBUFFERRANGEPROC g_MapBufferRange = nullptr;
+	static PFNGLUNMAPBUFFERPROC g_UnmapBuffer = nullptr;
+
+	static constexpr GLuint64 FENCE_TIMEOUT_NS = 100000000;
+
+	bool StreamBuffer::LoadFenceFunctions() {
+		if (g_FenceSync)
+			return true;
+		if (!eglGetProcAddress)
+			return false;
+		auto fenceSync = reinterpret_cast<PFNGLFENCESYNCPROC>(eglGetProcAddress("glFenceSync"));
+		g_ClientWaitSync = reinterpret_cast<PFNGLCLIENTWAITSYNCPROC>(eglGetProcAddress("glClientWaitSync"));
+		g_DeleteSync = reinterpret_cast<PFNGLDELETESYNCPROC>(eglGetProcAddress("glDeleteSync"));
+		g_MapBufferRange = reinterpret_cast<PFNGLMAPBUFFERRANGEPROC>(eglGetProcAddress("glMapBufferRange"));
+		g_UnmapBuffer = reinterpret_cast<PFNGLUNMAPBUFFERPROC>(eglGetProcAddress("glUnmapBuffer"));
+		if (!fenceSync || !g_ClientWaitSync || !g_DeleteSync || !g_MapBufferRange || !g_UnmapBuffer)
+			return false;
+		g_FenceSync = fenceSync;
+		return true;
+	}
+
+	StreamBuffer::StreamBuffer(GLenum target, std::size_t segmentSize, bool useFences)
+	 : m_Target(target), m_Name(0), m_UseFences(useFences && LoadFenceFunctions()),
+	   m_SegmentSize(segmentSize), m_Capacity(segmentSize * SEGMENT_COUNT),
+	   m_Head(0), m_Segment(0) {
+		m_Fences.fill(nullptr);
+		glGenBuffers(1, &m_Name);
+		if (m_Name == 0)
+			throw core::InternalError("Failed to create OpenGL stream buffer");
+		glBindBuffer(m_Target, m_Name);
+		glBufferData(m_Target, m_Capacity, nullptr, GL_STREAM_DRAW);
+	}
+
+	StreamBuffer::~StreamBuffer() {
+		for (GLsync fence : m_Fences) {
+			if (fence)
+				g_DeleteSync(fence);
+		}
+		glBindBuffer(m_Target, 0);
+		glDeleteBuffers(1, &m_Name);
+	}
+
+	std::size_t StreamBuffer::Write(const void *data, std::size_t size) {
+		if (size > m_SegmentSize)
+			throw core::InvalidParameter(fmt::format("StreamBuffer::Write(): {} bytes exceed the segment size", size));
+
+		glBindBuffer(m_Target, m_Name);
+		m_Head = (m_Head + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+		if (!m_UseFences) {
+			if (m_Head + size > m_Capacity)
+				Orphan();
+			std::size_t offset = m_Head;
+			glBufferSubData(m_Target, offset, size, data);
+			m_Head += size;
+			return offset;
+		}
+
+		if (m_Head + size > (m_Segment + 1) * m_SegmentSize)
+			NextSegment();
+		std::size_t offset = m_Head;
+		void *dst = g_MapBufferRange(m_Target, offset, size,
+				GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		if (!dst)
+			throw core::InternalError("Failed to map OpenGL stream buffer");
+		std::memcpy(dst, data, size);
+		g_UnmapBuffer(m_Target);
+		m_Head += size;
+		return offset;
+	}
+
+	void StreamBuffer::Orphan() {
+		PROFILE_FUNCTION();
+		glBufferData(m_Target, m_Capacity, nullptr, GL_STREAM_DRAW);
+		m_Head = 0;
+	}
+
+	void StreamBuffer::NextSegment() {
+		m_Fences[m_Segment] = g_FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_Segment = (m_Segment + 1) % SEGMENT_COUNT;
+		WaitSegment(m_Segment);
+		m_Head = m_Segment * m_SegmentSize;
+	}
+
+	void StreamBuffer::WaitSegment(int segment) {
+		GLsync fence = m_Fences[segment];
+		if (!fence)
+			return;
+		PROFILE_FUNCTION();
+		GLenum result;
+		do {
+			result = g_ClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT_NS);
+		} while (result == GL_TIMEOUT_EXPIRED);
+		g_DeleteSync(fence);
+		m_Fences[segment] = nullptr;
+		if (result == GL_WAIT_FAILED)
+			throw core::InternalError("Failed to wait for OpenGL stream buffer fence");
+	}
+}
+}
@@ -0,0 +1,82 @@
+/*
+ * ceeGUI
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_GUI_STREAM_BUFFER_H_
+#define CEE_GUI_STREAM_BUFFER_H_
+
+#include <glad/gl.h>
+
+#include <array>
+#include <cstddef>
+
+namespace cee {
+namespace gui {
+	/*
+	 * Buffer object that data for a single draw is streamed into. Every
+	 * write is appended after the previous one, so draws still queued on
+	 * the GPU never have their data overwritten and the driver never has to
+	 * stall or copy.
+	 *
+	 * With fences (GLES 3) the buffer is a ring of SEGMENT_COUNT segments
+	 * written through unsynchronized mappings. A fence is placed when the
+	 * write head leaves a segment and waited on before the head comes back
+	 * to it, a few frames later. Without fences (GLES 2) the storage is
+	 * orphaned whenever the buffer fills up and writing restarts at zero.
+	 */
+	class StreamBuffer {
+	public:
+		static constexpr int SEGMENT_COUNT = 4;
+		static constexpr std::size_t ALIGNMENT = 4;
+
+	public:
+		// segmentSize must hold the largest single write
+		StreamBuffer(GLenum target, std::size_t segmentSize, bool useFences);
+		~StreamBuffer();
+
+		StreamBuffer(const StreamBuffer &) = delete;
+		StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+		// Binds the buffer, copies data into it and returns its byte offset
+		std::size_t Write(const void *data, std::size_t size);
+
+		GLuint GetName() const { return m_Name; }
+		bool UsesFences() const { return m_UseFences; }
+
+		// Loads the GLES 3 sync and mapping entry points, false if the
+		// context does not provide them
+		static bool LoadFenceFunctions();
+
+	private:
+		void Orphan();
+		void NextSegment();
+		void WaitSegment(int segment);
+
+	private:
+		GLenum m_Target;
+		GLuint m_Name;
+		bool m_UseFences;
+		std::size_t m_SegmentSize;
+		std::size_t m_Capacity;
+		std::size_t m_Head;
+		int m_Segment;
+		std::array<GLsync, SEGMENT_COUNT> m_Fences;
+	};
+}
+}
+
+#endif
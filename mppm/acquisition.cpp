@@ -0,0 +1,229 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/acquisition.h>
+
+#include <cee/core/except.h>
+
+#include <cee/profiler/profiler.h>
+
+#include <time.h>
+
+namespace cee {
+	static uint64_t MonotonicNow() {
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+	}
+
+	Acquisition::Acquisition(std::unique_ptr<platform::PCF8591> adc, float sampleRate,
+			Pacing pacing, int realtimePriority, Logger logger)
+	 : m_Adc(std::move(adc)), m_SampleRate(sampleRate), m_Pacing(pacing), m_Logger(logger), m_Events(nullptr),
+	 m_Scheduler(sampleRate, realtimePriority, logger), m_Running(false),
+	 m_Processors{}, m_ProcessorCount(0), m_BlockFill(0), m_SampleCount(0), m_DroppedCount(0), m_ErrorCount(0) {
+		if (!m_Adc)
+			throw core::InvalidParameter("Acquisition(): No ADC given");
+	}
+
+	Acquisition::~Acquisition() {
+		Stop();
+	}
+
+	void Acquisition::AddProcessor(SampleProcessor *processor) {
+		if (IsRunning())
+			throw core::UsageError("Acquisition::AddProcessor(): Acquisition is running");
+		if (!processor)
+			throw core::InvalidParameter("Acquisition::AddProcessor(): No processor given");
+		if (m_ProcessorCount == MAX_PROCESSORS)
+			throw core::InvalidParameter("Acquisition::AddProcessor(): Too many processors");
+		m_Processors[m_ProcessorCount++] = processor;
+		m_BlockFill = 0;
+	}
+
+	void Acquisition::ClearProcessors() {
+		if (IsRunning())
+			throw core::UsageError("Acquisition::ClearProcessors(): Acquisition is running");
+		m_ProcessorCount = 0;
+		m_BlockFill = 0;
+	}
+
+	void Acquisition::SetEventLog(EventLog *events) {
+		if (IsRunning())
+			throw core::UsageError("Acquisition::SetEventLog(): Acquisition is running");
+		m_Events = events;
+	}
+
+	void Acquisition::Start() {
+		if (m_Running.exchange(true))
+			return;
+		// A thread that gave up on its own is finished but still joinable
+		if (m_Thread.joinable())
+			m_Thread.join();
+		Log(spdlog::level::debug, "Starting acquisition at {} Hz{}", m_SampleRate,
+				m_Pacing == Pacing::UNTHROTTLED ? " (unthrottled)" : "");
+		m_Thread = std::thread(&Acquisition::ThreadMain, this);
+	}
+
+	void Acquisition::Stop() {
+		// The thread clears m_Running itself when it gives up, and still
+		// has to be joined then
+		const bool wasRunning = m_Running.exchange(false);
+		if (m_Thread.joinable())
+			m_Thread.join();
+		if (!wasRunning)
+			return;
+		Log(spdlog::level::debug, "Acquisition stopped ({} samples, {} dropped, {} errors)",
+				GetSampleCount(), GetDroppedCount(), GetErrorCount());
+
+		if (m_Pacing != Pacing::REALTIME)
+			return;
+		JitterStats jitter = GetJitterStats();
+		Log(spdlog::level::info, "Sampling jitter: min {:.1f}us, mean {:.1f}us, p99 {:.1f}us, "
+				"max {:.1f}us, {} missed deadlines over {} wakeups",
+				jitter.min, jitter.mean, jitter.p99, jitter.max, jitter.missedDeadlines, jitter.wakeups);
+	}
+
+	void Acquisition::ThreadMain() {
+		const bool realtime = m_Pacing == Pacing::REALTIME;
+		uint64_t simulatedTime = MonotonicNow();
+		bool failing = false;
+		bool processorFailing = false;
+
+		if (realtime) {
+			try {
+				m_Scheduler.Start();
+			} catch (const core::Error &e) {
+				Log(spdlog::level::err, "Cannot start sample scheduler: {}", e.what());
+				m_Running.store(false, std::memory_order_relaxed);
+				return;
+			}
+		}
+
+		while (m_Running.load(std::memory_order_relaxed)) {
+			PROFILE_SCOPE("Acquire sample");
+			Sample sample;
+			bool acquired = false;
+			try {
+				// (Re)start scanning here rather than once up front so a bus
+				// error mid-scan also resynchronises the channel pointer.
+				if (!m_Adc->IsScanning())
+					m_Adc->StartScan(platform::PCF8591::InputMode::SINGLE_ENDED, false);
+				sample = ReadSample();
+				acquired = true;
+			} catch (const core::Error &e) {
+				uint64_t errors = m_ErrorCount.fetch_add(1, std::memory_order_relaxed) + 1;
+				if (m_Events)
+					CEE_EVENT(*m_Events, "ADC read failed at sample {}, {} errors", GetSampleCount(), errors);
+				if (!failing) {
+					Log(spdlog::level::warn, "ADC read failed: {}", e.what());
+					failing = true;
+				}
+				uint64_t timestamp = realtime ? MonotonicNow() : simulatedTime;
+				if (!realtime)
+					simulatedTime += m_Scheduler.GetPeriod();
+				ReportReadError(timestamp);
+			}
+
+			if (acquired) {
+				if (!realtime) {
+					sample.timestamp = simulatedTime;
+					simulatedTime += m_Scheduler.GetPeriod();
+				}
+				if (failing) {
+					Log(spdlog::level::info, "ADC reads recovered");
+					failing = false;
+				}
+				m_SampleCount.fetch_add(1, std::memory_order_relaxed);
+				if (!Push(sample))
+					break;
+				// A processor failing is not an ADC failure
+				try {
+					ProcessBlock(sample);
+				} catch (const core::Error &e) {
+					if (!processorFailing) {
+						Log(spdlog::level::err, "Sample processing failed: {}", e.what());
+						processorFailing = true;
+					}
+				}
+			}
+
+			// Periods missed while falling behind are counted by the
+			// scheduler, not caught up on with a burst of reads.
+			if (realtime) {
+				try {
+					m_Scheduler.Wait();
+				} catch (const core::Error &e) {
+					// Nothing paces the reads any more, which stops sampling
+					// as surely as the ADC failing
+					Log(spdlog::level::err, "Sample scheduler failed, stopping acquisition: {}", e.what());
+					m_ErrorCount.fetch_add(1, std::memory_order_relaxed);
+					ReportReadError(MonotonicNow());
+					m_Running.store(false, std::memory_order_relaxed);
+					break;
+				}
+			}
+		}
+		if (realtime)
+			m_Scheduler.Stop();
+	}
+
+	bool Acquisition::Push(const Sample &sample) {
+		if (m_Pacing == Pacing::REALTIME) {
+			if (!m_Queue.TryEnqueue(sample))
+				m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+		// Unthrottled sources wait for the consumer instead of dropping
+		while (!m_Queue.TryEnqueue(sample)) {
+			if (!m_Running.load(std::memory_order_relaxed))
+				return false;
+			std::this_thread::yield();
+		}
+		return true;
+	}
+
+	void Acquisition::ReportReadError(uint64_t timestamp) {
+		for (std::size_t i = 0; i < m_ProcessorCount; ++i) {
+			try {
+				m_Processors[i]->OnReadError(timestamp);
+			} catch (const core::Error &e) {
+				Log(spdlog::level::err, "Sample processor failed on a read error: {}", e.what());
+			}
+		}
+	}
+
+	void Acquisition::ProcessBlock(const Sample &sample) {
+		if (m_ProcessorCount == 0)
+			return;
+		m_Block[m_BlockFill++] = sample;
+		if (m_BlockFill < BLOCK_SIZE)
+			return;
+		PROFILE_SCOPE("Process block");
+		// Cleared first so a processor throwing doesn't leave the block full
+		m_BlockFill = 0;
+		for (std::size_t i = 0; i < m_ProcessorCount; ++i)
+			m_Processors[i]->Process(m_Block);
+	}
+
+	Sample Acquisition::ReadSample() {
+		Sample sample{};
+		m_Adc->Scan(sample.channels);
+		sample.timestamp = MonotonicNow();
+		return sample;
+	}
+}
@@ -0,0 +1,188 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/alarms.h>
+
+#include <cee/core/except.h>
+
+#include <cmath>
+
+namespace cee {
+	static_assert(AlarmEngine::MAX_ALARMS <= 32, "Acknowledgements are a 32 bit mask");
+
+	static uint64_t Nanoseconds(float seconds) {
+		return static_cast<uint64_t>(std::llround(static_cast<double>(seconds) * 1e9));
+	}
+
+	AlarmEngine::AlarmEngine()
+	 : m_Count(0), m_Changed(false), m_Acknowledge(0) {
+	}
+
+	AlarmEngine::Id AlarmEngine::Add(const AlarmConfig &config) {
+		if (m_Count == MAX_ALARMS)
+			throw core::InvalidParameter("AlarmEngine::Add(): Too many alarms");
+		if (config.kind == AlarmConfig::Kind::LIMIT && !(config.low <= config.high))
+			throw core::InvalidParameter("AlarmEngine::Add(): Low limit above high limit");
+		if (config.kind == AlarmConfig::Kind::RATE && !(config.rateWindow > 0.f))
+			throw core::InvalidParameter("AlarmEngine::Add(): Rate window must be positive");
+		m_Configs[m_Count] = config;
+		return m_Count++;
+	}
+
+	void AlarmEngine::Update(Id id, float value, uint64_t timestamp) {
+		const AlarmConfig &config = m_Configs[id];
+		Tracker &tracker = m_Trackers[id];
+		const AlarmState state = m_Snapshot.alarms[id].state;
+		// An active alarm only clears once the value is back hysteresis
+		// inside its limit
+		const float margin = state == AlarmState::ACTIVE || tracker.pending ? config.hysteresis : 0.f;
+
+		if (std::isnan(value)) {
+			tracker.haveReference = false;
+			Evaluate(id, false, 0, value, timestamp);
+			return;
+		}
+
+		switch (config.kind) {
+		case AlarmConfig::Kind::LIMIT:
+			if (value > config.high - margin)
+				Evaluate(id, true, 1, value, timestamp);
+			else if (value < config.low + margin)
+				Evaluate(id, true, -1, value, timestamp);
+			else
+				Evaluate(id, false, 0, value, timestamp);
+			break;
+		case AlarmConfig::Kind::RATE: {
+			if (!tracker.haveReference) {
+				tracker.haveReference = true;
+				tracker.reference = value;
+				tracker.referenceTime = timestamp;
+				break;
+			}
+			// The rate is taken once per window, the condition holds in
+			// between
+			uint64_t elapsed = timestamp - tracker.referenceTime;
+			if (elapsed < Nanoseconds(config.rateWindow))
+				break;
+			float rate = (value - tracker.reference) / static_cast<float>(static_cast<double>(elapsed) * 1e-9);
+			tracker.reference = value;
+			tracker.referenceTime = timestamp;
+			if (std::fabs(rate) > config.maxRate - margin)
+				Evaluate(id, true, rate > 0.f ? 1 : -1, rate, timestamp);
+			else
+				Evaluate(id, false, 0, rate, timestamp);
+			break;
+		}
+		case AlarmConfig::Kind::TECHNICAL:
+			Evaluate(id, value != 0.f, 0, value, timestamp);
+			break;
+		}
+	}
+
+	void AlarmEngine::SetCondition(Id id, bool condition, uint64_t timestamp) {
+		Evaluate(id, condition, 0, condition ? 1.f : 0.f, timestamp);
+	}
+
+	void AlarmEngine::Evaluate(Id id, bool condition, int8_t direction, float value, uint64_t timestamp) {
+		const AlarmConfig &config = m_Configs[id];
+		Tracker &tracker = m_Trackers[id];
+		AlarmStatus &status = m_Snapshot.alarms[id];
+
+		if (!condition) {
+			tracker.pending = false;
+			if (status.state == AlarmState::ACTIVE) {
+				status.state = config.latching && !status.acknowledged ? AlarmState::LATCHED : AlarmState::INACTIVE;
+				m_Changed = true;
+			}
+			return;
+		}
+
+		if (status.state == AlarmState::ACTIVE)
+			return;
+		if (!tracker.pending) {
+			tracker.pending = true;
+			tracker.pendingSince = timestamp;
+		}
+		if (timestamp - tracker.pendingSince < Nanoseconds(config.onsetDelay))
+			return;
+
+		tracker.pending = false;
+		status.state = AlarmState::ACTIVE;
+		status.acknowledged = false;
+		status.direction = direction;
+		status.value = value;
+		status.onset = timestamp;
+		m_Changed = true;
+	}
+
+	void AlarmEngine::Publish() {
+		uint32_t acknowledge = m_Acknowledge.exchange(0, std::memory_order_acquire);
+		for (Id id = 0; acknowledge != 0 && id < m_Count; ++id) {
+			if ((acknowledge & (1u << id)) == 0)
+				continue;
+			AlarmStatus &status = m_Snapshot.alarms[id];
+			if (status.state == AlarmState::LATCHED) {
+				status.state = AlarmState::INACTIVE;
+				m_Changed = true;
+			} else if (status.state == AlarmState::ACTIVE && !status.acknowledged) {
+				status.acknowledged = true;
+				m_Changed = true;
+			}
+		}
+
+		if (!m_Changed)
+			return;
+		m_Changed = false;
+		UpdateHighest();
+		m_Published.Store(m_Snapshot);
+	}
+
+	void AlarmEngine::Reset() {
+		m_Trackers.fill({});
+		m_Snapshot = {};
+		m_Changed = false;
+		m_Acknowledge.store(0, std::memory_order_relaxed);
+		m_Published.Store(m_Snapshot);
+	}
+
+	void AlarmEngine::Acknowledge(Id id) {
+		if (id < MAX_ALARMS)
+			m_Acknowledge.fetch_or(1u << id, std::memory_order_release);
+	}
+
+	void AlarmEngine::AcknowledgeAll() {
+		m_Acknowledge.fetch_or(~0u, std::memory_order_release);
+	}
+
+	void AlarmEngine::UpdateHighest() {
+		m_Snapshot.highest = AlarmPriority::NONE;
+		m_Snapshot.highestAlarm = -1;
+		uint64_t latest = 0;
+		for (Id id = 0; id < m_Count; ++id) {
+			const AlarmStatus &status = m_Snapshot.alarms[id];
+			if (status.state == AlarmState::INACTIVE || status.acknowledged)
+				continue;
+			AlarmPriority priority = m_Configs[id].priority;
+			if (priority > m_Snapshot.highest || (priority == m_Snapshot.highest && status.onset >= latest)) {
+				m_Snapshot.highest = priority;
+				m_Snapshot.highestAlarm = static_cast<int8_t>(id);
+				latest = status.onset;
+			}
+		}
+	}
+}
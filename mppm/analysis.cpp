@@ -0,0 +1,254 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/analysis.h>
+#include <cee/mppm/recording.h>
+
+#include <cee/core/except.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace cee {
+	namespace {
+		struct Moments {
+			double min = std::numeric_limits<double>::infinity();
+			double max = -std::numeric_limits<double>::infinity();
+			double sum = 0.0;
+			double squares = 0.0;
+			uint64_t count = 0;
+
+			void Add(double x) {
+				min = std::min(min, x);
+				max = std::max(max, x);
+				sum += x;
+				squares += x * x;
+				++count;
+			}
+
+			void Merge(const Moments &other) {
+				min = std::min(min, other.min);
+				max = std::max(max, other.max);
+				sum += other.sum;
+				squares += other.squares;
+				count += other.count;
+			}
+
+			double GetMean() const { return count > 0 ? sum / static_cast<double>(count) : 0.0; }
+
+			double GetStdDev() const {
+				if (count == 0)
+					return 0.0;
+				double mean = GetMean();
+				return std::sqrt(std::max(squares / static_cast<double>(count) - mean * mean, 0.0));
+			}
+		};
+
+		struct Segment {
+			// Chunks [firstChunk, endChunk) are analysed, processing starts
+			// at warmupChunk
+			std::size_t warmupChunk;
+			std::size_t firstChunk;
+			std::size_t endChunk;
+		};
+
+		struct SegmentResult {
+			std::string error;
+			uint64_t sampleCount = 0;
+			uint64_t beatCount = 0;
+			Moments heartRate;
+			std::array<Moments, SignalChain::CHANNEL_COUNT> channels;
+			std::vector<NibpMeasurement> nibp;
+		};
+
+		struct FileWork {
+			std::string error;
+			float sampleRate = 0.f;
+			std::size_t oversampling = 1;
+			dsp::DecimatorKind decimator = dsp::DecimatorKind::CIC;
+			bool recovered = false;
+			std::vector<Segment> segments;
+			std::vector<SegmentResult> results;
+		};
+	}
+
+	static void AnalyseSegment(const std::string &path, const AnalysisOptions &options, const FileWork &work,
+			const Segment &segment, SegmentResult &result) {
+		RecordingReader reader(path);
+		SignalChain chain(work.sampleRate, options.mainsFrequency, SignalChain::DEFAULT_STATISTICS_WINDOW,
+				work.oversampling, work.decimator, false);
+		const uint64_t countFrom = reader.GetChunkInfo(segment.firstChunk).firstSample;
+
+		RecordingChunk chunk;
+		std::array<Sample, Acquisition::BLOCK_SIZE> block{};
+		std::array<float, SignalChain::OUTPUT_QUEUE_SIZE> output;
+		bool counting = false;
+		uint64_t beatsBefore = 0;
+		for (std::size_t c = segment.warmupChunk; c < segment.endChunk; ++c) {
+			reader.ReadChunk(c, chunk);
+			const std::size_t channels = std::min<std::size_t>(chunk.channels.size(), ADC_CHANNEL_COUNT);
+			const std::size_t count = chunk.GetSampleCount();
+			for (std::size_t i = 0; i < count; i += Acquisition::BLOCK_SIZE) {
+				const std::size_t n = std::min(count - i, Acquisition::BLOCK_SIZE);
+				for (std::size_t j = 0; j < n; ++j) {
+					block[j].timestamp = chunk.timestamps[i + j];
+					for (std::size_t k = 0; k < channels; ++k)
+						block[j].channels[k] = chunk.channels[k][i + j];
+				}
+
+				const bool counted = chunk.firstSample + i >= countFrom;
+				if (counted && !counting) {
+					counting = true;
+					beatsBefore = chain.GetBeatCount();
+				}
+				chain.Process(std::span<const Sample>(block.data(), n));
+
+				// Drained every block, the queues only hold a few
+				for (int channel = 0; channel < SignalChain::CHANNEL_COUNT; ++channel) {
+					std::size_t produced = chain.GetOutput(static_cast<SignalChain::Channel>(channel)).DequeueSpan(output);
+					for (std::size_t j = 0; counted && j < produced; ++j)
+						result.channels[channel].Add(output[j]);
+				}
+				dsp::NibpResult nibp;
+				while (chain.GetNibpResults().TryDequeue(nibp)) {
+					if (counted)
+						result.nibp.push_back({ block[n - 1].timestamp, nibp });
+				}
+				if (!counted)
+					continue;
+				result.sampleCount += n;
+				// A known rate of 0 is asystole and belongs in the statistics
+				if (chain.IsHeartRateKnown())
+					result.heartRate.Add(chain.GetHeartRate());
+			}
+		}
+		if (counting)
+			result.beatCount = chain.GetBeatCount() - beatsBefore;
+	}
+
+	static void PlanFile(ThreadPool &pool, const std::string &path, const AnalysisOptions &options, FileWork &work) {
+		std::size_t chunkCount;
+		{
+			RecordingReader reader(path);
+			work.sampleRate = reader.GetSampleRate();
+			const std::size_t recorded = reader.GetOversampling();
+			work.oversampling = options.oversampling.value_or(recorded > 0 ? recorded : 1);
+			work.decimator = options.decimator.value_or(recorded > 0 ? reader.GetDecimator() : dsp::DecimatorKind::CIC);
+			work.recovered = reader.IsRecovered();
+			chunkCount = reader.GetChunkCount();
+
+			const double rate = static_cast<double>(work.sampleRate);
+			const uint64_t segmentSamples = std::max<uint64_t>(
+					static_cast<uint64_t>(std::llround(options.segmentDuration * rate)), 1);
+			const uint64_t warmupSamples = static_cast<uint64_t>(std::llround(std::max(options.warmup, 0.0) * rate));
+			uint64_t segmentStart = 0;
+			for (std::size_t c = 0; c < chunkCount; ++c) {
+				uint64_t first = reader.GetChunkInfo(c).firstSample;
+				if (c > 0 && first - segmentStart < segmentSamples) {
+					work.segments.back().endChunk = c + 1;
+					continue;
+				}
+				segmentStart = first;
+				std::size_t warmupChunk = reader.FindSample(first > warmupSamples ? first - warmupSamples : 0);
+				work.segments.push_back({ std::min(warmupChunk, c), c, c + 1 });
+			}
+		}
+
+		// Sized before any segment task can run, so they write to their
+		// own element only
+		work.results.resize(work.segments.size());
+		for (std::size_t s = 0; s < work.segments.size(); ++s) {
+			pool.Submit([&path, &options, &work, s] {
+				try {
+					AnalyseSegment(path, options, work, work.segments[s], work.results[s]);
+				} catch (const core::Error &e) {
+					work.results[s].error = e.what();
+				}
+			});
+		}
+	}
+
+	static AnalysisResult Merge(const std::string &path, FileWork &work) {
+		AnalysisResult result;
+		result.path = path;
+		result.error = work.error;
+		result.sampleRate = work.sampleRate;
+		result.oversampling = std::clamp<std::size_t>(work.oversampling, 1, dsp::Decimator<float>::MAX_FACTOR);
+		result.decimator = work.decimator;
+		result.outputRate = work.sampleRate / static_cast<float>(result.oversampling);
+		result.segmentCount = work.segments.size();
+		result.recovered = work.recovered;
+
+		Moments heartRate;
+		std::array<Moments, SignalChain::CHANNEL_COUNT> channels;
+		for (std::size_t s = 0; s < work.results.size(); ++s) {
+			SegmentResult &segment = work.results[s];
+			if (!segment.error.empty() && result.error.empty())
+				result.error = fmt::format("Segment {}: {}", s, segment.error);
+			result.sampleCount += segment.sampleCount;
+			result.beatCount += segment.beatCount;
+			heartRate.Merge(segment.heartRate);
+			for (int channel = 0; channel < SignalChain::CHANNEL_COUNT; ++channel)
+				channels[channel].Merge(segment.channels[channel]);
+			result.nibp.insert(result.nibp.end(), segment.nibp.begin(), segment.nibp.end());
+		}
+
+		if (result.sampleRate > 0.f)
+			result.duration = static_cast<double>(result.sampleCount) / static_cast<double>(result.sampleRate);
+		if (heartRate.count > 0) {
+			result.minHeartRate = static_cast<float>(heartRate.min);
+			result.maxHeartRate = static_cast<float>(heartRate.max);
+			result.meanHeartRate = static_cast<float>(heartRate.GetMean());
+		}
+		for (int channel = 0; channel < SignalChain::CHANNEL_COUNT; ++channel) {
+			const Moments &moments = channels[channel];
+			if (moments.count == 0)
+				continue;
+			result.channels[channel] = {
+				static_cast<float>(moments.min), static_cast<float>(moments.max),
+				static_cast<float>(moments.GetMean()), static_cast<float>(moments.GetStdDev()),
+				moments.count
+			};
+		}
+		return result;
+	}
+
+	std::vector<AnalysisResult> AnalyseRecordings(ThreadPool &pool, std::span<const std::string> paths,
+			const AnalysisOptions &options) {
+		std::vector<FileWork> work(paths.size());
+		for (std::size_t i = 0; i < paths.size(); ++i) {
+			pool.Submit([&pool, &paths, &options, &work, i] {
+				try {
+					PlanFile(pool, paths[i], options, work[i]);
+				} catch (const core::Error &e) {
+					work[i].error = e.what();
+				}
+			});
+		}
+		pool.Wait();
+
+		std::vector<AnalysisResult> results;
+		results.reserve(paths.size());
+		for (std::size_t i = 0; i < paths.size(); ++i)
+			results.push_back(Merge(paths[i], work[i]));
+		return results;
+	}
+}
@@ -0,0 +1,94 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <cee/mppm/capture.h>
+
+#include <cee/core/except.h>
+
+#include <cee/profiler/profiler.h>
+
+#include <array>
+
+namespace cee {
+	Capturer::Capturer(const std::string &path, float sampleRate, Logger logger)
+	 : m_Writer(path, sampleRate), m_Logger(logger), m_Running(false), m_Failed(false),
+	 m_CapturedCount(0), m_DroppedCount(0) {
+	}
+
+	Capturer::~Capturer() {
+		Stop();
+	}
+
+	void Capturer::Start() {
+		if (m_Running.exchange(true))
+			return;
+		m_Thread = std::thread(&Capturer::ThreadMain, this);
+	}
+
+	void Capturer::Stop() {
+		if (!m_Running.exchange(false))
+			return;
+		if (m_Thread.joinable())
+			m_Thread.join();
+		Log(spdlog::level::debug, "Capture stopped ({} samples, {} dropped)", GetCapturedCount(), GetDroppedCount());
+	}
+
+	void Capturer::Process(std::span<const Sample> samples) {
+		if (m_Failed.load(std::memory_order_relaxed)) {
+			m_DroppedCount.fetch_add(samples.size(), std::memory_order_relaxed);
+			return;
+		}
+		std::size_t queued = m_Queue.EnqueueSpan(samples);
+		if (queued < samples.size())
+			m_DroppedCount.fetch_add(samples.size() - queued, std::memory_order_relaxed);
+	}
+
+	void Capturer::ThreadMain() {
+		auto lastFlush = std::chrono::steady_clock::now();
+		try {
+			while (m_Running.load(std::memory_order_relaxed)) {
+				std::size_t drained = Drain();
+				auto now = std::chrono::steady_clock::now();
+				if (now - lastFlush >= FLUSH_INTERVAL) {
+					PROFILE_SCOPE("Flush capture");
+					m_Writer.Flush();
+					lastFlush = now;
+				}
+				if (drained == 0)
+					std::this_thread::sleep_for(POLL_INTERVAL);
+			}
+			while (Drain() > 0) {}
+			m_Writer.Flush();
+		} catch (const core::Error &e) {
+			Log(spdlog::level::err, "Stopping capture: {}", e.what());
+			m_Failed.store(true, std::memory_order_relaxed);
+		}
+	}
+
+	std::size_t Capturer::Drain() {
+		std::array<Sample, 256> samples;
+		std::size_t drained = 0;
+		std::size_t count;
+		while ((count = m_Queue.DequeueSpan(samples)) > 0) {
+			drained += count;
+			for (std::size_t i = 0; i < count; ++i)
+				m_Writer.Write(samples[i].channels);
+			m_CapturedCount.fetch_add(count, std::memory_order_relaxed);
+		}
+		return drained;
+	}
+}
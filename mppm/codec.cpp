@@ -0,0 +1,259 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/codec.h>
+
+#include <cee/dsp/simd.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <type_traits>
+
+namespace cee {
+	// Block descriptors hold the width in the low bits and flag second order
+	// prediction in the top one
+	static constexpr uint8_t SECOND_ORDER = 0x80;
+	static constexpr uint8_t WIDTH_MASK = 0x7F;
+
+	template<typename T>
+	static uint64_t ZigZag(T residual) {
+		int64_t value = static_cast<std::make_signed_t<T>>(residual);
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	template<typename T>
+	static T UnZigZag(uint64_t value) {
+		return static_cast<T>((value >> 1) ^ (~(value & 1) + 1));
+	}
+
+	class BitWriter {
+	public:
+		explicit BitWriter(std::vector<uint8_t> &out)
+		 : m_Out(out), m_Acc(0), m_Bits(0) {
+		}
+
+		// value must fit in width bits
+		void Put(uint64_t value, int width) {
+			if (width > 32) {
+				Put(value & 0xFFFFFFFFu, 32);
+				Put(value >> 32, width - 32);
+				return;
+			}
+			m_Acc |= value << m_Bits;
+			m_Bits += width;
+			while (m_Bits >= 8) {
+				m_Out.push_back(static_cast<uint8_t>(m_Acc));
+				m_Acc >>= 8;
+				m_Bits -= 8;
+			}
+		}
+
+		void Finish() {
+			if (m_Bits > 0)
+				m_Out.push_back(static_cast<uint8_t>(m_Acc));
+			m_Acc = 0;
+			m_Bits = 0;
+		}
+
+	private:
+		std::vector<uint8_t> &m_Out;
+		uint64_t m_Acc;
+		int m_Bits;
+	};
+
+	class BitReader {
+	public:
+		explicit BitReader(std::span<const uint8_t> bytes)
+		 : m_Bytes(bytes), m_Pos(0), m_Acc(0), m_Bits(0) {
+		}
+
+		uint64_t Get(int width) {
+			if (width > 32) {
+				uint64_t low = Get(32);
+				return low | (Get(width - 32) << 32);
+			}
+			while (m_Bits < width) {
+				uint64_t byte = m_Pos < m_Bytes.size() ? m_Bytes[m_Pos++] : 0;
+				m_Acc |= byte << m_Bits;
+				m_Bits += 8;
+			}
+			uint64_t value = m_Acc & ((uint64_t(1) << width) - 1);
+			m_Acc >>= width;
+			m_Bits -= width;
+			return value;
+		}
+
+	private:
+		std::span<const uint8_t> m_Bytes;
+		std::size_t m_Pos;
+		uint64_t m_Acc;
+		int m_Bits;
+	};
+
+	template<typename T>
+	static void AppendValue(std::vector<uint8_t> &out, T value) {
+		uint8_t bytes[sizeof(T)];
+		std::memcpy(bytes, &value, sizeof(T));
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	template<typename T>
+	static void Encode(std::span<const T> values, std::vector<uint8_t> &out) {
+		if (values.empty())
+			return;
+		T previous = values[0];
+		T delta = values.size() > 1 ? static_cast<T>(values[1] - values[0]) : T(0);
+		AppendValue(out, previous);
+		AppendValue(out, delta);
+		if (values.size() > 1)
+			previous = values[1];
+
+		std::array<uint64_t, CODEC_BLOCK_SIZE> first;
+		std::array<uint64_t, CODEC_BLOCK_SIZE> second;
+		for (std::size_t start = 2; start < values.size(); start += CODEC_BLOCK_SIZE) {
+			const std::size_t count = std::min(CODEC_BLOCK_SIZE, values.size() - start);
+			uint64_t firstBits = 0;
+			uint64_t secondBits = 0;
+			for (std::size_t i = 0; i < count; ++i) {
+				T value = values[start + i];
+				T next = static_cast<T>(value - previous);
+				first[i] = ZigZag<T>(next);
+				second[i] = ZigZag<T>(static_cast<T>(next - delta));
+				firstBits |= first[i];
+				secondBits |= second[i];
+				previous = value;
+				delta = next;
+			}
+
+			const bool useSecond = std::bit_width(secondBits) < std::bit_width(firstBits);
+			const int width = std::bit_width(useSecond ? secondBits : firstBits);
+			const std::array<uint64_t, CODEC_BLOCK_SIZE> &residuals = useSecond ? second : first;
+			out.push_back(static_cast<uint8_t>(width) | (useSecond ? SECOND_ORDER : 0));
+			BitWriter writer(out);
+			for (std::size_t i = 0; width > 0 && i < count; ++i)
+				writer.Put(residuals[i], width);
+			writer.Finish();
+		}
+	}
+
+	template<typename T>
+	static void DecodeBlock(BitReader &reader, int width, bool second, T &previous, T &delta, std::span<T> out) {
+		for (T &value : out) {
+			T residual = UnZigZag<T>(reader.Get(width));
+			delta = second ? static_cast<T>(delta + residual) : residual;
+			previous = static_cast<T>(previous + delta);
+			value = previous;
+		}
+	}
+
+	// Running sum of the lanes
+	static dsp::Int4 PrefixSum(dsp::Int4 x) {
+		x = x + x.ShiftLanes<1>();
+		return x + x.ShiftLanes<2>();
+	}
+
+	// Codes are rebuilt four at a time in 32 bit lanes, which wrap the same
+	// way modulo 256
+	template<bool Second>
+	static void DecodeCodes(std::span<const int32_t> residuals, uint8_t &previous, uint8_t &delta, std::span<uint8_t> out) {
+		alignas(16) std::array<int32_t, CODEC_BLOCK_SIZE> deltas;
+		alignas(16) std::array<int32_t, CODEC_BLOCK_SIZE> values;
+		const dsp::Int4 one = dsp::Int4::Set1(1);
+		dsp::Int4 valueCarry = dsp::Int4::Set1(previous);
+		dsp::Int4 deltaCarry = dsp::Int4::Set1(delta);
+		for (std::size_t i = 0; i < out.size(); i += 4) {
+			dsp::Int4 zigzag = dsp::Int4::Load(residuals.data() + i);
+			dsp::Int4 residual = zigzag.ShiftRightLogical<1>() ^ (dsp::Int4::Zero() - (zigzag & one));
+			dsp::Int4 d = residual;
+			if constexpr (Second) {
+				d = PrefixSum(residual) + deltaCarry;
+				deltaCarry = d.Broadcast<3>();
+			}
+			dsp::Int4 value = PrefixSum(d) + valueCarry;
+			valueCarry = value.Broadcast<3>();
+			d.Store(deltas.data() + i);
+			value.Store(values.data() + i);
+		}
+		for (std::size_t i = 0; i < out.size(); ++i)
+			out[i] = static_cast<uint8_t>(values[i]);
+		previous = out.back();
+		delta = static_cast<uint8_t>(deltas[out.size() - 1]);
+	}
+
+	static void DecodeBlock(BitReader &reader, int width, bool second, uint8_t &previous, uint8_t &delta,
+			std::span<uint8_t> out) {
+		// Padded with zeros to whole vectors
+		alignas(16) std::array<int32_t, CODEC_BLOCK_SIZE> residuals{};
+		for (std::size_t i = 0; width > 0 && i < out.size(); ++i)
+			residuals[i] = static_cast<int32_t>(reader.Get(width));
+		if (second)
+			DecodeCodes<true>(residuals, previous, delta, out);
+		else
+			DecodeCodes<false>(residuals, previous, delta, out);
+	}
+
+	template<typename T>
+	static bool Decode(std::span<const uint8_t> &in, std::span<T> values) {
+		if (values.empty())
+			return true;
+		if (in.size() < 2 * sizeof(T))
+			return false;
+		T previous;
+		T delta;
+		std::memcpy(&previous, in.data(), sizeof(T));
+		std::memcpy(&delta, in.data() + sizeof(T), sizeof(T));
+		in = in.subspan(2 * sizeof(T));
+		values[0] = previous;
+		if (values.size() == 1)
+			return true;
+		previous = static_cast<T>(previous + delta);
+		values[1] = previous;
+
+		for (std::size_t start = 2; start < values.size(); start += CODEC_BLOCK_SIZE) {
+			const std::size_t count = std::min(CODEC_BLOCK_SIZE, values.size() - start);
+			if (in.empty())
+				return false;
+			const int width = in[0] & WIDTH_MASK;
+			const std::size_t bytes = (count * static_cast<std::size_t>(width) + 7) / 8;
+			if (width > static_cast<int>(sizeof(T) * 8) || in.size() < 1 + bytes)
+				return false;
+			BitReader reader(in.subspan(1, bytes));
+			DecodeBlock(reader, width, (in[0] & SECOND_ORDER) != 0, previous, delta, values.subspan(start, count));
+			in = in.subspan(1 + bytes);
+		}
+		return true;
+	}
+
+	void EncodePlane(std::span<const uint8_t> codes, std::vector<uint8_t> &out) {
+		Encode(codes, out);
+	}
+
+	void EncodePlane(std::span<const uint64_t> timestamps, std::vector<uint8_t> &out) {
+		Encode(timestamps, out);
+	}
+
+	bool DecodePlane(std::span<const uint8_t> &in, std::span<uint8_t> codes) {
+		return Decode(in, codes);
+	}
+
+	bool DecodePlane(std::span<const uint8_t> &in, std::span<uint64_t> timestamps) {
+		return Decode(in, timestamps);
+	}
+}
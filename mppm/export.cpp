@@ -0,0 +1,393 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/export.h>
+#include <cee/mppm/recording.h>
+#include <cee/mppm/signals.h>
+
+#include <cee/core/except.h>
+
+#include <cee/dsp/simd.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace cee {
+	struct SignalInfo {
+		const char *label;
+		const char *transducer;
+		// Of the physical values, which span [0, fullScale]
+		const char *unit;
+		float fullScale;
+	};
+
+	// By ADC input, as wired for the SignalChain
+	static constexpr std::array<SignalInfo, 3> SIGNALS = {{
+		{ "ECG II", "ECG electrodes", "FS", 1.f },
+		{ "Cuff pressure", "Pressure transducer", "mmHg", SignalChain::PRESSURE_FULL_SCALE },
+		{ "Cuff oscillation", "Pressure transducer", "FS", 1.f },
+	}};
+
+	static constexpr int DIGITAL_MIN = -128;
+	static constexpr int DIGITAL_MAX = 127;
+
+	static SignalInfo GetSignalInfo(int channel, std::string &label) {
+		if (channel < static_cast<int>(SIGNALS.size()))
+			return SIGNALS[channel];
+		label = fmt::format("AIN{}", channel);
+		return { label.c_str(), "", "FS", 1.f };
+	}
+
+	// Wall clock time of a sample, from the recording's clock pair
+	static std::tm SampleTime(const RecordingHeader &header, uint64_t timestamp) {
+		int64_t realtime = static_cast<int64_t>(header.startTime)
+			+ (static_cast<int64_t>(timestamp) - static_cast<int64_t>(header.startMonotonic));
+		std::time_t seconds = static_cast<std::time_t>(std::max<int64_t>(realtime, 0) / 1000000000);
+		std::tm time{};
+		localtime_r(&seconds, &time);
+		return time;
+	}
+
+	// Output through a fixed buffer, written out whenever it fills
+	class OutputFile {
+	public:
+		static constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+
+	public:
+		explicit OutputFile(const std::string &path)
+		 : m_Path(path), m_Fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)), m_Used(0) {
+			if (m_Fd < 0)
+				throw core::FileError(fmt::format("Failed to create {} ({})", m_Path, strerror(errno)));
+			m_Buffer.resize(BUFFER_SIZE);
+		}
+
+		~OutputFile() {
+			if (m_Fd >= 0)
+				::close(m_Fd);
+		}
+
+		OutputFile(const OutputFile &) = delete;
+		OutputFile &operator=(const OutputFile &) = delete;
+
+		void Write(const void *data, std::size_t size) {
+			const uint8_t *bytes = static_cast<const uint8_t *>(data);
+			while (size > 0) {
+				std::size_t count = std::min(size, BUFFER_SIZE - m_Used);
+				std::memcpy(m_Buffer.data() + m_Used, bytes, count);
+				m_Used += count;
+				bytes += count;
+				size -= count;
+				if (m_Used == BUFFER_SIZE)
+					Flush();
+			}
+		}
+
+		void Write(const std::string &text) { Write(text.data(), text.size()); }
+
+		// Replaces bytes already written, for header fields only known at
+		// the end
+		void Rewrite(off_t offset, const std::string &text) {
+			Flush();
+			if (::pwrite(m_Fd, text.data(), text.size(), offset) != static_cast<ssize_t>(text.size()))
+				throw core::FileError(fmt::format("Failed to write {} ({})", m_Path, strerror(errno)));
+		}
+
+		void Close() {
+			Flush();
+			if (::close(m_Fd) != 0) {
+				m_Fd = -1;
+				throw core::FileError(fmt::format("Failed to write {} ({})", m_Path, strerror(errno)));
+			}
+			m_Fd = -1;
+		}
+
+	private:
+		void Flush() {
+			std::size_t written = 0;
+			while (written < m_Used) {
+				ssize_t result = ::write(m_Fd, m_Buffer.data() + written, m_Used - written);
+				if (result < 0 && errno == EINTR)
+					continue;
+				if (result <= 0)
+					throw core::FileError(fmt::format("Failed to write {} ({})", m_Path, strerror(errno)));
+				written += static_cast<std::size_t>(result);
+			}
+			m_Used = 0;
+		}
+
+	private:
+		std::string m_Path;
+		int m_Fd;
+		std::vector<uint8_t> m_Buffer;
+		std::size_t m_Used;
+	};
+
+	// EDF header fields are ASCII, left aligned and padded with spaces
+	static void AppendField(std::string &header, const std::string &value, std::size_t width) {
+		std::string field = value.substr(0, width);
+		field.resize(width, ' ');
+		header += field;
+	}
+
+	// Shortest form of seconds that fits an 8 character field or a TAL
+	static std::string FormatSeconds(double seconds, std::size_t width) {
+		std::string text = fmt::format("{:.7f}", seconds);
+		text.erase(text.find_last_not_of('0') + 1);
+		if (text.back() == '.')
+			text.pop_back();
+		return text.substr(0, width);
+	}
+
+	// Bytes of the annotation signal in every data record, room for the
+	// time-keeping TAL
+	static constexpr std::size_t ANNOTATION_SAMPLES = 32;
+
+	void ExportEdf(const std::string &recording, const std::string &path) {
+		RecordingReader reader(recording);
+		const RecordingHeader &info = reader.GetHeader();
+		const int signals = reader.GetChannelCount();
+		const double rate = static_cast<double>(reader.GetSampleRate());
+		const std::size_t recordSamples = static_cast<std::size_t>(std::max<long>(std::lround(rate), 1));
+		const double recordDuration = static_cast<double>(recordSamples) / rate;
+		const uint64_t firstTimestamp = reader.GetChunkCount() > 0 ? reader.GetChunkInfo(0).firstTimestamp
+			: info.startMonotonic;
+
+		std::tm start = SampleTime(info, firstTimestamp);
+		std::string header;
+		AppendField(header, "0", 8);
+		AppendField(header, "X X X X", 80);
+		static constexpr const char *MONTHS[12] = {
+			"JAN", "FEB", "MAR", "APR", "MAY", "JUN", "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"
+		};
+		AppendField(header, fmt::format("Startdate {:02}-{}-{} X X ceeMPPM", start.tm_mday, MONTHS[start.tm_mon],
+				start.tm_year + 1900), 80);
+		AppendField(header, fmt::format("{:02}.{:02}.{:02}", start.tm_mday, start.tm_mon + 1, start.tm_year % 100), 8);
+		AppendField(header, fmt::format("{:02}.{:02}.{:02}", start.tm_hour, start.tm_min, start.tm_sec), 8);
+		AppendField(header, std::to_string(256 * (signals + 2)), 8);
+		// Both are patched once every sample has been seen
+		AppendField(header, "EDF+C", 44);
+		AppendField(header, "-1", 8);
+		AppendField(header, FormatSeconds(recordDuration, 8), 8);
+		AppendField(header, std::to_string(signals + 1), 4);
+
+		// Every field for every signal in turn, the annotations last
+		std::vector<std::string> labels(signals);
+		std::vector<SignalInfo> signalInfo;
+		for (int s = 0; s < signals; ++s)
+			signalInfo.push_back(GetSignalInfo(s, labels[s]));
+		for (const SignalInfo &signal : signalInfo)
+			AppendField(header, signal.label, 16);
+		AppendField(header, "EDF Annotations", 16);
+		for (const SignalInfo &signal : signalInfo)
+			AppendField(header, signal.transducer, 80);
+		AppendField(header, "", 80);
+		for (const SignalInfo &signal : signalInfo)
+			AppendField(header, signal.unit, 8);
+		AppendField(header, "", 8);
+		for (int s = 0; s < signals; ++s)
+			AppendField(header, "0", 8);
+		AppendField(header, "-1", 8);
+		for (const SignalInfo &signal : signalInfo)
+			AppendField(header, fmt::format("{:g}", signal.fullScale), 8);
+		AppendField(header, "1", 8);
+		for (int s = 0; s < signals; ++s)
+			AppendField(header, std::to_string(DIGITAL_MIN), 8);
+		AppendField(header, "-32768", 8);
+		for (int s = 0; s < signals; ++s)
+			AppendField(header, std::to_string(DIGITAL_MAX), 8);
+		AppendField(header, "32767", 8);
+		for (int s = 0; s < signals; ++s)
+			AppendField(header, "", 80);
+		AppendField(header, "", 80);
+		for (int s = 0; s < signals; ++s)
+			AppendField(header, std::to_string(recordSamples), 8);
+		AppendField(header, std::to_string(ANNOTATION_SAMPLES), 8);
+		for (int s = 0; s <= signals; ++s)
+			AppendField(header, "", 32);
+
+		OutputFile out(path);
+		out.Write(header);
+
+		/*
+		 * One data record: each signal's samples, then the annotations.
+		 * Samples more than one and a half periods apart leave a gap, from
+		 * read errors or dropped blocks. A gap that ends within the current
+		 * record is filled by holding the last sample, so records stay a
+		 * whole duration long and cannot overlap. A longer one pads and
+		 * closes the record and the next starts at the real time of the
+		 * sample after the gap, which makes the file EDF+D.
+		 */
+		const uint64_t tolerance = static_cast<uint64_t>(1.5e9 / rate);
+		std::vector<int16_t> record(signals * recordSamples + ANNOTATION_SAMPLES);
+		std::size_t filled = 0;
+		uint64_t recordCount = 0;
+		bool continuous = true;
+		// Records since the last gap follow on from its onset
+		double segmentOnset = 0.0;
+		uint64_t segmentRecords = 0;
+		double recordEnd = 0.0;
+		auto hold = [&](std::size_t count) {
+			for (int s = 0; s < signals; ++s) {
+				int16_t *samples = record.data() + s * recordSamples;
+				std::fill(samples + filled, samples + filled + count, filled > 0 ? samples[filled - 1] : int16_t(0));
+			}
+			filled += count;
+		};
+		auto writeRecord = [&] {
+			hold(recordSamples - filled);
+			double onset = segmentOnset + static_cast<double>(segmentRecords) * recordDuration;
+			std::array<char, 2 * ANNOTATION_SAMPLES> annotations{};
+			std::string tal = "+" + FormatSeconds(onset, 2 * ANNOTATION_SAMPLES - 4) + "\x14\x14";
+			std::memcpy(annotations.data(), tal.data(), tal.size());
+			std::memcpy(record.data() + signals * recordSamples, annotations.data(), annotations.size());
+
+			if constexpr (std::endian::native == std::endian::big) {
+				for (std::size_t i = 0; i < signals * recordSamples; ++i) {
+					uint16_t v = static_cast<uint16_t>(record[i]);
+					record[i] = static_cast<int16_t>(static_cast<uint16_t>(v << 8 | v >> 8));
+				}
+			}
+			out.Write(record.data(), record.size() * sizeof(int16_t));
+			filled = 0;
+			++segmentRecords;
+			++recordCount;
+			recordEnd = onset + recordDuration;
+		};
+
+		RecordingChunk chunk;
+		bool first = true;
+		uint64_t previous = 0;
+		for (std::size_t c = 0; c < reader.GetChunkCount(); ++c) {
+			reader.ReadChunk(c, chunk);
+			const std::size_t count = chunk.GetSampleCount();
+			for (std::size_t offset = 0; offset < count;) {
+				const uint64_t timestamp = chunk.timestamps[offset];
+				if (first) {
+					first = false;
+				} else if (timestamp > previous + tolerance) {
+					const uint64_t missing = static_cast<uint64_t>(
+							std::llround(static_cast<double>(timestamp - previous) * rate * 1e-9)) - 1;
+					if (filled > 0 && filled + missing < recordSamples) {
+						hold(missing);
+					} else {
+						if (filled > 0)
+							writeRecord();
+						continuous = false;
+						segmentOnset = std::max(static_cast<double>(timestamp - firstTimestamp) * 1e-9, recordEnd);
+						segmentRecords = 0;
+					}
+				}
+
+				// Up to the next gap, the end of the record or the chunk
+				std::size_t run = 1;
+				std::size_t limit = std::min(recordSamples - filled, count - offset);
+				while (run < limit && chunk.timestamps[offset + run] <= chunk.timestamps[offset + run - 1] + tolerance)
+					++run;
+				for (int s = 0; s < signals; ++s)
+					dsp::WidenOffset(chunk.channels[s].data() + offset, record.data() + s * recordSamples + filled, run);
+				filled += run;
+				offset += run;
+				previous = chunk.timestamps[offset - 1];
+				if (filled == recordSamples)
+					writeRecord();
+			}
+		}
+		if (filled > 0)
+			writeRecord();
+
+		out.Rewrite(192, fmt::format("{:<44}", continuous ? "EDF+C" : "EDF+D"));
+		out.Rewrite(236, fmt::format("{:<8}", recordCount));
+		out.Close();
+	}
+
+	void ExportWfdb(const std::string &recording, const std::string &recordPath) {
+		RecordingReader reader(recording);
+		const RecordingHeader &info = reader.GetHeader();
+		const int signals = reader.GetChannelCount();
+		const std::string name = std::filesystem::path(recordPath).filename().string();
+		if (name.empty())
+			throw core::InvalidParameter(fmt::format("ExportWfdb(): No record name in {}", recordPath));
+
+		std::vector<int64_t> checksums(signals, 0);
+		std::vector<int> initial(signals, 0);
+		{
+			OutputFile dat(recordPath + ".dat");
+			RecordingChunk chunk;
+			std::vector<uint8_t> frames;
+			for (std::size_t c = 0; c < reader.GetChunkCount(); ++c) {
+				reader.ReadChunk(c, chunk);
+				const std::size_t count = chunk.GetSampleCount();
+				if (c == 0 && count > 0) {
+					for (int s = 0; s < signals; ++s)
+						initial[s] = chunk.channels[s][0] - 128;
+				}
+				for (int s = 0; s < signals; ++s) {
+					int64_t sum = 0;
+					for (uint8_t code : chunk.channels[s])
+						sum += code;
+					checksums[s] += sum - 128 * static_cast<int64_t>(count);
+				}
+
+				// Format 80 stores sample + 128, which is the code itself
+				frames.resize(count * signals);
+				if (signals == 4) {
+					dsp::Interleave4(chunk.channels[0].data(), chunk.channels[1].data(), chunk.channels[2].data(),
+							chunk.channels[3].data(), frames.data(), count);
+				} else {
+					for (std::size_t i = 0; i < count; ++i) {
+						for (int s = 0; s < signals; ++s)
+							frames[i * signals + s] = chunk.channels[s][i];
+					}
+				}
+				dat.Write(frames.data(), frames.size());
+			}
+			dat.Close();
+		}
+
+		const uint64_t firstTimestamp = reader.GetChunkCount() > 0 ? reader.GetChunkInfo(0).firstTimestamp
+			: info.startMonotonic;
+		std::tm start = SampleTime(info, firstTimestamp);
+		OutputFile hea(recordPath + ".hea");
+		hea.Write(fmt::format("{} {} {:g} {} {:02}:{:02}:{:02} {:02}/{:02}/{:04}\n", name, signals,
+				reader.GetSampleRate(), reader.GetSampleCount(), start.tm_hour, start.tm_min, start.tm_sec,
+				start.tm_mday, start.tm_mon + 1, start.tm_year + 1900));
+		for (int s = 0; s < signals; ++s) {
+			std::string label;
+			SignalInfo signal = GetSignalInfo(s, label);
+			// Physical values are (sample - baseline) / gain, so code / gain
+			double gain = (DIGITAL_MAX - DIGITAL_MIN) / static_cast<double>(signal.fullScale);
+			hea.Write(fmt::format("{}.dat 80 {:g}({})/{} 8 0 {} {} 0 {}\n", name, gain, DIGITAL_MIN, signal.unit,
+					initial[s], static_cast<int16_t>(static_cast<uint16_t>(checksums[s] & 0xffff)), signal.label));
+		}
+		hea.Write(fmt::format("# Exported from ceeMPPM recording {}\n",
+				std::filesystem::path(recording).filename().string()));
+		hea.Close();
+	}
+}
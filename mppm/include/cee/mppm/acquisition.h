@@ -0,0 +1,150 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_MPPM_ACQUISITION_H_
+#define CEE_MPPM_ACQUISITION_H_
+
+#include <cee/core/event_log.h>
+#include <cee/core/log.h>
+#include <cee/core/ringbuffer.h>
+
+#include <cee/mppm/scheduler.h>
+
+#include <cee/platform/i2c.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+
+namespace cee {
+	constexpr int ADC_CHANNEL_COUNT = platform::PCF8591::MAX_CHANNELS;
+
+	struct Sample {
+		uint64_t timestamp; // CLOCK_MONOTONIC, nanoseconds
+		std::array<uint8_t, ADC_CHANNEL_COUNT> channels;
+	};
+
+	/*
+	 * Processing run on the acquisition thread, handed blocks of up to
+	 * Acquisition::BLOCK_SIZE samples. Implementations must not block.
+	 */
+	class SampleProcessor {
+	public:
+		virtual ~SampleProcessor() {}
+
+		virtual void Process(std::span<const Sample> samples) = 0;
+		// Called for every failed read, with the time the sample was due
+		virtual void OnReadError(uint64_t timestamp) {}
+	};
+
+	/*
+	 * Samples the ADC on its own thread at a fixed rate, independently of
+	 * the render loop. Samples are handed to the consumer through a lock-free
+	 * queue which the render loop drains once per frame.
+	 *
+	 * A realtimePriority above 0 runs the thread under SCHED_FIFO at that
+	 * priority, falling back to normal scheduling if that is not permitted.
+	 *
+	 * With UNTHROTTLED pacing samples are read as fast as the consumer
+	 * drains the queue, nothing is dropped and timestamps advance by one
+	 * sample period per sample. This is meant for simulated sources.
+	 */
+	class Acquisition {
+	public:
+		static constexpr std::size_t QUEUE_SIZE = 4096;
+		static constexpr std::size_t BLOCK_SIZE = 8;
+		static constexpr std::size_t MAX_PROCESSORS = 4;
+		using SampleQueue = SPSCRingBuffer<Sample, QUEUE_SIZE>;
+
+		enum class Pacing {
+			REALTIME = 0,
+			UNTHROTTLED,
+		};
+
+	public:
+		Acquisition(std::unique_ptr<platform::PCF8591> adc, float sampleRate,
+				Pacing pacing = Pacing::REALTIME, int realtimePriority = 0,
+				Logger logger = nullptr);
+		~Acquisition();
+
+		Acquisition(const Acquisition &) = delete;
+		Acquisition &operator=(const Acquisition &) = delete;
+
+		// Processors are run in the order they were added. They must outlive
+		// the acquisition or be cleared first, and can only be changed while
+		// stopped.
+		void AddProcessor(SampleProcessor *processor);
+		void ClearProcessors();
+		// Every failed read is written to events, which must outlive the
+		// acquisition. Only while stopped, nullptr turns it off.
+		void SetEventLog(EventLog *events);
+
+		void Start();
+		void Stop();
+		bool IsRunning() const { return m_Running.load(std::memory_order_relaxed); }
+
+		float GetSampleRate() const { return m_SampleRate; }
+		Pacing GetPacing() const { return m_Pacing; }
+		SampleQueue &GetQueue() { return m_Queue; }
+
+		uint64_t GetSampleCount() const { return m_SampleCount.load(std::memory_order_relaxed); }
+		uint64_t GetDroppedCount() const { return m_DroppedCount.load(std::memory_order_relaxed); }
+		uint64_t GetErrorCount() const { return m_ErrorCount.load(std::memory_order_relaxed); }
+		JitterStats GetJitterStats() const { return m_Scheduler.GetStats(); }
+
+	private:
+		void ThreadMain();
+		Sample ReadSample();
+		bool Push(const Sample &sample);
+		void ProcessBlock(const Sample &sample);
+		// Passes a read error to every processor, containing what they throw
+		void ReportReadError(uint64_t timestamp);
+
+		template<typename ...Args>
+		void Log(spdlog::level::level_enum level, spdlog::format_string_t<Args...> fmt, Args &&...args) {
+			if (m_Logger && level >= CEE_LOG_ACTIVE_LEVEL)
+				m_Logger->log(level, fmt, std::forward<Args>(args)...);
+		}
+
+	private:
+		std::unique_ptr<platform::PCF8591> m_Adc;
+		float m_SampleRate;
+		Pacing m_Pacing;
+		Logger m_Logger;
+		EventLog *m_Events;
+
+		SampleScheduler m_Scheduler;
+		std::thread m_Thread;
+		std::atomic<bool> m_Running;
+		SampleQueue m_Queue;
+
+		std::array<SampleProcessor *, MAX_PROCESSORS> m_Processors;
+		std::size_t m_ProcessorCount;
+		std::array<Sample, BLOCK_SIZE> m_Block;
+		std::size_t m_BlockFill;
+
+		std::atomic<uint64_t> m_SampleCount;
+		std::atomic<uint64_t> m_DroppedCount;
+		std::atomic<uint64_t> m_ErrorCount;
+	};
+}
+
+#endif
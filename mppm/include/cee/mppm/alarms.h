@@ -0,0 +1,159 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_MPPM_ALARMS_H_
+#define CEE_MPPM_ALARMS_H_
+
+#include <cee/core/seqlock.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace cee {
+	enum class AlarmPriority : uint8_t {
+		NONE = 0,
+		LOW,
+		MEDIUM,
+		HIGH,
+	};
+
+	enum class AlarmState : uint8_t {
+		INACTIVE = 0,
+		ACTIVE,
+		// The condition has cleared but the alarm has not been acknowledged
+		LATCHED,
+	};
+
+	struct AlarmConfig {
+		enum class Kind : uint8_t {
+			// Value outside [low, high]
+			LIMIT = 0,
+			// Value changing faster than maxRate per second
+			RATE,
+			// Condition reported directly, such as a lead off
+			TECHNICAL,
+		};
+
+		const char *name = "";
+		Kind kind = Kind::TECHNICAL;
+		AlarmPriority priority = AlarmPriority::LOW;
+		float low = -std::numeric_limits<float>::infinity();
+		float high = std::numeric_limits<float>::infinity();
+		float maxRate = std::numeric_limits<float>::infinity();
+		// Seconds the rate is measured over
+		float rateWindow = 10.f;
+		// How far back inside a limit or rate a value must come to clear
+		// an active alarm
+		float hysteresis = 0.f;
+		// Seconds a condition has to hold before the alarm is raised
+		float onsetDelay = 0.f;
+		// Keep the alarm LATCHED once its condition clears until it is
+		// acknowledged
+		bool latching = false;
+	};
+
+	struct AlarmStatus {
+		AlarmState state = AlarmState::INACTIVE;
+		bool acknowledged = false;
+		// 1 above the high limit or rising too fast, -1 below the low limit
+		// or falling too fast, 0 for technical alarms
+		int8_t direction = 0;
+		// Value, or rate, that raised the alarm
+		float value = 0.f;
+		// Timestamp of the sample that raised the alarm, nanoseconds
+		uint64_t onset = 0;
+	};
+
+	/*
+	 * Limit, rate of change and technical alarms evaluated on the
+	 * acquisition thread as values are produced, so onset latency is a
+	 * matter of samples rather than frames.
+	 *
+	 * Alarms are added up front, after which Update() and SetCondition()
+	 * are called by a single evaluating thread with sample timestamps, and
+	 * Publish() once per block hands a snapshot to other threads through a
+	 * SeqLock whenever something changed. Acknowledging from another
+	 * thread only sets an atomic flag that the next Publish() applies.
+	 */
+	class AlarmEngine {
+	public:
+		static constexpr std::size_t MAX_ALARMS = 16;
+		using Id = std::size_t;
+
+		struct Snapshot {
+			std::array<AlarmStatus, MAX_ALARMS> alarms;
+			// Highest priority among unacknowledged active and latched alarms
+			AlarmPriority highest = AlarmPriority::NONE;
+			// Most recent alarm of that priority
+			int8_t highestAlarm = -1;
+		};
+
+	public:
+		AlarmEngine();
+
+		AlarmEngine(const AlarmEngine &) = delete;
+		AlarmEngine &operator=(const AlarmEngine &) = delete;
+
+		// Only before evaluation starts, ids are given out in order from 0
+		Id Add(const AlarmConfig &config);
+		std::size_t GetCount() const { return m_Count; }
+		const AlarmConfig &GetConfig(Id id) const { return m_Configs[id]; }
+
+		// Evaluating thread. A NaN value is unavailable, which clears limit
+		// conditions and restarts rate measurement.
+		void Update(Id id, float value, uint64_t timestamp);
+		void SetCondition(Id id, bool condition, uint64_t timestamp);
+		void Publish();
+		void Reset();
+
+		// Any thread
+		Snapshot GetSnapshot() const { return m_Published.Load(); }
+		uint64_t GetVersion() const { return m_Published.GetVersion(); }
+		void Acknowledge(Id id);
+		void AcknowledgeAll();
+
+	private:
+		struct Tracker {
+			bool pending = false;
+			uint64_t pendingSince = 0;
+			bool haveReference = false;
+			float reference = 0.f;
+			uint64_t referenceTime = 0;
+		};
+
+		void Evaluate(Id id, bool condition, int8_t direction, float value, uint64_t timestamp);
+		void UpdateHighest();
+
+	private:
+		std::array<AlarmConfig, MAX_ALARMS> m_Configs;
+		std::size_t m_Count;
+
+		std::array<Tracker, MAX_ALARMS> m_Trackers;
+		Snapshot m_Snapshot;
+		bool m_Changed;
+
+		// One bit per alarm
+		std::atomic<uint32_t> m_Acknowledge;
+		SeqLock<Snapshot> m_Published;
+	};
+}
+
+#endif
@@ -0,0 +1,114 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_MPPM_ANALYSIS_H_
+#define CEE_MPPM_ANALYSIS_H_
+
+#include <cee/mppm/signals.h>
+
+#include <cee/core/thread_pool.h>
+
+#include <cee/dsp/decimate.h>
+#include <cee/dsp/nibp.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace cee {
+	struct AnalysisOptions {
+		float mainsFrequency = 50.f;
+		// Of the recorded channels, as given to the SignalChain. Taken from
+		// each recording's header unless overridden here, and 1 with CIC
+		// for recordings that don't store them.
+		std::optional<std::size_t> oversampling;
+		std::optional<dsp::DecimatorKind> decimator;
+		// Seconds of recording analysed by one task
+		double segmentDuration = 600.0;
+		// Seconds run through the chain ahead of a segment and discarded,
+		// long enough for the filters and QRS detector to settle and for
+		// a cuff measurement in progress to complete
+		double warmup = 120.0;
+	};
+
+	// Of a processed channel over a whole recording, in plot units
+	struct ChannelSummary {
+		float min = 0.f;
+		float max = 0.f;
+		float mean = 0.f;
+		float stdDev = 0.f;
+		uint64_t count = 0;
+	};
+
+	struct NibpMeasurement {
+		// Of the block the result came out of, CLOCK_MONOTONIC nanoseconds
+		uint64_t timestamp = 0;
+		dsp::NibpResult result;
+	};
+
+	struct AnalysisResult {
+		std::string path;
+		// What stopped part or all of the recording being analysed, empty
+		// when all of it was
+		std::string error;
+		float sampleRate = 0.f;
+		float outputRate = 0.f;
+		// What the channels were decimated with
+		std::size_t oversampling = 1;
+		dsp::DecimatorKind decimator = dsp::DecimatorKind::CIC;
+		// Recorded samples analysed, and the seconds they span
+		uint64_t sampleCount = 0;
+		double duration = 0.0;
+		std::size_t segmentCount = 0;
+		// The recording had no index and was scanned
+		bool recovered = false;
+
+		uint64_t beatCount = 0;
+		// Beats per minute, over the time the rate was known, 0 if it never was
+		float minHeartRate = 0.f;
+		float maxHeartRate = 0.f;
+		float meanHeartRate = 0.f;
+		std::array<ChannelSummary, SignalChain::CHANNEL_COUNT> channels;
+		std::vector<NibpMeasurement> nibp;
+
+		bool IsValid() const { return error.empty(); }
+	};
+
+	/*
+	 * Runs recordings through the SignalChain the monitor uses, QRS
+	 * detection, NIBP and statistics included, as fast as the cores allow.
+	 *
+	 * Each recording becomes a task on the pool, which plans segments of
+	 * whole chunks and submits one task per segment. Every segment opens
+	 * the recording itself and gets a chain of its own, started warmup
+	 * seconds early, so segments share nothing and the pool's idle workers
+	 * steal them from whichever recording still has the most left.
+	 * Segment results are merged in order once all tasks are done.
+	 *
+	 * Returns one result per path, in the same order. Errors are reported
+	 * in the results rather than thrown.
+	 */
+	std::vector<AnalysisResult> AnalyseRecordings(ThreadPool &pool, std::span<const std::string> paths,
+			const AnalysisOptions &options = {});
+}
+
+#endif
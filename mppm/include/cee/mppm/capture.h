@@ -0,0 +1,95 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CEE_MPPM_CAPTURE_H_
+#define CEE_MPPM_CAPTURE_H_
+
+#include <cee/mppm/acquisition.h>
+
+#include <cee/core/log.h>
+#include <cee/core/ringbuffer.h>
+
+#include <cee/platform/i2c_capture.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <thread>
+
+namespace cee {
+	/*
+	 * Writes every acquired sample to a raw ADC capture that the replay
+	 * I2C backend can play back. Like Recorder it runs as a processor on
+	 * the acquisition thread, only copying samples into a lock-free queue
+	 * that its own thread drains into the I2CCaptureWriter, so file I/O
+	 * never lands on the acquisition thread or the render loop.
+	 *
+	 * Samples the writer can't keep up with are dropped and counted. Once
+	 * a write fails nothing more is captured.
+	 */
+	class Capturer : public SampleProcessor {
+	public:
+		static constexpr std::size_t QUEUE_SIZE = 16384;
+		static constexpr std::chrono::seconds FLUSH_INTERVAL{ 10 };
+		static constexpr std::chrono::milliseconds POLL_INTERVAL{ 100 };
+
+	public:
+		// Creates the file, throws core::FileError if that fails
+		Capturer(const std::string &path, float sampleRate, Logger logger = nullptr);
+		~Capturer();
+
+		Capturer(const Capturer &) = delete;
+		Capturer &operator=(const Capturer &) = delete;
+
+		void Start();
+		// Writes out what is queued and flushes the capture
+		void Stop();
+		bool IsRunning() const { return m_Running.load(std::memory_order_relaxed); }
+
+		virtual void Process(std::span<const Sample> samples) override;
+
+		uint64_t GetCapturedCount() const { return m_CapturedCount.load(std::memory_order_relaxed); }
+		uint64_t GetDroppedCount() const { return m_DroppedCount.load(std::memory_order_relaxed); }
+		bool HasFailed() const { return m_Failed.load(std::memory_order_relaxed); }
+
+	private:
+		void ThreadMain();
+		// Returns the number of samples taken off the queue
+		std::size_t Drain();
+
+		template<typename ...Args>
+		void Log(spdlog::level::level_enum level, spdlog::format_string_t<Args...> fmt, Args &&...args) {
+			if (m_Logger && level >= CEE_LOG_ACTIVE_LEVEL)
+				m_Logger->log(level, fmt, std::forward<Args>(args)...);
+		}
+
+	private:
+		platform::I2CCaptureWriter m_Writer;
+		Logger m_Logger;
+		SPSCRingBuffer<Sample, QUEUE_SIZE> m_Queue;
+
+		std::thread m_Thread;
+		std::atomic<bool> m_Running;
+		std::atomic<bool> m_Failed;
+		std::atomic<uint64_t> m_CapturedCount;
+		std::atomic<uint64_t> m_DroppedCount;
+	};
+}
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_MPPM_CODEC_H_
+#define CEE_MPPM_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace cee {
+	/*
+	 * Lossless codec for recorded planes of samples. A plane starts with its
+	 * first value and first difference, then every CODEC_BLOCK_SIZE
+	 * following samples become a block: a descriptor byte and the block's
+	 * residuals, zig-zag encoded and bit-packed LSB first at the width of
+	 * the largest.
+	 *
+	 * Each block picks whichever of first or second order prediction gives
+	 * the narrower residuals. Arithmetic wraps at the width of the samples,
+	 * so ADC codes never need more than 8 bits, and a steady stream of
+	 * timestamps packs down to its jitter.
+	 *
+	 * Decoding returns false if the input is malformed, and consumes the
+	 * plane from the front of in otherwise. ADC codes are decoded with the
+	 * SIMD prefix sums from cee/dsp/simd.h.
+	 */
+	constexpr std::size_t CODEC_BLOCK_SIZE = 32;
+
+	void EncodePlane(std::span<const uint8_t> codes, std::vector<uint8_t> &out);
+	void EncodePlane(std::span<const uint64_t> timestamps, std::vector<uint8_t> &out);
+
+	bool DecodePlane(std::span<const uint8_t> &in, std::span<uint8_t> codes);
+	bool DecodePlane(std::span<const uint8_t> &in, std::span<uint64_t> timestamps);
+}
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_MPPM_EXPORT_H_
+#define CEE_MPPM_EXPORT_H_
+
+#include <string>
+
+namespace cee {
+	/*
+	 * Export of recordings to EDF+ and PhysioNet WFDB. Both stream the
+	 * recording a chunk at a time through fixed buffers, so memory does not
+	 * grow with the length of the session, and convert the ADC codes of a
+	 * chunk in SIMD blocks.
+	 *
+	 * Every recorded ADC channel is exported with its 8 bit codes as the
+	 * digital values, offset to code - 128. Physical values are in
+	 * fractions of the ADC's full scale, or mmHg for the cuff pressure.
+	 *
+	 * Throw core::FileError when the recording can't be read or the
+	 * output can't be written.
+	 */
+
+	// EDF+ with one data record a second, plus the annotation signal EDF+
+	// requires. A gap in the timestamps that outlasts the current record
+	// closes it and the next record starts at the sample after the gap,
+	// making the file discontinuous EDF+D. Shorter gaps are filled by
+	// holding the last sample, and without longer ones the file is EDF+C.
+	// Records cut short, the last included, are padded the same way.
+	void ExportEdf(const std::string &recording, const std::string &path);
+
+	// WFDB record of recordPath.hea and recordPath.dat, the record named
+	// after the last component of recordPath. Samples are interleaved in
+	// format 80, a byte each.
+	void ExportWfdb(const std::string &recording, const std::string &recordPath);
+}
+
+#endif
@@ -21,12 +21,12 @@
 
 #include <cee/mppm/mppm.h>
 
-#define CEE_CORE_DEBUG(...)       ::cee::MPPM::GetLogger()->debug(__VA_ARGS__)
-#define CEE_CORE_TRACE(...)       ::cee::MPPM::GetLogger()->trace(__VA_ARGS__)
-#define CEE_CORE_INFO(...)        ::cee::MPPM::GetLogger()->info(__VA_ARGS__)
-#define CEE_CORE_WARN(...)        ::cee::MPPM::GetLogger()->warn(__VA_ARGS__)
-#define CEE_CORE_ERROR(...)       ::cee::MPPM::GetLogger()->error(__VA_ARGS__)
-#define CEE_CORE_CRITICAL(...)    ::cee::MPPM::GetLogger()->critical(__VA_ARGS__)
+#define CEE_CORE_DEBUG(...)       CEE_LOG_DEBUG(::cee::MPPM::GetLogger(), __VA_ARGS__)
+#define CEE_CORE_TRACE(...)       CEE_LOG_TRACE(::cee::MPPM::GetLogger(), __VA_ARGS__)
+#define CEE_CORE_INFO(...)        CEE_LOG_INFO(::cee::MPPM::GetLogger(), __VA_ARGS__)
+#define CEE_CORE_WARN(...)        CEE_LOG_WARN(::cee::MPPM::GetLogger(), __VA_ARGS__)
+#define CEE_CORE_ERROR(...)       CEE_LOG_ERROR(::cee::MPPM::GetLogger(), __VA_ARGS__)
+#define CEE_CORE_CRITICAL(...)    CEE_LOG_CRITICAL(::cee::MPPM::GetLogger(), __VA_ARGS__)
 
 #endif
 
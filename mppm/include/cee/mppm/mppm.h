@@ -19,18 +19,38 @@
 #ifndef CEE_MPPM_H_
 #define CEE_MPPM_H_
 
+#include <cee/mppm/acquisition.h>
+#include <cee/mppm/capture.h>
 #include <cee/mppm/event.h>
+#include <cee/mppm/recorder.h>
+#include <cee/mppm/signals.h>
 
 #include <cee/core/log.h>
 
 #include <cee/platform/gfx.h>
 #include <cee/platform/i2c.h>
 
+#include <array>
 #include <memory>
+#include <span>
+#include <string>
 #include <vector>
 
 namespace cee {
+namespace gui {
+	class Plot;
+}
+
 class MPPM {
+public:
+	// Samples across a plot, also the window its range is taken over
+	static constexpr std::size_t PLOT_SAMPLES = 1000;
+	// Spans of the trend views, in nanoseconds, that the t key cycles
+	// through after the live waveforms
+	static constexpr std::array<uint64_t, 2> TREND_SPANS = {
+		3600 * TrendStore::SECOND, 24 * 3600 * TrendStore::SECOND
+	};
+
 public:
 	MPPM(int argc, char *argv[]);
 	~MPPM();
@@ -56,16 +76,40 @@ private:
 
 private:
 	void ParseCommandLineArgs(int argc, char *argv[]);
+	void DrainSamples();
+	// Fills the plots with the trends of the current view whenever a
+	// second has been added to them
+	void UpdateTrends(std::span<gui::Plot *const, SignalChain::CHANNEL_COUNT> plots);
 
 private:
 	bool m_Running;
 	std::unique_ptr<Log> m_Log;
-	spdlog::level::level_enum m_LogLevel;
+	spdlog::level::level_enum m_LogLevel = spdlog::level::info;
+	LogMode m_LogMode = LogMode::ASYNC_DROP;
 	std::string m_LogFile;
+	// Binary per-frame and per-read-error diagnostics, off unless given a file
+	std::string m_EventsFile;
+	std::unique_ptr<EventLog> m_Events;
 	platform::GfxContextType m_GfxBackend = platform::GfxContextType::PLATFORM_GFX_CONTEXT_NONE;
 	platform::I2CContextType m_I2CBackend = platform::I2CContextType::PLATFORM_I2C_CONTEXT_NONE;
 	std::shared_ptr<platform::I2CController> m_I2CController;
-	std::unique_ptr<platform::PCF8591> m_Adc;
+	// Rate of the displayed channels, the ADC samples m_Oversampling times
+	// faster
+	float m_SampleRate = 250.f;
+	float m_MainsFrequency = 50.f;
+	// ADC samples per displayed sample, decimated by m_Decimator
+	std::size_t m_Oversampling = 1;
+	dsp::DecimatorKind m_Decimator = dsp::DecimatorKind::CIC;
+	int m_RealtimePriority = 0;
+	bool m_Unthrottled = false;
+	// Waveform config of the mock backend or capture to replay
+	std::string m_I2CFile;
+	std::string m_CaptureFile;
+	std::string m_RecordFile;
+	std::unique_ptr<SignalChain> m_SignalChain;
+	std::unique_ptr<Recorder> m_Recorder;
+	std::unique_ptr<Acquisition> m_Acquisition;
+	std::unique_ptr<Capturer> m_Capture;
 	std::unique_ptr<platform::GraphicsContext> m_GfxContext;
 
 	std::vector<float> m_LeadII;
@@ -74,6 +118,12 @@ private:
 	int m_PresPos;
 	std::vector<float> m_Osc;
 	int m_OscPos;
+	// 0 for the live waveforms, otherwise one past the index of the trend span
+	std::size_t m_TrendView = 0;
+	// Newest second of the trends on display
+	uint64_t m_TrendSecond = 0;
+	std::vector<TrendPoint> m_TrendPoints;
+	std::vector<float> m_TrendData;
 
 private:
 	static MPPM *s_Instance;
@@ -0,0 +1,103 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_MPPM_RECORDER_H_
+#define CEE_MPPM_RECORDER_H_
+
+#include <cee/mppm/acquisition.h>
+#include <cee/mppm/recording.h>
+
+#include <cee/core/log.h>
+#include <cee/core/ringbuffer.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <thread>
+
+namespace cee {
+	/*
+	 * Records every acquired sample of every ADC channel. Run as a
+	 * processor on the acquisition thread it only copies samples into a
+	 * lock-free queue, which its own thread drains into chunks of
+	 * CHUNK_SAMPLES and hands to a RecordingWriter. Neither the acquisition
+	 * thread nor the render loop ever waits on the file.
+	 *
+	 * Buffered data is flushed to the device every FLUSH_INTERVAL, which
+	 * bounds what a crash can lose. Samples the writer can't keep up with
+	 * are dropped and counted rather than holding up acquisition.
+	 */
+	class Recorder : public SampleProcessor {
+	public:
+		static constexpr std::size_t QUEUE_SIZE = 16384;
+		static constexpr std::size_t CHUNK_SAMPLES = 1024;
+		static constexpr std::chrono::seconds FLUSH_INTERVAL{ 10 };
+		static constexpr std::chrono::milliseconds POLL_INTERVAL{ 100 };
+
+	public:
+		// Creates the file, throws core::FileError if that fails. The
+		// oversampling and decimator the signal chain uses are stored in
+		// the header for offline analysis.
+		Recorder(const std::string &path, float sampleRate, std::size_t oversampling = 1,
+				dsp::DecimatorKind decimator = dsp::DecimatorKind::CIC, Logger logger = nullptr);
+		~Recorder();
+
+		Recorder(const Recorder &) = delete;
+		Recorder &operator=(const Recorder &) = delete;
+
+		void Start();
+		// Writes out what is queued and closes the recording
+		void Stop();
+		bool IsRunning() const { return m_Running.load(std::memory_order_relaxed); }
+
+		virtual void Process(std::span<const Sample> samples) override;
+
+		uint64_t GetRecordedCount() const { return m_RecordedCount.load(std::memory_order_relaxed); }
+		uint64_t GetDroppedCount() const { return m_DroppedCount.load(std::memory_order_relaxed); }
+		// The file could not be written, nothing more is recorded
+		bool HasFailed() const { return m_Failed.load(std::memory_order_relaxed); }
+
+	private:
+		void ThreadMain();
+		// Returns the number of samples taken off the queue
+		std::size_t Drain();
+		void WriteChunk();
+
+		template<typename ...Args>
+		void Log(spdlog::level::level_enum level, spdlog::format_string_t<Args...> fmt, Args &&...args) {
+			if (m_Logger && level >= CEE_LOG_ACTIVE_LEVEL)
+				m_Logger->log(level, fmt, std::forward<Args>(args)...);
+		}
+
+	private:
+		RecordingWriter m_Writer;
+		Logger m_Logger;
+		SPSCRingBuffer<Sample, QUEUE_SIZE> m_Queue;
+		RecordingChunk m_Chunk;
+
+		std::thread m_Thread;
+		std::atomic<bool> m_Running;
+		std::atomic<bool> m_Failed;
+		std::atomic<uint64_t> m_RecordedCount;
+		std::atomic<uint64_t> m_DroppedCount;
+	};
+}
+
+#endif
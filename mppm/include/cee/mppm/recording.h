@@ -0,0 +1,242 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_MPPM_RECORDING_H_
+#define CEE_MPPM_RECORDING_H_
+
+#include <cee/dsp/decimate.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cee {
+	/*
+	 * Append-only recording of every ADC channel. The file is a header, a
+	 * run of chunks and, once the recording is closed, an index of the
+	 * chunks and a footer pointing at it:
+	 *
+	 *   RecordingHeader
+	 *   RecordingChunkHeader, payload
+	 *   ...
+	 *   RecordingIndexEntry[chunkCount]
+	 *   RecordingFooter
+	 *
+	 * Headers, chunk payloads and the index each carry a CRC-32. A recording
+	 * cut short by a crash or power loss has no footer, and readers rebuild
+	 * the index from the chunks up to the first damaged or truncated one.
+	 *
+	 * A RAW payload holds the timestamps of the chunk's samples followed by
+	 * one plane of ADC codes per channel. PACKED payloads hold the same
+	 * planes in the same order, each compressed with the codec in
+	 * cee/mppm/codec.h. Timestamps are CLOCK_MONOTONIC in nanoseconds, the
+	 * header pairs the monotonic and real time clocks at the start of the
+	 * recording. Fields are stored in host byte order.
+	 *
+	 * The header also records how the monitor decimated the channels, as
+	 * the samples are stored at the ADC's rate. Recordings made before that
+	 * was stored have an oversampling of 0.
+	 */
+	enum class RecordingEncoding : uint16_t {
+		RAW = 0,
+		PACKED,
+	};
+
+	struct RecordingHeader {
+		static constexpr char MAGIC[8] = { 'C', 'E', 'E', 'R', 'E', 'C', 'R', 'D' };
+		static constexpr uint32_t VERSION = 1;
+
+		char magic[8];
+		uint32_t version;
+		uint32_t headerSize;     // Offset of the first chunk
+		float sampleRate;
+		uint8_t channelCount;
+		uint8_t oversampling;    // ADC rate over the processed rate, 0 when not recorded
+		uint8_t decimator;       // dsp::DecimatorKind
+		uint8_t reserved;
+		uint64_t startTime;      // CLOCK_REALTIME at startMonotonic, nanoseconds
+		uint64_t startMonotonic; // CLOCK_MONOTONIC, nanoseconds
+		uint32_t reserved2;
+		uint32_t crc;            // Of the bytes before it
+
+		bool IsValid() const;
+	};
+	static_assert(sizeof(RecordingHeader) == 48, "Recording header layout changed");
+
+	struct RecordingChunkHeader {
+		static constexpr uint32_t MAGIC = 0x4B4E4843; // "CHNK"
+
+		uint32_t magic;
+		uint16_t encoding;       // RecordingEncoding
+		uint16_t channelCount;
+		uint32_t sampleCount;
+		uint32_t payloadSize;
+		uint64_t firstSample;    // Index of the first sample in the recording
+		uint64_t firstTimestamp;
+		uint64_t lastTimestamp;
+		uint32_t payloadCrc;
+		uint32_t crc;            // Of the bytes before it
+
+		bool IsValid() const;
+	};
+	static_assert(sizeof(RecordingChunkHeader) == 48, "Recording chunk header layout changed");
+
+	struct RecordingIndexEntry {
+		uint64_t offset;         // Of the chunk header
+		uint64_t firstSample;
+		uint64_t firstTimestamp;
+		uint64_t lastTimestamp;
+	};
+	static_assert(sizeof(RecordingIndexEntry) == 32, "Recording index layout changed");
+
+	struct RecordingFooter {
+		static constexpr char MAGIC[8] = { 'C', 'E', 'E', 'R', 'I', 'D', 'X', '1' };
+
+		char magic[8];
+		uint64_t indexOffset;
+		uint64_t chunkCount;
+		uint64_t sampleCount;
+		uint32_t indexCrc;
+		uint32_t crc;            // Of the bytes before it
+
+		bool IsValid() const;
+	};
+	static_assert(sizeof(RecordingFooter) == 40, "Recording footer layout changed");
+
+	// The samples of one chunk, one plane per channel
+	struct RecordingChunk {
+		uint64_t firstSample = 0;
+		std::vector<uint64_t> timestamps;
+		std::vector<std::vector<uint8_t>> channels;
+
+		std::size_t GetSampleCount() const { return timestamps.size(); }
+		void Clear();
+	};
+
+	/*
+	 * Writes a recording through a staging buffer, handing the file
+	 * WRITE_SIZE aligned blocks so small chunks don't each cost a write to
+	 * the SD card. Only what has been flushed survives a crash. Not thread
+	 * safe, the Recorder owns one on its writer thread.
+	 *
+	 * Errors throw core::FileError.
+	 */
+	class RecordingWriter {
+	public:
+		static constexpr std::size_t WRITE_SIZE = 64 * 1024;
+
+	public:
+		RecordingWriter(const std::string &path, float sampleRate, int channelCount,
+				RecordingEncoding encoding = RecordingEncoding::PACKED, std::size_t oversampling = 1,
+				dsp::DecimatorKind decimator = dsp::DecimatorKind::CIC);
+		~RecordingWriter();
+
+		RecordingWriter(const RecordingWriter &) = delete;
+		RecordingWriter &operator=(const RecordingWriter &) = delete;
+
+		// Empty chunks are skipped, firstSample is assigned here
+		void Write(const RecordingChunk &chunk);
+		// Writes out everything buffered and syncs it to the device. A tail
+		// short of WRITE_SIZE stays buffered and is written again with the
+		// block it starts, so writes stay aligned
+		void Flush();
+		// Writes the index and footer, after which nothing can be written
+		void Close();
+
+		bool IsOpen() const { return m_Fd >= 0; }
+		RecordingEncoding GetEncoding() const { return m_Encoding; }
+		int GetChannelCount() const { return m_ChannelCount; }
+		uint64_t GetChunkCount() const { return m_Index.size(); }
+		uint64_t GetSampleCount() const { return m_SampleCount; }
+
+	private:
+		void Append(const void *data, std::size_t size);
+		// Writes the first size bytes of the buffer and drops them from it
+		void WriteOut(std::size_t size);
+		// Writes the first size bytes of the buffer at their file offset
+		void WriteAt(std::size_t size);
+		void Sync();
+
+	private:
+		std::string m_Path;
+		int m_Fd;
+		int m_ChannelCount;
+		RecordingEncoding m_Encoding;
+		uint64_t m_SampleCount;
+		// File offset of the end of the buffered data
+		uint64_t m_Offset;
+		std::vector<uint8_t> m_Buffer;
+		std::vector<uint8_t> m_Payload;
+		std::vector<RecordingIndexEntry> m_Index;
+	};
+
+	/*
+	 * Random access to a recording. Only the index is held in memory,
+	 * chunks are read on demand, so memory use does not grow with the
+	 * length of the recording. Seeking by sample or time is a binary search
+	 * of the index.
+	 *
+	 * Errors throw core::FileError.
+	 */
+	class RecordingReader {
+	public:
+		explicit RecordingReader(const std::string &path);
+		~RecordingReader();
+
+		RecordingReader(const RecordingReader &) = delete;
+		RecordingReader &operator=(const RecordingReader &) = delete;
+
+		const RecordingHeader &GetHeader() const { return m_Header; }
+		float GetSampleRate() const { return m_Header.sampleRate; }
+		int GetChannelCount() const { return m_Header.channelCount; }
+		// 0 when the recording predates it being stored
+		std::size_t GetOversampling() const { return m_Header.oversampling; }
+		dsp::DecimatorKind GetDecimator() const { return static_cast<dsp::DecimatorKind>(m_Header.decimator); }
+		uint64_t GetSampleCount() const { return m_SampleCount; }
+		std::size_t GetChunkCount() const { return m_Index.size(); }
+		const RecordingIndexEntry &GetChunkInfo(std::size_t chunk) const { return m_Index[chunk]; }
+		// The footer was missing or damaged and the index was rebuilt
+		bool IsRecovered() const { return m_Recovered; }
+
+		// Chunk holding the sample, GetChunkCount() if it's past the end
+		std::size_t FindSample(uint64_t sample) const;
+		// Last chunk starting at or before the timestamp, the first if none do
+		std::size_t FindTime(uint64_t timestamp) const;
+
+		void ReadChunk(std::size_t chunk, RecordingChunk &out);
+
+	private:
+		bool ReadFooter(uint64_t fileSize);
+		void ScanChunks(uint64_t fileSize);
+		bool ReadChunkHeader(uint64_t offset, uint64_t fileSize, RecordingChunkHeader &header);
+		bool DecodePayload(const RecordingChunkHeader &header, RecordingChunk &out) const;
+		void ReadAt(void *data, std::size_t size, uint64_t offset) const;
+
+	private:
+		std::string m_Path;
+		int m_Fd;
+		RecordingHeader m_Header;
+		std::vector<RecordingIndexEntry> m_Index;
+		uint64_t m_SampleCount;
+		bool m_Recovered;
+		std::vector<uint8_t> m_Payload;
+	};
+}
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_MPPM_SCHEDULER_H_
+#define CEE_MPPM_SCHEDULER_H_
+
+#include <cee/core/log.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace cee {
+	struct JitterStats {
+		uint64_t wakeups;
+		uint64_t missedDeadlines;
+		// Wakeup lateness relative to the deadline, in microseconds
+		double min;
+		double mean;
+		double p99;
+		double max;
+	};
+
+	/*
+	 * Log-linear histogram of wakeup lateness in nanoseconds. Values below
+	 * SUB_BUCKETS get a bucket each, above that every power of two is split
+	 * into SUB_BUCKETS buckets, bounding the relative error of a percentile
+	 * to 1/SUB_BUCKETS. Recording is wait-free and meant for a single
+	 * writer; readers on other threads get a consistent-enough snapshot.
+	 */
+	class JitterHistogram {
+	public:
+		static constexpr int SUB_BUCKET_BITS = 4;
+		static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+		static constexpr int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+	public:
+		JitterHistogram() { Reset(); }
+
+		void Record(uint64_t value);
+		void Reset();
+
+		uint64_t GetCount() const { return m_Count.load(std::memory_order_relaxed); }
+		uint64_t GetMin() const { return m_Min.load(std::memory_order_relaxed); }
+		uint64_t GetMax() const { return m_Max.load(std::memory_order_relaxed); }
+		double GetMean() const;
+		// Upper bound of the bucket holding the given percentile (0-100)
+		uint64_t GetPercentile(double percentile) const;
+
+		static constexpr int BucketIndex(uint64_t value) {
+			if (value < SUB_BUCKETS)
+				return static_cast<int>(value);
+			int msb = 63 - __builtin_clzll(value);
+			int shift = msb - SUB_BUCKET_BITS;
+			return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS +
+				static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+		}
+
+		static constexpr uint64_t BucketUpperBound(int index) {
+			if (index < SUB_BUCKETS)
+				return static_cast<uint64_t>(index);
+			int msb = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+			int shift = msb - SUB_BUCKET_BITS;
+			uint64_t base = (uint64_t(SUB_BUCKETS) | uint64_t(index % SUB_BUCKETS)) << shift;
+			return base + ((uint64_t(1) << shift) - 1);
+		}
+
+	private:
+		std::array<std::atomic<uint64_t>, BUCKET_COUNT> m_Buckets;
+		std::atomic<uint64_t> m_Count;
+		std::atomic<uint64_t> m_Sum;
+		std::atomic<uint64_t> m_Min;
+		std::atomic<uint64_t> m_Max;
+	};
+
+	/*
+	 * Fixed-rate periodic wakeups driven by a CLOCK_MONOTONIC timerfd with
+	 * absolute deadlines, so the period never drifts with the time spent
+	 * between wakeups. The lateness of every wakeup is recorded and any
+	 * periods that expired without a wakeup are counted as missed deadlines.
+	 *
+	 * Start() and Wait() must be called from the thread being paced, as
+	 * Start() also applies the optional SCHED_FIFO priority to that thread.
+	 */
+	class SampleScheduler {
+	public:
+		SampleScheduler(float rate, int realtimePriority = 0, Logger logger = nullptr);
+		~SampleScheduler();
+
+		SampleScheduler(const SampleScheduler &) = delete;
+		SampleScheduler &operator=(const SampleScheduler &) = delete;
+
+		void Start();
+		void Stop();
+
+		// Blocks until the next deadline. Returns the number of periods that
+		// elapsed since the previous wakeup, which is 1 unless deadlines
+		// were missed, or 0 if the wait was interrupted.
+		uint64_t Wait();
+		// Accounts for one wakeup, lateness nanoseconds after its deadline
+		// and expirations periods after the previous one. Wait() calls this,
+		// it is public so the accounting can be driven without a timer.
+		void RecordWakeup(uint64_t lateness, uint64_t expirations);
+
+		uint64_t GetPeriod() const { return m_PeriodNs; }
+		JitterStats GetStats() const;
+		void ResetStats();
+
+	private:
+		template<typename ...Args>
+		void Log(spdlog::level::level_enum level, spdlog::format_string_t<Args...> fmt, Args &&...args) {
+			if (m_Logger && level >= CEE_LOG_ACTIVE_LEVEL)
+				m_Logger->log(level, fmt, std::forward<Args>(args)...);
+		}
+
+	private:
+		uint64_t m_PeriodNs;
+		int m_RealtimePriority;
+		Logger m_Logger;
+
+		int m_TimerFd;
+		uint64_t m_StartNs;
+		uint64_t m_Expirations;
+
+		JitterHistogram m_Lateness;
+		std::atomic<uint64_t> m_MissedDeadlines;
+	};
+}
+
+#endif
@@ -0,0 +1,232 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_MPPM_SIGNALS_H_
+#define CEE_MPPM_SIGNALS_H_
+
+#include <cee/mppm/acquisition.h>
+#include <cee/mppm/alarms.h>
+#include <cee/mppm/config.h>
+#include <cee/mppm/trends.h>
+
+#include <cee/core/ringbuffer.h>
+#include <cee/core/seqlock.h>
+
+#include <cee/dsp/decimate.h>
+#include <cee/dsp/filter.h>
+#include <cee/dsp/fixed.h>
+#include <cee/dsp/nibp.h>
+#include <cee/dsp/pipeline.h>
+#include <cee/dsp/qrs.h>
+#include <cee/dsp/stages.h>
+#include <cee/dsp/statistics.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace cee {
+	/*
+	 * Per-channel processing of acquired samples, run on the acquisition
+	 * thread. Each displayed channel is run through its own pipeline and
+	 * queued for the render loop as float, already scaled to the [0, 1]
+	 * range the plots expect.
+	 *
+	 * The pipelines and statistics run on Value samples, float or, when
+	 * built with CEE_FIXED_POINT_DSP, Q15 for boards without a capable FPU.
+	 * Processed blocks only become float where they leave the chain.
+	 *
+	 * Channels may be oversampled by the ADC, in which case every pipeline
+	 * starts by decimating back to the output rate with the chosen filter,
+	 * trading the extra samples for resolution. Everything after that,
+	 * plots included, runs at the output rate.
+	 *
+	 * Lead II has baseline wander removed, mains interference notched out
+	 * and is band limited to 40 Hz, after which it is re-centred and fed to
+	 * the QRS detector that provides the heart rate. Pressure
+	 * keeps its DC level but is notched and band limited to 20 Hz, and the
+	 * oscillation channel is smoothed with a linear phase FIR. Both feed the
+	 * NIBP engine, which queues a result for every cuff measurement.
+	 *
+	 * Rolling statistics of every processed channel are kept over the last
+	 * statisticsWindow samples, the span of a plot, and published once per
+	 * block.
+	 *
+	 * Every processed channel and the heart rate are also added to a
+	 * TrendStore, from which views of hours to days are drawn.
+	 *
+	 * Alarms on the heart rate, its rate of change, the mean arterial
+	 * pressure, lead off and ADC failure are evaluated here as well. Lead
+	 * off and ADC failure are evaluated for every sample and read error,
+	 * timing their onsets to the sample, the rest as their values are
+	 * produced. Samples are handed over in blocks of Acquisition::BLOCK_SIZE,
+	 * so an alarm is published at most a block after its cause, 32 ms at
+	 * 250 Hz. An ADC failure only clears after a sustained run of good
+	 * reads, so intermittent errors raise it as well.
+	 *
+	 * Trends and alarms are only kept when monitoring. Offline analysis
+	 * builds the chain without them, skipping the trend store's memory and
+	 * the alarm evaluation it has no use for.
+	 */
+	class SignalChain : public SampleProcessor {
+	public:
+		enum Channel : int {
+			LEAD_II = 0,
+			PRESSURE,
+			OSCILLATION,
+
+			CHANNEL_COUNT
+		};
+
+		static constexpr std::size_t OUTPUT_QUEUE_SIZE = 4096;
+		using OutputQueue = SPSCRingBuffer<float, OUTPUT_QUEUE_SIZE>;
+		using NibpQueue = SPSCRingBuffer<dsp::NibpResult, 4>;
+
+#if CEE_FIXED_POINT_DSP
+		using Value = dsp::Q15;
+#else
+		using Value = float;
+#endif
+
+		// mmHg at the top of the pressure transducer's ADC range
+		static constexpr float PRESSURE_FULL_SCALE = 300.f;
+
+		using Statistics = dsp::RollingStatistics<Value, 4096>;
+		static constexpr std::size_t DEFAULT_STATISTICS_WINDOW = 1000;
+
+		// Ids in the alarm engine
+		enum Alarm : AlarmEngine::Id {
+			HEART_RATE_LIMIT = 0,
+			HEART_RATE_CHANGE,
+			MEAN_PRESSURE_LIMIT,
+			LEAD_OFF,
+			ADC_FAILURE,
+
+			ALARM_COUNT
+		};
+
+		// Series in the trend store, the channels then the heart rate
+		static constexpr std::size_t HEART_RATE_TREND = CHANNEL_COUNT;
+		static constexpr std::size_t TREND_COUNT = CHANNEL_COUNT + 1;
+
+		struct ChannelStatistics {
+			float min = 0.f;
+			float max = 0.f;
+			float mean = 0.f;
+			float stdDev = 0.f;
+			// Samples behind the values, up to the window
+			uint32_t count = 0;
+		};
+
+	public:
+		SignalChain(float sampleRate, float mainsFrequency = 50.f,
+				std::size_t statisticsWindow = DEFAULT_STATISTICS_WINDOW, std::size_t oversampling = 1,
+				dsp::DecimatorKind decimator = dsp::DecimatorKind::CIC, bool monitoring = true);
+
+		virtual void Process(std::span<const Sample> samples) override;
+		virtual void OnReadError(uint64_t timestamp) override;
+		void Reset();
+
+		OutputQueue &GetOutput(Channel channel) { return m_Outputs[channel]; }
+		NibpQueue &GetNibpResults() { return m_NibpResults; }
+		// Snapshots and acknowledgement are safe from any thread. Throws
+		// core::UsageError when not monitoring.
+		AlarmEngine &GetAlarms();
+		// Safe to call from any thread
+		ChannelStatistics GetStatistics(Channel channel) const { return m_PublishedStatistics[channel].Load(); }
+		uint64_t GetStatisticsVersion(Channel channel) const { return m_PublishedStatistics[channel].GetVersion(); }
+		// Queries are safe from any thread. Throws core::UsageError when not
+		// monitoring.
+		const TrendStore &GetTrends() const;
+		bool IsMonitoring() const { return m_Alarms != nullptr; }
+		float GetSampleRate() const { return m_SampleRate; }
+		// Rate of the processed channels, the sample rate over the oversampling
+		float GetOutputRate() const { return m_OutputRate; }
+		// Resolution the decimator adds to the ADC's, for white noise
+		double GetBitsGained() const { return m_LeadII.Get<Decimator>().GetBitsGained(); }
+		float GetMainsFrequency() const { return m_MainsFrequency; }
+		uint64_t GetDroppedCount() const { return m_DroppedCount.load(std::memory_order_relaxed); }
+		// Averaged and beat-to-beat heart rate in beats per minute, 0 when unknown
+		float GetHeartRate() const { return m_HeartRate.load(std::memory_order_relaxed); }
+		// False with the leads off or before the detector has seen an
+		// interval. A known rate of 0 means beats have stopped.
+		bool IsHeartRateKnown() const { return m_HeartRateKnown.load(std::memory_order_relaxed); }
+		float GetBeatRate() const { return m_BeatRate.load(std::memory_order_relaxed); }
+		uint64_t GetBeatCount() const { return m_BeatCount.load(std::memory_order_relaxed); }
+
+	private:
+		// Returns the processed block, which has also been queued
+		template<typename P>
+		std::span<const float> RunChannel(P &pipeline, Channel channel, std::span<const Sample> samples);
+		// Whether the sample has Lead II at a rail
+		static bool IsLeadOff(const Sample &sample);
+		// Whether every sample of the block has
+		static bool IsLeadOff(std::span<const Sample> samples);
+		void UpdateAlarms(std::span<const Sample> samples);
+
+	private:
+		// ADC input of every channel
+		static constexpr std::array<int, CHANNEL_COUNT> ADC_INPUTS = { 0, 1, 2 };
+
+		// High-pass, notch, then a 4th order low-pass
+		using LeadIIFilter = dsp::BiquadCascade<4, Value>;
+		// Notch, then a 4th order low-pass
+		using PressureFilter = dsp::BiquadCascade<3, Value>;
+		using OscillationFilter = dsp::Fir<31, Value>;
+
+		using Decimator = dsp::Decimator<Value>;
+
+		using LeadIIPipeline = dsp::Pipeline<Value, dsp::Scale<Value>, Decimator, LeadIIFilter, dsp::Scale<Value>>;
+		using PressurePipeline = dsp::Pipeline<Value, dsp::Scale<Value>, Decimator, PressureFilter>;
+		using OscillationPipeline = dsp::Pipeline<Value, dsp::Scale<Value>, Decimator, OscillationFilter>;
+
+		float m_SampleRate;
+		float m_OutputRate;
+		float m_MainsFrequency;
+		LeadIIPipeline m_LeadII;
+		PressurePipeline m_Pressure;
+		OscillationPipeline m_Oscillation;
+
+		dsp::QrsDetector m_Qrs;
+		dsp::NibpEngine m_Nibp;
+		uint64_t m_NibpCount;
+		// Timestamp of the last failed read, which is recent while failing
+		uint64_t m_LastReadError;
+		bool m_ReadFailing;
+		// Both null when not monitoring
+		std::unique_ptr<AlarmEngine> m_Alarms;
+
+		std::array<std::array<Value, Acquisition::BLOCK_SIZE>, CHANNEL_COUNT> m_Blocks;
+		// Processed blocks as float, unused when Value is float
+		std::array<std::array<float, Acquisition::BLOCK_SIZE>, CHANNEL_COUNT> m_FloatBlocks;
+		std::array<Statistics, CHANNEL_COUNT> m_Statistics;
+		std::array<SeqLock<ChannelStatistics>, CHANNEL_COUNT> m_PublishedStatistics;
+		std::unique_ptr<TrendStore> m_Trends;
+
+		std::array<OutputQueue, CHANNEL_COUNT> m_Outputs;
+		NibpQueue m_NibpResults;
+		std::atomic<uint64_t> m_DroppedCount;
+		std::atomic<float> m_HeartRate;
+		std::atomic<bool> m_HeartRateKnown;
+		std::atomic<float> m_BeatRate;
+		std::atomic<uint64_t> m_BeatCount;
+	};
+}
+
+#endif
@@ -0,0 +1,146 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_MPPM_TRENDS_H_
+#define CEE_MPPM_TRENDS_H_
+
+#include <cee/core/seqlock.h>
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace cee {
+	// Extrema and mean of a series over a span of time
+	struct TrendPoint {
+		float min = std::numeric_limits<float>::quiet_NaN();
+		float max = std::numeric_limits<float>::quiet_NaN();
+		float mean = std::numeric_limits<float>::quiet_NaN();
+
+		// Nothing was recorded over the span
+		bool IsValid() const { return !std::isnan(mean); }
+	};
+
+	/*
+	 * Min, max and mean of a number of series over hours to days, kept as
+	 * a pyramid of levels of decreasing resolution. Every level is a ring
+	 * of buckets of a fixed duration covering the level's retention, the
+	 * finest ones kept the shortest.
+	 *
+	 * Values are added by a single writer, the acquisition thread, into
+	 * the open bucket of the finest level. Each time that bucket closes it
+	 * is stored and merged into the open bucket of every coarser level,
+	 * which is stored again as it grows, so all levels are current to the
+	 * second and nothing is ever rescanned.
+	 *
+	 * Queries may come from any thread. Each pixel is answered from the
+	 * coarsest level whose buckets are no wider than a pixel, so reading at
+	 * most a level ratio of buckets per pixel whatever the time range.
+	 * Buckets are published through a SeqLock each and carry their index,
+	 * so a slot the ring has since reused reads as a gap.
+	 */
+	class TrendStore {
+	public:
+		struct Level {
+			// Nanoseconds per bucket
+			uint64_t duration;
+			// Buckets kept
+			std::size_t capacity;
+		};
+
+		static constexpr uint64_t SECOND = 1000000000;
+		static constexpr std::size_t LEVEL_COUNT = 4;
+		// Every duration a multiple of the finest
+		static constexpr std::array<Level, LEVEL_COUNT> LEVELS = {{
+			// 1 s for 6 hours
+			{ SECOND, 6 * 3600 },
+			// 10 s for 24 hours
+			{ 10 * SECOND, 24 * 360 },
+			// 1 min for 3 days
+			{ 60 * SECOND, 3 * 24 * 60 },
+			// 10 min for a week
+			{ 600 * SECOND, 7 * 24 * 6 },
+		}};
+
+	public:
+		explicit TrendStore(std::size_t seriesCount);
+
+		TrendStore(const TrendStore &) = delete;
+		TrendStore &operator=(const TrendStore &) = delete;
+
+		// Writer thread. Values are counted in the bucket of timestamp, in
+		// nanoseconds, and NaN values are skipped.
+		void Push(std::size_t series, std::span<const float> values, uint64_t timestamp);
+		void Push(std::size_t series, float value, uint64_t timestamp);
+		// Forgets everything, not safe with concurrent queries
+		void Reset();
+
+		// Any thread. Splits [start, end) evenly across points, points
+		// without data are left invalid.
+		void Query(std::size_t series, uint64_t start, uint64_t end, std::span<TrendPoint> points) const;
+		// Timestamp of the latest value, 0 before the first
+		uint64_t GetLatest() const { return m_Latest.load(std::memory_order_acquire); }
+		std::size_t GetSeriesCount() const { return m_Series.size(); }
+
+	private:
+		static constexpr uint32_t EMPTY = std::numeric_limits<uint32_t>::max();
+
+		// Sum and count rather than the mean, so buckets holding different
+		// numbers of values aggregate with the right weights
+		struct Bucket {
+			uint32_t index = EMPTY;
+			uint32_t count;
+			float min;
+			float max;
+			double sum;
+		};
+
+		struct Accumulator {
+			uint64_t index = std::numeric_limits<uint64_t>::max();
+			float min = 0.f;
+			float max = 0.f;
+			double sum = 0.0;
+			uint64_t count = 0;
+		};
+
+		struct Series {
+			std::array<std::unique_ptr<SeqLock<Bucket>[]>, LEVEL_COUNT> buckets;
+			// Open bucket of every level, writer only
+			std::array<Accumulator, LEVEL_COUNT> open;
+		};
+
+		void Open(Series &series, uint64_t timestamp);
+		// Stores the finest open bucket and merges it into the coarser ones
+		void Close(Series &series);
+		void Store(Series &series, std::size_t level);
+		// Leaves point invalid when the level has nothing in [start, end)
+		void Aggregate(const Series &series, std::size_t level, uint64_t start, uint64_t end, TrendPoint &point) const;
+
+	private:
+		std::vector<Series> m_Series;
+		std::atomic<uint64_t> m_Latest;
+	};
+}
+
+#endif
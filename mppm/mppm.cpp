@@ -34,24 +34,47 @@
 
 #include <glad/gles2.h>
 
+#include <array>
 #include <chrono>
+#include <cmath>
 #include <csignal>
 #include <filesystem>
 #include <functional>
+#include <limits>
+#include <string>
 
 #include <getopt.h>
+#include <sched.h>
 #include <linux/input-event-codes.h>
 #include <xkbcommon/xkbcommon-keysyms.h>
 
 enum {
-	ARG_LOGFILE = 1
+	ARG_LOGFILE = 1,
+	ARG_RT_PRIORITY,
+	ARG_UNTHROTTLED,
+	ARG_CAPTURE,
+	ARG_MAINS,
+	ARG_OVERSAMPLE,
+	ARG_DECIMATOR,
+	ARG_RECORD,
+	ARG_LOG_MODE,
+	ARG_EVENTS
 };
 
-static const char *g_OptString = "g:i:l:hv";
+static const char *g_OptString = "g:i:l:r:hv";
 static const option g_LongOptions[] = {
 	{ "help", no_argument, nullptr, 'h' },
 	{ "version", no_argument, nullptr, 'v' },
 	{ "logfile", required_argument, nullptr, ARG_LOGFILE },
+	{ "log-mode", required_argument, nullptr, ARG_LOG_MODE },
+	{ "events", required_argument, nullptr, ARG_EVENTS },
+	{ "rt-priority", required_argument, nullptr, ARG_RT_PRIORITY },
+	{ "unthrottled", no_argument, nullptr, ARG_UNTHROTTLED },
+	{ "capture", required_argument, nullptr, ARG_CAPTURE },
+	{ "mains", required_argument, nullptr, ARG_MAINS },
+	{ "oversample", required_argument, nullptr, ARG_OVERSAMPLE },
+	{ "decimator", required_argument, nullptr, ARG_DECIMATOR },
+	{ "record", required_argument, nullptr, ARG_RECORD },
 	{ nullptr, 0, nullptr, 0 }
 };
 
@@ -59,6 +82,15 @@ namespace cee {
 static void PrintHelpMessage(const char *cmd);
 static void PrintVersion(const char *cmd);
 
+// Banner colour per AlarmPriority, cyan, yellow and red as is usual for
+// low, medium and high priority
+static constexpr std::array<gui::Color, 4> ALARM_COLORS = {{
+	{ 1.0f, 1.0f, 1.0f, 1.0f },
+	{ 0.1f, 0.9f, 0.9f, 1.0f },
+	{ 1.0f, 0.9f, 0.1f, 1.0f },
+	{ 1.0f, 0.1f, 0.1f, 1.0f },
+}};
+
 MPPM* MPPM::s_Instance = nullptr;
 
 MPPM::MPPM(int argc, char *argv[]) {
@@ -70,7 +102,11 @@ MPPM::MPPM(int argc, char *argv[]) {
 	}
 	s_Instance = this;
 
-	m_Log = std::make_unique<Log>("MPPM", m_LogFile, m_LogLevel);
+	m_Log = std::make_unique<Log>("MPPM", m_LogFile, m_LogLevel, m_LogMode);
+	if (!m_EventsFile.empty()) {
+		m_Events = std::make_unique<EventLog>(m_EventsFile);
+		CEE_CORE_INFO("Writing events to {}", m_EventsFile);
+	}
 
 	rng<int>::Init();
 
@@ -111,16 +147,30 @@ MPPM::MPPM(int argc, char *argv[]) {
 #endif
 	}
 
+	// The channels are displayed at the sample rate, the ADC runs
+	// oversampling times faster and the signal chain decimates back down
+	float adcRate = m_SampleRate * static_cast<float>(m_Oversampling);
 	if (m_I2CBackend == platform::I2CContextType::PLATFORM_I2C_CONTEXT_HW) {
 		CEE_CORE_DEBUG("Using I2C interface {}", "/dev/i2c-0");
 		m_I2CController = platform::I2CController::Create("/dev/i2c-0",
 				platform::I2CContextType::PLATFORM_I2C_CONTEXT_HW,
 				m_Log->CreateChild("I2C"));
 	} else if (m_I2CBackend == platform::I2CContextType::PLATFORM_I2C_CONTEXT_MOCK) {
-		CEE_CORE_DEBUG("Using mock I2C interface");
-		m_I2CController = platform::I2CController::Create("/dev/i2c-0",
+		// The simulated rate matches the ADC rate unless overridden
+		std::string config = fmt::format("rate={},{}", adcRate, m_I2CFile);
+		CEE_CORE_DEBUG("Using mock I2C interface ({})", config);
+		m_I2CController = platform::I2CController::Create(config,
 				platform::I2CContextType::PLATFORM_I2C_CONTEXT_MOCK,
 				m_Log->CreateChild("I2C"));
+	} else if (m_I2CBackend == platform::I2CContextType::PLATFORM_I2C_CONTEXT_REPLAY) {
+		// Play back at the rate the capture was taken at
+		platform::I2CCaptureHeader header = platform::ReadI2CCaptureHeader(m_I2CFile);
+		adcRate = header.sampleRate;
+		m_SampleRate = adcRate / static_cast<float>(m_Oversampling);
+		CEE_CORE_DEBUG("Replaying I2C capture {} at {} Hz", m_I2CFile, adcRate);
+		m_I2CController = platform::I2CController::Create(m_I2CFile,
+				platform::I2CContextType::PLATFORM_I2C_CONTEXT_REPLAY,
+				m_Log->CreateChild("I2C"));
 	} else {
 		CEE_CORE_ERROR("No I2C backend detected!");
 		throw core::UsageError("No I2C backend detected");
@@ -130,12 +180,39 @@ MPPM::MPPM(int argc, char *argv[]) {
 		throw core::InternalError("Failed to create I2C interface");
 
 	m_GfxContext->Init();
-	m_Adc = std::make_unique<platform::PCF8591>(m_I2CController, 0x48);
+	m_Acquisition = std::make_unique<Acquisition>(
+			std::make_unique<platform::PCF8591>(m_I2CController, 0x48),
+			adcRate, m_Unthrottled ? Acquisition::Pacing::UNTHROTTLED : Acquisition::Pacing::REALTIME,
+			m_RealtimePriority, m_Log->CreateChild("ACQ"));
+	m_SignalChain = std::make_unique<SignalChain>(adcRate, m_MainsFrequency, PLOT_SAMPLES,
+			m_Oversampling, m_Decimator);
+	if (m_Oversampling > 1) {
+		CEE_CORE_INFO("Oversampling {}x with {} decimation to {} Hz, {:.2f} bits gained", m_Oversampling,
+				dsp::Decimator<float>::KindName(m_Decimator), m_SignalChain->GetOutputRate(),
+				m_SignalChain->GetBitsGained());
+	}
+	m_Acquisition->AddProcessor(m_SignalChain.get());
+	m_Acquisition->SetEventLog(m_Events.get());
+	if (!m_RecordFile.empty()) {
+		CEE_CORE_INFO("Recording to {}", m_RecordFile);
+		m_Recorder = std::make_unique<Recorder>(m_RecordFile, adcRate, m_Oversampling, m_Decimator,
+				m_Log->CreateChild("REC"));
+		m_Acquisition->AddProcessor(m_Recorder.get());
+	}
+	if (!m_CaptureFile.empty()) {
+		CEE_CORE_INFO("Capturing ADC data to {}", m_CaptureFile);
+		m_Capture = std::make_unique<Capturer>(m_CaptureFile, adcRate, m_Log->CreateChild("CAP"));
+		m_Acquisition->AddProcessor(m_Capture.get());
+	}
 
 	gui::Init(m_Log->CreateChild("GUI"));
 }
 
 MPPM::~MPPM() {
+	m_Acquisition.reset();
+	m_Recorder.reset();
+	m_Capture.reset();
+	m_Events.reset();
 	gui::Shutdown();
 	m_GfxContext->Shutdown();
 	m_I2CController.reset();
@@ -154,30 +231,32 @@ int MPPM::Run() {
 	std::unique_ptr<gui::Plot> line1Plot = gui::CreateNode<gui::Plot>(
 			gui::Color{ 0.1f, 1.0f, 0.1f, 1.0f });
 	std::unique_ptr<gui::Text> line1Num = gui::CreateNode<gui::Text>(
-			"167", 48, gui::Color{ 0.1f, 1.0f, 0.1f, 1.0f });
+			"---", 48, gui::Color{ 0.1f, 1.0f, 0.1f, 1.0f });
 	auto line2Box = gui::CreateNode<gui::Box>();
 	auto line2GraphBox = gui::CreateNode<gui::Box>();
 	auto line2TextBox = gui::CreateNode<gui::Box>();
 	std::unique_ptr<gui::Plot> line2Plot = gui::CreateNode<gui::Plot>(
 			gui::Color{ 1.0f, 0.1f, 0.1f, 1.0f });
 	std::unique_ptr<gui::Text> line2Num = gui::CreateNode<gui::Text>(
-			"0", 48, gui::Color{ 1.0f, 0.1f, 0.1f, 1.0f });
+			"---", 48, gui::Color{ 1.0f, 0.1f, 0.1f, 1.0f });
 	auto line3Box = gui::CreateNode<gui::Box>();
 	auto line3GraphBox = gui::CreateNode<gui::Box>();
 	auto line3TextBox = gui::CreateNode<gui::Box>();
 	std::unique_ptr<gui::Plot> line3Plot = gui::CreateNode<gui::Plot>(
 			gui::Color{ 0.5f, 0.2f, 0.2f, 1.0f });
 	std::unique_ptr<gui::Text> line3Num = gui::CreateNode<gui::Text>(
-			"0", 48, gui::Color{ 0.5f, 0.2f, 0.2f, 1.0f });
+			"---", 48, gui::Color{ 0.5f, 0.2f, 0.2f, 1.0f });
+	std::unique_ptr<gui::Text> alarmText = gui::CreateNode<gui::Text>(
+			"", 32, gui::Color{ 1.0f, 1.0f, 1.0f, 1.0f });
 
 	{
 		PROFILE_SCOPE("Setup GUI");
 
-		m_LeadII.resize(1000, 0.f);
+		m_LeadII.resize(PLOT_SAMPLES, 0.f);
 		m_LeadIIPos = 0;
-		m_Pres.resize(1000, 0.f);
+		m_Pres.resize(PLOT_SAMPLES, 0.f);
 		m_PresPos = 0;
-		m_Osc.resize(1000, 0.f);
+		m_Osc.resize(PLOT_SAMPLES, 0.f);
 		m_OscPos = 0;
 
 		root->SetDebugName("root");
@@ -185,6 +264,7 @@ int MPPM::Run() {
 		gui::SetRootNode(root.get());
 
 		vbox->SetDebugName("vbox");
+		alarmText->SetDebugName("alarmText");
 		line1Box->SetDebugName("line1Box");
 		line1GraphBox->SetDebugName("line1GraphBox");
 		line1TextBox->SetDebugName("line1TextBox");
@@ -215,28 +295,40 @@ int MPPM::Run() {
 		line1Box->Resize(620.f, 250.f);
 		line1GraphBox->Resize(500.f, 250.f);
 		line1TextBox->Resize(120.f, 250.f);
-		line1Plot->ResizeData(1000);
+		line1Plot->ResizeData(PLOT_SAMPLES);
 		line2Box->Resize(620.f, 250.f);
 		line2GraphBox->Resize(500.f, 250.f);
 		line2TextBox->Resize(120.f, 250.f);
-		line2Plot->ResizeData(1000);
+		line2Plot->ResizeData(PLOT_SAMPLES);
 		line3Box->Resize(620.f, 250.f);
 		line3GraphBox->Resize(500.f, 250.f);
 		line3TextBox->Resize(120.f, 250.f);
-		line3Plot->ResizeData(1000);
+		line3Plot->ResizeData(PLOT_SAMPLES);
 
 		line1Plot->SetLineBreakWidth(10);
 		line2Plot->SetLineBreakWidth(10);
 		line3Plot->SetLineBreakWidth(10);
 
+		// Ranges follow the statistics of the processed channels. The
+		// minimum spans, in ADC full scale, keep a flat line from filling
+		// the plot with noise.
+		line1Plot->SetAutoRange(true);
+		line1Plot->SetMinimumSpan(0.1f);
+		line2Plot->SetAutoRange(true);
+		line2Plot->SetMinimumSpan(0.1f);
+		line3Plot->SetAutoRange(true);
+		line3Plot->SetMinimumSpan(0.05f);
+
 		line1Plot->Show(true);
 		line1Num->Show(true);
 		line2Plot->Show(true);
 		line2Num->Show(true);
 		line3Plot->Show(true);
 		line3Num->Show(true);
+		alarmText->Show(true);
 
 		root->AddChild(vbox.get());
+		vbox->AddChild(alarmText.get());
 		vbox->AddChild(line1Box.get());
 		line1Box->AddChild(line1GraphBox.get());
 		line1Box->AddChild(line1TextBox.get());
@@ -257,19 +349,89 @@ int MPPM::Run() {
 	std::chrono::time_point start = std::chrono::high_resolution_clock::now();
 	std::chrono::duration<size_t, std::micro> delta;
 
+	if (m_Recorder)
+		m_Recorder->Start();
+	if (m_Capture)
+		m_Capture->Start();
+	m_Acquisition->Start();
+
+	// Readouts are only rebuilt when their value changes, -1 being unknown
+	long heartRate = -1;
+	uint64_t alarmVersion = 0;
+	std::array<uint64_t, SignalChain::CHANNEL_COUNT> statisticsVersions{};
+	std::array<gui::Plot *, SignalChain::CHANNEL_COUNT> plots{};
+	plots[SignalChain::LEAD_II] = line1Plot.get();
+	plots[SignalChain::PRESSURE] = line2Plot.get();
+	plots[SignalChain::OSCILLATION] = line3Plot.get();
+	uint64_t frame = 0;
+
 	m_Running = true;
 	while (m_Running) {
 		PROFILE_SCOPE("Main loop");
 
+		DrainSamples();
+
+		// Asystole reads 0, only an unknown rate reads as dashes
+		long rate = m_SignalChain->IsHeartRateKnown() ? std::lround(m_SignalChain->GetHeartRate()) : -1;
+		if (rate != heartRate) {
+			heartRate = rate;
+			line1Num->SetText(rate >= 0 ? std::to_string(rate) : "---");
+		}
+		if (m_SignalChain->GetAlarms().GetVersion() != alarmVersion) {
+			const AlarmEngine &alarms = m_SignalChain->GetAlarms();
+			alarmVersion = alarms.GetVersion();
+			AlarmEngine::Snapshot snapshot = alarms.GetSnapshot();
+			if (snapshot.highestAlarm < 0) {
+				alarmText->SetText("");
+			} else {
+				const AlarmConfig &config = alarms.GetConfig(snapshot.highestAlarm);
+				const AlarmStatus &status = snapshot.alarms[snapshot.highestAlarm];
+				const char *direction = status.direction > 0 ? " high" : status.direction < 0 ? " low" : "";
+				alarmText->SetText(fmt::format("{}{}{}", config.name, direction,
+							status.state == AlarmState::LATCHED ? " (cleared)" : ""));
+				alarmText->SetColor(ALARM_COLORS[static_cast<int>(snapshot.highest)]);
+				CEE_CORE_WARN("Alarm: {}{}", config.name, direction);
+			}
+		}
+		dsp::NibpResult nibp;
+		while (m_SignalChain->GetNibpResults().TryDequeue(nibp)) {
+			if (nibp.IsValid()) {
+				CEE_CORE_INFO("NIBP {:.0f}/{:.0f} ({:.0f}) mmHg from {} pulses",
+						nibp.systolic, nibp.diastolic, nibp.mean, nibp.pulseCount);
+				line2Num->SetText(fmt::format("{:.0f}/{:.0f}", nibp.systolic, nibp.diastolic));
+				line3Num->SetText(fmt::format("({:.0f})", nibp.mean));
+			} else {
+				CEE_CORE_WARN("NIBP measurement failed, {} after {} pulses",
+						dsp::NibpResult::StatusName(nibp.status), nibp.pulseCount);
+				line2Num->SetText("---");
+				line3Num->SetText("---");
+			}
+		}
+
+		for (int channel = 0; m_TrendView == 0 && channel < SignalChain::CHANNEL_COUNT; ++channel) {
+			SignalChain::Channel c = static_cast<SignalChain::Channel>(channel);
+			uint64_t version = m_SignalChain->GetStatisticsVersion(c);
+			if (version == statisticsVersions[channel])
+				continue;
+			statisticsVersions[channel] = version;
+			SignalChain::ChannelStatistics statistics = m_SignalChain->GetStatistics(c);
+			if (statistics.count > 0)
+				plots[channel]->SetExtrema(statistics.min, statistics.max);
+		}
+
 		float windowWidth = static_cast<float>(m_GfxContext->GetWidth());
 		float windowHeight = static_cast<float>(m_GfxContext->GetHeight());
 		gui::BeginFrame({ windowWidth, windowHeight });
-		line1Plot->SetData(m_LeadII.data(), m_LeadII.size());
-		line1Plot->SetLineBreakPos(m_LeadIIPos);
-		line2Plot->SetData(m_Pres.data(), m_Pres.size());
-		line2Plot->SetLineBreakPos(m_PresPos);
-		line3Plot->SetData(m_Osc.data(), m_Osc.size());
-		line3Plot->SetLineBreakPos(m_OscPos);
+		if (m_TrendView == 0) {
+			line1Plot->SetData(m_LeadII.data(), m_LeadII.size());
+			line1Plot->SetLineBreakPos(m_LeadIIPos);
+			line2Plot->SetData(m_Pres.data(), m_Pres.size());
+			line2Plot->SetLineBreakPos(m_PresPos);
+			line3Plot->SetData(m_Osc.data(), m_Osc.size());
+			line3Plot->SetLineBreakPos(m_OscPos);
+		} else {
+			UpdateTrends(plots);
+		}
 		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
 		gui::Render({ windowWidth, windowHeight });
@@ -283,25 +445,6 @@ int MPPM::Run() {
 			ApplicationPageFlip flip;
 			OnEvent(flip);
 
-			m_Adc->SendControl(0, false, platform::PCF8591::InputMode::SINGLE_ENDED, false);
-			uint8_t adcCh0 = m_Adc->Read();
-			m_LeadII[m_LeadIIPos++] = adcCh0 / 255.f;
-			if (m_LeadIIPos == 1000) {
-				m_LeadIIPos = 0;
-			}
-			m_Adc->SendControl(1, false, platform::PCF8591::InputMode::SINGLE_ENDED, false);
-			uint8_t adcCh1 = m_Adc->Read();
-			m_Pres[m_PresPos++] = adcCh1 / 255.f;
-			if (m_PresPos == 1000) {
-				m_PresPos = 0;
-			}
-			m_Adc->SendControl(2, false, platform::PCF8591::InputMode::SINGLE_ENDED, false);
-			uint8_t adcCh2 = m_Adc->Read();
-			m_Osc[m_OscPos++] = adcCh2 / 255.f;
-			if (m_OscPos == 1000) {
-				m_OscPos = 0;
-			}
-
 			Input::Poll();
 			if (gui::HandleEvents() < 0) {
 				CEE_CORE_WARN("Failed to handle GUI events");
@@ -309,14 +452,92 @@ int MPPM::Run() {
 
 			delta = std::chrono::duration_cast<std::chrono::microseconds>(high_resolution_clock::now() - start);
 			start = high_resolution_clock::now();
+			if (m_Events)
+				CEE_EVENT(*m_Events, "Frame {} took {} us", frame, delta.count());
+			++frame;
 			ApplicationTickEvent tick(static_cast<float>(delta.count()) / 1000.f);
 			OnEvent(tick);
 		}
 	}
 
+	m_Acquisition->Stop();
+	if (m_Recorder)
+		m_Recorder->Stop();
+	if (m_Capture)
+		m_Capture->Stop();
+
 	return EXIT_SUCCESS;
 }
 
+static void DrainChannel(SignalChain::OutputQueue &queue, std::vector<float> &data, int &pos) {
+	std::array<float, 256> values;
+	std::size_t count;
+	std::size_t drained = 0;
+	// Bounded so an unthrottled source can't keep the frame from finishing
+	while (drained < SignalChain::OUTPUT_QUEUE_SIZE && (count = queue.DequeueSpan(values)) > 0) {
+		drained += count;
+		for (std::size_t i = 0; i < count; ++i) {
+			data[pos++] = values[i];
+			if (pos == static_cast<int>(data.size())) {
+				pos = 0;
+			}
+		}
+	}
+}
+
+void MPPM::DrainSamples() {
+	PROFILE_FUNCTION();
+	// The plots are fed with the processed channels, raw samples are only
+	// taken off the queue so it doesn't fill up
+	std::array<Sample, 64> samples;
+	std::size_t count;
+	std::size_t drained = 0;
+	while (drained < Acquisition::QUEUE_SIZE &&
+			(count = m_Acquisition->GetQueue().DequeueSpan(samples)) > 0)
+		drained += count;
+
+	DrainChannel(m_SignalChain->GetOutput(SignalChain::LEAD_II), m_LeadII, m_LeadIIPos);
+	DrainChannel(m_SignalChain->GetOutput(SignalChain::PRESSURE), m_Pres, m_PresPos);
+	DrainChannel(m_SignalChain->GetOutput(SignalChain::OSCILLATION), m_Osc, m_OscPos);
+}
+
+void MPPM::UpdateTrends(std::span<gui::Plot *const, SignalChain::CHANNEL_COUNT> plots) {
+	PROFILE_FUNCTION();
+	const TrendStore &trends = m_SignalChain->GetTrends();
+	// Buckets only close once a second
+	const uint64_t latest = trends.GetLatest();
+	const uint64_t second = latest / TrendStore::SECOND;
+	if (second == m_TrendSecond)
+		return;
+	m_TrendSecond = second;
+
+	const uint64_t end = second * TrendStore::SECOND;
+	const uint64_t span = TREND_SPANS[m_TrendView - 1];
+	const uint64_t start = end > span ? end - span : 0;
+	m_TrendPoints.resize(PLOT_SAMPLES);
+	m_TrendData.resize(PLOT_SAMPLES);
+	for (int channel = 0; channel < SignalChain::CHANNEL_COUNT; ++channel) {
+		trends.Query(channel, start, end, m_TrendPoints);
+		// Gaps hold the previous mean, the extrema cover the whole view
+		float value = 0.f;
+		float min = std::numeric_limits<float>::infinity();
+		float max = -std::numeric_limits<float>::infinity();
+		for (std::size_t i = 0; i < PLOT_SAMPLES; ++i) {
+			const TrendPoint &point = m_TrendPoints[i];
+			if (point.IsValid()) {
+				value = point.mean;
+				min = std::min(min, point.min);
+				max = std::max(max, point.max);
+			}
+			m_TrendData[i] = value;
+		}
+		plots[channel]->SetData(m_TrendData.data(), m_TrendData.size());
+		plots[channel]->SetLineBreakPos(PLOT_SAMPLES);
+		if (min <= max)
+			plots[channel]->SetExtrema(min, max);
+	}
+}
+
 void MPPM::OnEvent(Event& e) {
 	PROFILE_SCOPE("Event dispatch");
 	EventDispatcher dispatcher(e);
@@ -336,6 +557,16 @@ void MPPM::OnKeyPress(KeyUpEvent &e) {
 		CEE_CORE_INFO("q key pressed, exiting...");
 		ApplicationExitEvent exitEvent;
 		OnEvent(exitEvent);
+	} else if (e.GetKeycode() == KEY_A) {
+		CEE_CORE_INFO("Acknowledging alarms");
+		m_SignalChain->GetAlarms().AcknowledgeAll();
+	} else if (e.GetKeycode() == KEY_T) {
+		m_TrendView = (m_TrendView + 1) % (TREND_SPANS.size() + 1);
+		m_TrendSecond = 0;
+		if (m_TrendView == 0)
+			CEE_CORE_INFO("Showing live waveforms");
+		else
+			CEE_CORE_INFO("Showing {} hour trends", TREND_SPANS[m_TrendView - 1] / (3600 * TrendStore::SECOND));
 	}
 }
 
@@ -410,11 +641,27 @@ void MPPM::ParseCommandLineArgs(int argc, char *argv[]) {
 				m_I2CBackend = platform::I2CContextType::PLATFORM_I2C_CONTEXT_HW;
 			} else if (strcmp(optarg, "mock") == 0) {
 				m_I2CBackend = platform::I2CContextType::PLATFORM_I2C_CONTEXT_MOCK;
+			} else if (strncmp(optarg, "mock:", 5) == 0) {
+				m_I2CBackend = platform::I2CContextType::PLATFORM_I2C_CONTEXT_MOCK;
+				m_I2CFile = optarg + 5;
+			} else if (strncmp(optarg, "replay:", 7) == 0 && optarg[7] != '\0') {
+				m_I2CBackend = platform::I2CContextType::PLATFORM_I2C_CONTEXT_REPLAY;
+				m_I2CFile = optarg + 7;
 			} else {
 				std::fprintf(stderr, "Invalid i2c backend: %s\n", optarg);
 				PrintHelpMessage(argv[0]);
 			}
 			break;
+		case 'r': {
+			char *end = nullptr;
+			float rate = std::strtof(optarg, &end);
+			if (end == optarg || *end != '\0' || !(rate > 0.f)) {
+				std::fprintf(stderr, "Invalid sample rate: %s\n", optarg);
+				PrintHelpMessage(argv[0]);
+			}
+			m_SampleRate = rate;
+			break;
+		}
 		case 'l':
 			if (strcmp(optarg, "debug") == 0) {
 				m_LogLevel = spdlog::level::debug;
@@ -439,6 +686,74 @@ void MPPM::ParseCommandLineArgs(int argc, char *argv[]) {
 			m_LogFile = optarg;
 			break;
 		}
+		case ARG_EVENTS:
+			m_EventsFile = optarg;
+			break;
+		case ARG_LOG_MODE:
+			if (strcmp(optarg, "drop") == 0) {
+				m_LogMode = LogMode::ASYNC_DROP;
+			} else if (strcmp(optarg, "block") == 0) {
+				m_LogMode = LogMode::ASYNC_BLOCK;
+			} else if (strcmp(optarg, "sync") == 0) {
+				m_LogMode = LogMode::SYNC;
+			} else {
+				std::fprintf(stderr, "Invalid log mode: %s\n", optarg);
+				PrintHelpMessage(argv[0]);
+			}
+			break;
+		case ARG_RT_PRIORITY: {
+			char *end = nullptr;
+			long priority = std::strtol(optarg, &end, 10);
+			if (end == optarg || *end != '\0' || priority < sched_get_priority_min(SCHED_FIFO) ||
+					priority > sched_get_priority_max(SCHED_FIFO)) {
+				std::fprintf(stderr, "Invalid realtime priority: %s\n", optarg);
+				PrintHelpMessage(argv[0]);
+			}
+			m_RealtimePriority = static_cast<int>(priority);
+			break;
+		}
+		case ARG_UNTHROTTLED:
+			m_Unthrottled = true;
+			break;
+		case ARG_CAPTURE:
+			m_CaptureFile = optarg;
+			break;
+		case ARG_RECORD:
+			m_RecordFile = optarg;
+			break;
+		case ARG_MAINS:
+			if (strcmp(optarg, "50") == 0) {
+				m_MainsFrequency = 50.f;
+			} else if (strcmp(optarg, "60") == 0) {
+				m_MainsFrequency = 60.f;
+			} else {
+				std::fprintf(stderr, "Invalid mains frequency: %s\n", optarg);
+				PrintHelpMessage(argv[0]);
+			}
+			break;
+		case ARG_OVERSAMPLE: {
+			char *end = nullptr;
+			long factor = std::strtol(optarg, &end, 10);
+			if (end == optarg || *end != '\0' || factor < 1 ||
+					factor > static_cast<long>(dsp::Decimator<float>::MAX_FACTOR)) {
+				std::fprintf(stderr, "Invalid oversampling factor: %s\n", optarg);
+				PrintHelpMessage(argv[0]);
+			}
+			m_Oversampling = static_cast<std::size_t>(factor);
+			break;
+		}
+		case ARG_DECIMATOR:
+			if (strcmp(optarg, "average") == 0) {
+				m_Decimator = dsp::DecimatorKind::AVERAGE;
+			} else if (strcmp(optarg, "cic") == 0) {
+				m_Decimator = dsp::DecimatorKind::CIC;
+			} else if (strcmp(optarg, "fir") == 0) {
+				m_Decimator = dsp::DecimatorKind::FIR;
+			} else {
+				std::fprintf(stderr, "Invalid decimator: %s\n", optarg);
+				PrintHelpMessage(argv[0]);
+			}
+			break;
 		case 'h':
 			PrintHelpMessage(argv[0]);
 			break;
@@ -457,10 +772,22 @@ static void PrintHelpMessage(const char *cmd) {
 	std::printf("Options:\n");
 	std::printf("\t-g <backend>     Select graphics backend. {drm|x11} default: drm\n");
 	std::printf("\t-h, --help       Show this help message and exit\n");
-	std::printf("\t-i <backend>     Select i2c backend. {hw|mock} default: hw\n");
+	std::printf("\t-i <backend>     Select i2c backend. {hw|mock[:<waveforms>]|replay:<file>} default: hw\n");
 	std::printf("\t-l <level>       Set log level {debug|trace|info|warn|error} default: info\n");
+	std::printf("\t-r <hz>          Set the displayed sample rate in Hz, the ADC runs at it times\n");
+	std::printf("\t                 the oversampling factor. default: 250\n");
 	std::printf("\t--logfile=<file> Set log file location.");
 	std::printf("\t                 default: $HOME/.local/share/ceeMPPM/\n");
+	std::printf("\t--log-mode=<mode> Log from a writer thread, dropping or blocking when its queue is full,\n");
+	std::printf("\t                 or synchronously {drop|block|sync} default: drop\n");
+	std::printf("\t--rt-priority=<n> Sample under SCHED_FIFO at priority n {1-99}\n");
+	std::printf("\t--unthrottled    Sample as fast as samples are consumed (mock and replay)\n");
+	std::printf("\t--capture=<file> Capture raw ADC data for replay\n");
+	std::printf("\t--events=<file>  Write binary diagnostic events, decoded with mppm-events\n");
+	std::printf("\t--record=<file>  Record every channel with timestamps\n");
+	std::printf("\t--mains=<hz>     Mains frequency to notch out {50|60} default: 50\n");
+	std::printf("\t--oversample=<n> Sample the ADC at n times -r and decimate back for resolution {1-64} default: 1\n");
+	std::printf("\t--decimator=<filter> Decimation filter when oversampling {average|cic|fir} default: cic\n");
 	std::printf("\t-v, --version    Show version information and exit\n");
 	std::exit(0);
 }
@@ -0,0 +1,370 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/recording.h>
+#include <cee/mppm/codec.h>
+
+#include <cee/core/crc.h>
+#include <cee/core/except.h>
+#include <cee/core/log.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace cee {
+	static uint64_t ClockNow(clockid_t clock) {
+		timespec ts;
+		clock_gettime(clock, &ts);
+		return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+	}
+
+	// CRC of a structure up to its trailing crc field
+	template<typename T>
+	static uint32_t StructCrc(const T &value) {
+		return Crc32(&value, offsetof(T, crc));
+	}
+
+	static std::size_t RawPayloadSize(std::size_t samples, std::size_t channels) {
+		return samples * (sizeof(uint64_t) + channels);
+	}
+
+	bool RecordingHeader::IsValid() const {
+		return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 && version == VERSION &&
+			headerSize >= sizeof(RecordingHeader) && sampleRate > 0.f && channelCount > 0 &&
+			oversampling <= dsp::Decimator<float>::MAX_FACTOR &&
+			decimator <= static_cast<uint8_t>(dsp::DecimatorKind::FIR) && crc == StructCrc(*this);
+	}
+
+	bool RecordingChunkHeader::IsValid() const {
+		return magic == MAGIC && crc == StructCrc(*this) && sampleCount > 0 &&
+			firstTimestamp <= lastTimestamp;
+	}
+
+	bool RecordingFooter::IsValid() const {
+		return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 && crc == StructCrc(*this);
+	}
+
+	void RecordingChunk::Clear() {
+		timestamps.clear();
+		for (std::vector<uint8_t> &plane : channels)
+			plane.clear();
+	}
+
+	RecordingWriter::RecordingWriter(const std::string &path, float sampleRate, int channelCount,
+			RecordingEncoding encoding, std::size_t oversampling, dsp::DecimatorKind decimator)
+	 : m_Path(path), m_Fd(-1), m_ChannelCount(channelCount), m_Encoding(encoding), m_SampleCount(0), m_Offset(0) {
+		if (!(sampleRate > 0.f))
+			throw core::InvalidParameter(fmt::format("RecordingWriter(): Invalid sample rate {}", sampleRate));
+		if (channelCount < 1 || channelCount > 255)
+			throw core::InvalidParameter(fmt::format("RecordingWriter(): Invalid channel count {}", channelCount));
+		if (oversampling < 1 || oversampling > dsp::Decimator<float>::MAX_FACTOR)
+			throw core::InvalidParameter(fmt::format("RecordingWriter(): Invalid oversampling {}", oversampling));
+
+		RecordingHeader header{};
+		std::memcpy(header.magic, RecordingHeader::MAGIC, sizeof(header.magic));
+		header.version = RecordingHeader::VERSION;
+		header.headerSize = sizeof(header);
+		header.sampleRate = sampleRate;
+		header.channelCount = static_cast<uint8_t>(channelCount);
+		header.oversampling = static_cast<uint8_t>(oversampling);
+		header.decimator = static_cast<uint8_t>(decimator);
+		header.startMonotonic = ClockNow(CLOCK_MONOTONIC);
+		header.startTime = ClockNow(CLOCK_REALTIME);
+		header.crc = StructCrc(header);
+
+		m_Fd = ::open(m_Path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (m_Fd < 0)
+			throw core::FileError(fmt::format("Failed to create recording {} ({})", m_Path, strerror(errno)));
+		m_Buffer.reserve(2 * WRITE_SIZE);
+		Append(&header, sizeof(header));
+	}
+
+	RecordingWriter::~RecordingWriter() {
+		try {
+			Close();
+		} catch (const core::Error &) {
+		}
+		if (m_Fd >= 0)
+			::close(m_Fd);
+	}
+
+	void RecordingWriter::Write(const RecordingChunk &chunk) {
+		if (m_Fd < 0)
+			throw core::UsageError("RecordingWriter::Write(): Recording is closed");
+		const std::size_t count = chunk.GetSampleCount();
+		if (count == 0)
+			return;
+		if (chunk.channels.size() != static_cast<std::size_t>(m_ChannelCount))
+			throw core::InvalidParameter(fmt::format("RecordingWriter::Write(): Need {} channels, got {}",
+						m_ChannelCount, chunk.channels.size()));
+		for (const std::vector<uint8_t> &plane : chunk.channels) {
+			if (plane.size() != count)
+				throw core::InvalidParameter("RecordingWriter::Write(): Channel planes differ in length");
+		}
+
+		m_Payload.clear();
+		if (m_Encoding == RecordingEncoding::PACKED) {
+			EncodePlane(chunk.timestamps, m_Payload);
+			for (const std::vector<uint8_t> &plane : chunk.channels)
+				EncodePlane(plane, m_Payload);
+		} else {
+			const uint8_t *timestamps = reinterpret_cast<const uint8_t *>(chunk.timestamps.data());
+			m_Payload.insert(m_Payload.end(), timestamps, timestamps + count * sizeof(uint64_t));
+			for (const std::vector<uint8_t> &plane : chunk.channels)
+				m_Payload.insert(m_Payload.end(), plane.begin(), plane.end());
+		}
+
+		RecordingChunkHeader header{};
+		header.magic = RecordingChunkHeader::MAGIC;
+		header.encoding = static_cast<uint16_t>(m_Encoding);
+		header.channelCount = static_cast<uint16_t>(m_ChannelCount);
+		header.sampleCount = static_cast<uint32_t>(count);
+		header.payloadSize = static_cast<uint32_t>(m_Payload.size());
+		header.firstSample = m_SampleCount;
+		header.firstTimestamp = chunk.timestamps.front();
+		header.lastTimestamp = chunk.timestamps.back();
+		header.payloadCrc = Crc32(m_Payload);
+		header.crc = StructCrc(header);
+
+		m_Index.push_back({ m_Offset, header.firstSample, header.firstTimestamp, header.lastTimestamp });
+		Append(&header, sizeof(header));
+		Append(m_Payload.data(), m_Payload.size());
+		m_SampleCount += count;
+	}
+
+	void RecordingWriter::Flush() {
+		if (m_Fd < 0)
+			return;
+		WriteOut(m_Buffer.size() - m_Buffer.size() % WRITE_SIZE);
+		// The tail stays buffered and goes out again at the same offset as
+		// the start of the next block, so later writes stay aligned
+		WriteAt(m_Buffer.size());
+		Sync();
+	}
+
+	void RecordingWriter::Close() {
+		if (m_Fd < 0)
+			return;
+		RecordingFooter footer{};
+		std::memcpy(footer.magic, RecordingFooter::MAGIC, sizeof(footer.magic));
+		footer.indexOffset = m_Offset;
+		footer.chunkCount = m_Index.size();
+		footer.sampleCount = m_SampleCount;
+		footer.indexCrc = Crc32(m_Index.data(), m_Index.size() * sizeof(RecordingIndexEntry));
+		footer.crc = StructCrc(footer);
+		Append(m_Index.data(), m_Index.size() * sizeof(RecordingIndexEntry));
+		Append(&footer, sizeof(footer));
+		WriteOut(m_Buffer.size());
+		Sync();
+		::close(m_Fd);
+		m_Fd = -1;
+	}
+
+	void RecordingWriter::Append(const void *data, std::size_t size) {
+		const uint8_t *bytes = static_cast<const uint8_t *>(data);
+		m_Buffer.insert(m_Buffer.end(), bytes, bytes + size);
+		m_Offset += size;
+		if (m_Buffer.size() >= WRITE_SIZE)
+			WriteOut(m_Buffer.size() - m_Buffer.size() % WRITE_SIZE);
+	}
+
+	void RecordingWriter::WriteOut(std::size_t size) {
+		WriteAt(size);
+		m_Buffer.erase(m_Buffer.begin(), m_Buffer.begin() + static_cast<std::ptrdiff_t>(size));
+	}
+
+	void RecordingWriter::WriteAt(std::size_t size) {
+		const off_t offset = static_cast<off_t>(m_Offset - m_Buffer.size());
+		std::size_t written = 0;
+		while (written < size) {
+			ssize_t result = ::pwrite(m_Fd, m_Buffer.data() + written, size - written,
+					offset + static_cast<off_t>(written));
+			if (result < 0 && errno == EINTR)
+				continue;
+			if (result <= 0)
+				throw core::FileError(fmt::format("Failed to write recording {} ({})", m_Path, strerror(errno)));
+			written += static_cast<std::size_t>(result);
+		}
+	}
+
+	void RecordingWriter::Sync() {
+		if (::fdatasync(m_Fd) != 0)
+			throw core::FileError(fmt::format("Failed to sync recording {} ({})", m_Path, strerror(errno)));
+	}
+
+	RecordingReader::RecordingReader(const std::string &path)
+	 : m_Path(path), m_Fd(-1), m_Header{}, m_SampleCount(0), m_Recovered(false) {
+		m_Fd = ::open(m_Path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (m_Fd < 0)
+			throw core::FileError(fmt::format("Failed to open recording {} ({})", m_Path, strerror(errno)));
+		try {
+			struct stat info;
+			if (::fstat(m_Fd, &info) != 0)
+				throw core::FileError(fmt::format("Failed to stat recording {} ({})", m_Path, strerror(errno)));
+			const uint64_t fileSize = static_cast<uint64_t>(info.st_size);
+			if (fileSize < sizeof(RecordingHeader))
+				throw core::FileError(fmt::format("{} is not a valid recording", m_Path));
+			ReadAt(&m_Header, sizeof(m_Header), 0);
+			if (!m_Header.IsValid())
+				throw core::FileError(fmt::format("{} is not a valid recording", m_Path));
+			if (!ReadFooter(fileSize)) {
+				m_Recovered = true;
+				ScanChunks(fileSize);
+			}
+		} catch (...) {
+			::close(m_Fd);
+			throw;
+		}
+	}
+
+	RecordingReader::~RecordingReader() {
+		::close(m_Fd);
+	}
+
+	std::size_t RecordingReader::FindSample(uint64_t sample) const {
+		if (sample >= m_SampleCount)
+			return m_Index.size();
+		auto it = std::upper_bound(m_Index.begin(), m_Index.end(), sample,
+				[](uint64_t s, const RecordingIndexEntry &entry) { return s < entry.firstSample; });
+		return static_cast<std::size_t>(it - m_Index.begin()) - 1;
+	}
+
+	std::size_t RecordingReader::FindTime(uint64_t timestamp) const {
+		auto it = std::upper_bound(m_Index.begin(), m_Index.end(), timestamp,
+				[](uint64_t t, const RecordingIndexEntry &entry) { return t < entry.firstTimestamp; });
+		return it == m_Index.begin() ? 0 : static_cast<std::size_t>(it - m_Index.begin()) - 1;
+	}
+
+	void RecordingReader::ReadChunk(std::size_t chunk, RecordingChunk &out) {
+		if (chunk >= m_Index.size())
+			throw core::InvalidParameter(fmt::format("RecordingReader::ReadChunk(): No chunk {}", chunk));
+		const RecordingIndexEntry &entry = m_Index[chunk];
+		RecordingChunkHeader header;
+		ReadAt(&header, sizeof(header), entry.offset);
+		if (!header.IsValid() || header.firstSample != entry.firstSample ||
+				header.channelCount != m_Header.channelCount)
+			throw core::FileError(fmt::format("Chunk {} of {} is damaged", chunk, m_Path));
+
+		m_Payload.resize(header.payloadSize);
+		ReadAt(m_Payload.data(), m_Payload.size(), entry.offset + sizeof(header));
+		if (Crc32(m_Payload) != header.payloadCrc || !DecodePayload(header, out))
+			throw core::FileError(fmt::format("Chunk {} of {} is damaged", chunk, m_Path));
+	}
+
+	bool RecordingReader::DecodePayload(const RecordingChunkHeader &header, RecordingChunk &out) const {
+		const std::size_t count = header.sampleCount;
+		out.firstSample = header.firstSample;
+		out.timestamps.resize(count);
+		out.channels.resize(header.channelCount);
+		for (std::vector<uint8_t> &channel : out.channels)
+			channel.resize(count);
+
+		switch (static_cast<RecordingEncoding>(header.encoding)) {
+		case RecordingEncoding::RAW: {
+			if (m_Payload.size() != RawPayloadSize(count, header.channelCount))
+				return false;
+			std::memcpy(out.timestamps.data(), m_Payload.data(), count * sizeof(uint64_t));
+			const uint8_t *plane = m_Payload.data() + count * sizeof(uint64_t);
+			for (std::vector<uint8_t> &channel : out.channels) {
+				std::memcpy(channel.data(), plane, count);
+				plane += count;
+			}
+			return true;
+		}
+		case RecordingEncoding::PACKED: {
+			std::span<const uint8_t> in(m_Payload);
+			if (!DecodePlane(in, std::span<uint64_t>(out.timestamps)))
+				return false;
+			for (std::vector<uint8_t> &channel : out.channels) {
+				if (!DecodePlane(in, std::span<uint8_t>(channel)))
+					return false;
+			}
+			return in.empty();
+		}
+		}
+		return false;
+	}
+
+	bool RecordingReader::ReadFooter(uint64_t fileSize) {
+		if (fileSize < m_Header.headerSize + sizeof(RecordingFooter))
+			return false;
+		RecordingFooter footer;
+		ReadAt(&footer, sizeof(footer), fileSize - sizeof(footer));
+		const uint64_t indexSize = footer.chunkCount * sizeof(RecordingIndexEntry);
+		if (!footer.IsValid() || footer.indexOffset < m_Header.headerSize ||
+				footer.chunkCount > fileSize / sizeof(RecordingIndexEntry) ||
+				footer.indexOffset + indexSize + sizeof(footer) != fileSize)
+			return false;
+
+		m_Index.resize(footer.chunkCount);
+		ReadAt(m_Index.data(), indexSize, footer.indexOffset);
+		if (Crc32(m_Index.data(), indexSize) != footer.indexCrc) {
+			m_Index.clear();
+			return false;
+		}
+		m_SampleCount = footer.sampleCount;
+		return true;
+	}
+
+	void RecordingReader::ScanChunks(uint64_t fileSize) {
+		m_Index.clear();
+		m_SampleCount = 0;
+		uint64_t offset = m_Header.headerSize;
+		RecordingChunkHeader header;
+		while (ReadChunkHeader(offset, fileSize, header)) {
+			m_Payload.resize(header.payloadSize);
+			ReadAt(m_Payload.data(), m_Payload.size(), offset + sizeof(header));
+			if (Crc32(m_Payload) != header.payloadCrc)
+				break;
+			m_Index.push_back({ offset, header.firstSample, header.firstTimestamp, header.lastTimestamp });
+			m_SampleCount += header.sampleCount;
+			offset += sizeof(header) + header.payloadSize;
+		}
+	}
+
+	bool RecordingReader::ReadChunkHeader(uint64_t offset, uint64_t fileSize, RecordingChunkHeader &header) {
+		if (offset + sizeof(header) > fileSize)
+			return false;
+		ReadAt(&header, sizeof(header), offset);
+		return header.IsValid() && header.firstSample == m_SampleCount &&
+			header.channelCount == m_Header.channelCount &&
+			offset + sizeof(header) + header.payloadSize <= fileSize;
+	}
+
+	void RecordingReader::ReadAt(void *data, std::size_t size, uint64_t offset) const {
+		uint8_t *bytes = static_cast<uint8_t *>(data);
+		while (size > 0) {
+			ssize_t result = ::pread(m_Fd, bytes, size, static_cast<off_t>(offset));
+			if (result < 0 && errno == EINTR)
+				continue;
+			if (result <= 0)
+				throw core::FileError(fmt::format("Failed to read recording {} ({})", m_Path,
+							result == 0 ? "unexpected end of file" : strerror(errno)));
+			bytes += result;
+			size -= static_cast<std::size_t>(result);
+			offset += static_cast<uint64_t>(result);
+		}
+	}
+}
@@ -0,0 +1,199 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/scheduler.h>
+
+#include <cee/core/except.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace cee {
+	static uint64_t MonotonicNow() {
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+	}
+
+	static timespec ToTimespec(uint64_t ns) {
+		return {
+			.tv_sec = static_cast<time_t>(ns / 1000000000ull),
+			.tv_nsec = static_cast<long>(ns % 1000000000ull)
+		};
+	}
+
+	/*
+	 **************************************************
+	 **************** JitterHistogram *****************
+	 **************************************************
+	 */
+	void JitterHistogram::Record(uint64_t value) {
+		m_Buckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+		m_Count.fetch_add(1, std::memory_order_relaxed);
+		m_Sum.fetch_add(value, std::memory_order_relaxed);
+		if (value < m_Min.load(std::memory_order_relaxed))
+			m_Min.store(value, std::memory_order_relaxed);
+		if (value > m_Max.load(std::memory_order_relaxed))
+			m_Max.store(value, std::memory_order_relaxed);
+	}
+
+	void JitterHistogram::Reset() {
+		for (auto &bucket : m_Buckets)
+			bucket.store(0, std::memory_order_relaxed);
+		m_Count.store(0, std::memory_order_relaxed);
+		m_Sum.store(0, std::memory_order_relaxed);
+		m_Min.store(UINT64_MAX, std::memory_order_relaxed);
+		m_Max.store(0, std::memory_order_relaxed);
+	}
+
+	double JitterHistogram::GetMean() const {
+		uint64_t count = GetCount();
+		if (count == 0)
+			return 0.0;
+		return static_cast<double>(m_Sum.load(std::memory_order_relaxed)) / static_cast<double>(count);
+	}
+
+	uint64_t JitterHistogram::GetPercentile(double percentile) const {
+		uint64_t count = GetCount();
+		if (count == 0)
+			return 0;
+		uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count)));
+		if (rank == 0)
+			rank = 1;
+		uint64_t seen = 0;
+		for (int i = 0; i < BUCKET_COUNT; ++i) {
+			seen += m_Buckets[i].load(std::memory_order_relaxed);
+			if (seen >= rank)
+				return std::min(BucketUpperBound(i), GetMax());
+		}
+		return GetMax();
+	}
+
+	/*
+	 **************************************************
+	 **************** SampleScheduler *****************
+	 **************************************************
+	 */
+	SampleScheduler::SampleScheduler(float rate, int realtimePriority, Logger logger)
+	 : m_RealtimePriority(realtimePriority), m_Logger(logger), m_TimerFd(-1),
+	 m_StartNs(0), m_Expirations(0), m_MissedDeadlines(0) {
+		if (!(rate > 0.f))
+			throw core::InvalidParameter(fmt::format("SampleScheduler(): Invalid rate {}", rate));
+		m_PeriodNs = static_cast<uint64_t>(std::llround(1e9 / rate));
+		if (m_PeriodNs == 0)
+			throw core::InvalidParameter(fmt::format("SampleScheduler(): Rate {} too high", rate));
+	}
+
+	SampleScheduler::~SampleScheduler() {
+		Stop();
+	}
+
+	void SampleScheduler::Start() {
+		if (m_TimerFd >= 0)
+			return;
+
+		if (m_RealtimePriority > 0) {
+			sched_param param{};
+			param.sched_priority = m_RealtimePriority;
+			int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+			if (result != 0) {
+				Log(spdlog::level::warn, "Cannot use SCHED_FIFO priority {}: {}",
+						m_RealtimePriority, strerror(result));
+			} else {
+				Log(spdlog::level::debug, "Using SCHED_FIFO priority {}", m_RealtimePriority);
+			}
+		}
+
+		m_TimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+		if (m_TimerFd < 0)
+			throw core::InternalError(fmt::format("SampleScheduler::Start(): timerfd_create failed ({})",
+						strerror(errno)));
+
+		m_StartNs = MonotonicNow();
+		m_Expirations = 0;
+		itimerspec spec = {
+			.it_interval = ToTimespec(m_PeriodNs),
+			.it_value = ToTimespec(m_StartNs + m_PeriodNs)
+		};
+		if (timerfd_settime(m_TimerFd, TFD_TIMER_ABSTIME, &spec, nullptr) < 0) {
+			int err = errno;
+			close(m_TimerFd);
+			m_TimerFd = -1;
+			throw core::InternalError(fmt::format("SampleScheduler::Start(): timerfd_settime failed ({})",
+						strerror(err)));
+		}
+	}
+
+	void SampleScheduler::Stop() {
+		if (m_TimerFd < 0)
+			return;
+		close(m_TimerFd);
+		m_TimerFd = -1;
+	}
+
+	uint64_t SampleScheduler::Wait() {
+		if (m_TimerFd < 0)
+			throw core::UsageError("SampleScheduler::Wait(): Scheduler not started");
+
+		uint64_t expirations = 0;
+		ssize_t result = read(m_TimerFd, &expirations, sizeof(expirations));
+		uint64_t now = MonotonicNow();
+		if (result != sizeof(expirations)) {
+			if (result < 0 && errno == EINTR)
+				return 0;
+			throw core::InternalError(fmt::format("SampleScheduler::Wait(): read failed ({})",
+						strerror(errno)));
+		}
+
+		m_Expirations += expirations;
+		uint64_t deadline = m_StartNs + m_Expirations * m_PeriodNs;
+		RecordWakeup(now > deadline ? now - deadline : 0, expirations);
+		return expirations;
+	}
+
+	void SampleScheduler::RecordWakeup(uint64_t lateness, uint64_t expirations) {
+		m_Lateness.Record(lateness);
+		if (expirations > 1)
+			m_MissedDeadlines.fetch_add(expirations - 1, std::memory_order_relaxed);
+	}
+
+	JitterStats SampleScheduler::GetStats() const {
+		JitterStats stats{};
+		stats.wakeups = m_Lateness.GetCount();
+		stats.missedDeadlines = m_MissedDeadlines.load(std::memory_order_relaxed);
+		if (stats.wakeups == 0)
+			return stats;
+		stats.min = m_Lateness.GetMin() / 1000.0;
+		stats.mean = m_Lateness.GetMean() / 1000.0;
+		stats.p99 = m_Lateness.GetPercentile(99.0) / 1000.0;
+		stats.max = m_Lateness.GetMax() / 1000.0;
+		return stats;
+	}
+
+	void SampleScheduler::ResetStats() {
+		m_Lateness.Reset();
+		m_MissedDeadlines.store(0, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,277 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/signals.h>
+
+#include <cee/core/except.h>
+
+#include <cee/profiler/profiler.h>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+
+namespace cee {
+	using Value = SignalChain::Value;
+
+	static constexpr float ADC_SCALE = 1.f / 255.f;
+
+	// ADC codes enter the pipelines as integers, raw ones in fixed point,
+	// and the first stage of every pipeline brings them to [0, 1]
+	template<typename T>
+	static constexpr double AdcGain() {
+		if constexpr (dsp::FixedPoint<T>)
+			return ADC_SCALE * static_cast<double>(T::ONE);
+		else
+			return static_cast<double>(ADC_SCALE);
+	}
+
+	template<typename T>
+	static T FromCode(uint8_t code) {
+		if constexpr (dsp::FixedPoint<T>)
+			return T::FromRaw(code);
+		else
+			return static_cast<T>(code);
+	}
+
+	static constexpr double ADC_GAIN = AdcGain<Value>();
+
+	static constexpr double LEAD_II_HIGH_PASS = 0.5;
+	static constexpr double LEAD_II_LOW_PASS = 40.0;
+	static constexpr double PRESSURE_LOW_PASS = 20.0;
+	static constexpr double OSCILLATION_LOW_PASS = 20.0;
+
+	// Raw Lead II codes this close to either rail mean the electrodes are off
+	static constexpr int LEAD_OFF_MARGIN = 2;
+
+	// Nanoseconds of good reads after an ADC error before the failure
+	// clears. Under the alarm's onset delay, so a lone glitch never raises
+	// it while errors coming closer together keep it pending until it does.
+	static constexpr uint64_t ADC_RECOVERY = 250'000'000;
+
+	// In the order of SignalChain::Alarm
+	static constexpr std::array<AlarmConfig, SignalChain::ALARM_COUNT> ALARMS = {{
+		{ .name = "HR", .kind = AlarmConfig::Kind::LIMIT, .priority = AlarmPriority::MEDIUM,
+			.low = 50.f, .high = 120.f, .hysteresis = 5.f, .onsetDelay = 1.f },
+		{ .name = "HR change", .kind = AlarmConfig::Kind::RATE, .priority = AlarmPriority::LOW,
+			.maxRate = 3.f, .rateWindow = 10.f, .hysteresis = 0.5f },
+		{ .name = "MAP", .kind = AlarmConfig::Kind::LIMIT, .priority = AlarmPriority::MEDIUM,
+			.low = 60.f, .high = 110.f, .latching = true },
+		{ .name = "Leads off", .kind = AlarmConfig::Kind::TECHNICAL, .priority = AlarmPriority::MEDIUM,
+			.onsetDelay = 0.5f },
+		{ .name = "ADC failure", .kind = AlarmConfig::Kind::TECHNICAL, .priority = AlarmPriority::HIGH,
+			.onsetDelay = 0.5f, .latching = true },
+	}};
+
+	// The designs are constexpr, but the sample rate is only known at run time
+	SignalChain::SignalChain(float sampleRate, float mainsFrequency, std::size_t statisticsWindow,
+			std::size_t oversampling, dsp::DecimatorKind decimator, bool monitoring)
+	 : m_SampleRate(sampleRate),
+	 m_OutputRate(sampleRate / static_cast<float>(std::clamp<std::size_t>(oversampling, 1, Decimator::MAX_FACTOR))),
+	 m_MainsFrequency(mainsFrequency),
+	 m_LeadII(dsp::Scale<Value>(ADC_GAIN),
+			Decimator(decimator, oversampling, sampleRate),
+			LeadIIFilter(dsp::Cascade(
+				dsp::ButterworthHighPass<2>(m_OutputRate, LEAD_II_HIGH_PASS),
+				dsp::Section(dsp::Notch(m_OutputRate, mainsFrequency)),
+				dsp::ButterworthLowPass<4>(m_OutputRate, LEAD_II_LOW_PASS))),
+			dsp::Scale<Value>(1.f, 0.5f)),
+	 m_Pressure(dsp::Scale<Value>(ADC_GAIN),
+			Decimator(decimator, oversampling, sampleRate),
+			PressureFilter(dsp::Cascade(
+				dsp::Section(dsp::Notch(m_OutputRate, mainsFrequency)),
+				dsp::ButterworthLowPass<4>(m_OutputRate, PRESSURE_LOW_PASS)))),
+	 m_Oscillation(dsp::Scale<Value>(ADC_GAIN),
+			Decimator(decimator, oversampling, sampleRate),
+			OscillationFilter(dsp::FirLowPass<OscillationFilter::TAP_COUNT>(m_OutputRate, OSCILLATION_LOW_PASS))),
+	 m_Qrs(m_OutputRate),
+	 m_Nibp(m_OutputRate, PRESSURE_FULL_SCALE, ADC_SCALE),
+	 m_NibpCount(0),
+	 m_LastReadError(0),
+	 m_ReadFailing(false),
+	 m_Alarms(monitoring ? std::make_unique<AlarmEngine>() : nullptr),
+	 m_Trends(monitoring ? std::make_unique<TrendStore>(TREND_COUNT) : nullptr),
+	 m_DroppedCount(0),
+	 m_HeartRate(0.f),
+	 m_HeartRateKnown(false),
+	 m_BeatRate(0.f),
+	 m_BeatCount(0) {
+		// The filter designs quietly turn into identities past Nyquist
+		const float nyquist = m_OutputRate / 2.f;
+		if (!(mainsFrequency < nyquist) || !(LEAD_II_LOW_PASS < nyquist))
+			throw core::InvalidParameter(fmt::format("SignalChain::SignalChain(): Output rate {} Hz is too low "
+					"for the {} Hz notch and {} Hz low-pass", m_OutputRate, mainsFrequency, LEAD_II_LOW_PASS));
+		for (Statistics &statistics : m_Statistics)
+			statistics.SetWindow(statisticsWindow);
+		if (m_Alarms) {
+			for (const AlarmConfig &alarm : ALARMS)
+				m_Alarms->Add(alarm);
+		}
+	}
+
+	AlarmEngine &SignalChain::GetAlarms() {
+		if (!m_Alarms)
+			throw core::UsageError("SignalChain::GetAlarms(): Alarms are only evaluated when monitoring");
+		return *m_Alarms;
+	}
+
+	const TrendStore &SignalChain::GetTrends() const {
+		if (!m_Trends)
+			throw core::UsageError("SignalChain::GetTrends(): Trends are only kept when monitoring");
+		return *m_Trends;
+	}
+
+	void SignalChain::Process(std::span<const Sample> samples) {
+		PROFILE_FUNCTION();
+		while (!samples.empty()) {
+			std::span<const Sample> block = samples.first(std::min(samples.size(), Acquisition::BLOCK_SIZE));
+			samples = samples.subspan(block.size());
+
+			std::span<const float> leadII = RunChannel(m_LeadII, LEAD_II, block);
+			std::array<float, Acquisition::BLOCK_SIZE> qrsBlock;
+			std::copy(leadII.begin(), leadII.end(), qrsBlock.begin());
+			m_Qrs.Process(std::span<float>(qrsBlock.data(), leadII.size()));
+			// Unknown until the detector has seen an interval, 0 once beats
+			// stop. With the leads off the rate means nothing either.
+			const bool leadOff = IsLeadOff(block);
+			m_HeartRateKnown.store(!leadOff && (m_Qrs.GetHeartRate() > 0.f || m_Qrs.GetBeatCount() >= 2),
+					std::memory_order_relaxed);
+			m_HeartRate.store(m_Qrs.GetHeartRate(), std::memory_order_relaxed);
+			m_BeatRate.store(m_Qrs.GetBeatRate(), std::memory_order_relaxed);
+			m_BeatCount.store(m_Qrs.GetBeatCount(), std::memory_order_relaxed);
+
+			std::span<const float> pressure = RunChannel(m_Pressure, PRESSURE, block);
+			std::span<const float> oscillation = RunChannel(m_Oscillation, OSCILLATION, block);
+			m_Nibp.Process(pressure, oscillation);
+			if (m_Nibp.GetMeasurementCount() != m_NibpCount) {
+				m_NibpCount = m_Nibp.GetMeasurementCount();
+				// The render loop picks results up every frame, so a full
+				// queue only drops stale ones
+				m_NibpResults.TryEnqueue(m_Nibp.GetResult());
+				if (m_Alarms && m_Nibp.GetResult().IsValid())
+					m_Alarms->Update(MEAN_PRESSURE_LIMIT, m_Nibp.GetResult().mean, block.back().timestamp);
+			}
+			if (m_Alarms)
+				UpdateAlarms(block);
+		}
+	}
+
+	void SignalChain::OnReadError(uint64_t timestamp) {
+		if (!m_Alarms)
+			return;
+		m_LastReadError = timestamp;
+		m_ReadFailing = true;
+		m_Alarms->SetCondition(ADC_FAILURE, true, timestamp);
+		m_Alarms->Publish();
+	}
+
+	bool SignalChain::IsLeadOff(const Sample &sample) {
+		const uint8_t code = sample.channels[ADC_INPUTS[LEAD_II]];
+		return code <= LEAD_OFF_MARGIN || code >= 255 - LEAD_OFF_MARGIN;
+	}
+
+	bool SignalChain::IsLeadOff(std::span<const Sample> samples) {
+		return std::all_of(samples.begin(), samples.end(), [](const Sample &sample) { return IsLeadOff(sample); });
+	}
+
+	void SignalChain::UpdateAlarms(std::span<const Sample> samples) {
+		// Technical conditions are known per sample, so their onsets are
+		// timed to the sample rather than the block
+		for (const Sample &sample : samples) {
+			// Samples read before the last error were only waiting for
+			// their block and say nothing about recovery
+			if (m_ReadFailing && sample.timestamp > m_LastReadError) {
+				m_ReadFailing = sample.timestamp - m_LastReadError < ADC_RECOVERY;
+				m_Alarms->SetCondition(ADC_FAILURE, m_ReadFailing, sample.timestamp);
+			}
+			m_Alarms->SetCondition(LEAD_OFF, IsLeadOff(sample), sample.timestamp);
+		}
+
+		const uint64_t timestamp = samples.back().timestamp;
+		const float heartRate = IsHeartRateKnown() ? m_Qrs.GetHeartRate() : std::numeric_limits<float>::quiet_NaN();
+		m_Alarms->Update(HEART_RATE_LIMIT, heartRate, timestamp);
+		m_Alarms->Update(HEART_RATE_CHANGE, heartRate, timestamp);
+		m_Trends->Push(HEART_RATE_TREND, heartRate, timestamp);
+
+		m_Alarms->Publish();
+	}
+
+	void SignalChain::Reset() {
+		m_LeadII.Reset();
+		m_Pressure.Reset();
+		m_Oscillation.Reset();
+		m_Qrs.Reset();
+		m_Nibp.Reset();
+		m_NibpCount = 0;
+		m_LastReadError = 0;
+		m_ReadFailing = false;
+		for (int channel = 0; channel < CHANNEL_COUNT; ++channel) {
+			m_Statistics[channel].Reset();
+			m_PublishedStatistics[channel].Store({});
+		}
+		m_HeartRate.store(0.f, std::memory_order_relaxed);
+		m_HeartRateKnown.store(false, std::memory_order_relaxed);
+		m_BeatRate.store(0.f, std::memory_order_relaxed);
+		m_BeatCount.store(0, std::memory_order_relaxed);
+		if (m_Alarms)
+			m_Alarms->Reset();
+		// Trends are history and outlive a restart of the processing
+	}
+
+	template<typename P>
+	std::span<const float> SignalChain::RunChannel(P &pipeline, Channel channel, std::span<const Sample> samples) {
+		using Traits = dsp::SampleTraits<Value>;
+		const int input = ADC_INPUTS[channel];
+		std::array<Value, Acquisition::BLOCK_SIZE> &block = m_Blocks[channel];
+		for (std::size_t i = 0; i < samples.size(); ++i)
+			block[i] = FromCode<Value>(samples[i].channels[input]);
+
+		std::size_t produced = pipeline.Process(std::span<Value>(block.data(), samples.size()));
+		std::span<const Value> processed(block.data(), produced);
+
+		Statistics &statistics = m_Statistics[channel];
+		statistics.Push(processed);
+		if (statistics.GetCount() > 0) {
+			m_PublishedStatistics[channel].Store({
+				static_cast<float>(Traits::ToDouble(statistics.GetMin())),
+				static_cast<float>(Traits::ToDouble(statistics.GetMax())),
+				static_cast<float>(statistics.GetMean()), static_cast<float>(statistics.GetStdDev()),
+				static_cast<uint32_t>(statistics.GetCount())
+			});
+		}
+
+		std::span<const float> output;
+		if constexpr (std::is_same_v<Value, float>) {
+			output = processed;
+		} else {
+			std::array<float, Acquisition::BLOCK_SIZE> &converted = m_FloatBlocks[channel];
+			for (std::size_t i = 0; i < produced; ++i)
+				converted[i] = static_cast<float>(Traits::ToDouble(processed[i]));
+			output = std::span<const float>(converted.data(), produced);
+		}
+		if (m_Trends && produced > 0)
+			m_Trends->Push(channel, output, samples.back().timestamp);
+
+		std::size_t queued = m_Outputs[channel].EnqueueSpan(output);
+		if (queued < produced)
+			m_DroppedCount.fetch_add(produced - queued, std::memory_order_relaxed);
+		return output;
+	}
+}
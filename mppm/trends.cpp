@@ -0,0 +1,188 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/trends.h>
+
+#include <algorithm>
+
+namespace cee {
+	static_assert([] {
+		for (std::size_t level = 1; level < TrendStore::LEVEL_COUNT; ++level) {
+			if (TrendStore::LEVELS[level].duration % TrendStore::LEVELS[level - 1].duration != 0)
+				return false;
+		}
+		return true;
+	}(), "Every trend level must be a whole number of buckets of the one below");
+
+	TrendStore::TrendStore(std::size_t seriesCount)
+	 : m_Series(seriesCount), m_Latest(0) {
+		for (Series &series : m_Series) {
+			for (std::size_t level = 0; level < LEVEL_COUNT; ++level)
+				series.buckets[level] = std::make_unique<SeqLock<Bucket>[]>(LEVELS[level].capacity);
+		}
+	}
+
+	void TrendStore::Push(std::size_t series, std::span<const float> values, uint64_t timestamp) {
+		Series &s = m_Series[series];
+		Open(s, timestamp);
+		Accumulator &bucket = s.open[0];
+		for (float value : values) {
+			if (std::isnan(value))
+				continue;
+			if (bucket.count == 0) {
+				bucket.min = value;
+				bucket.max = value;
+			} else {
+				bucket.min = std::min(bucket.min, value);
+				bucket.max = std::max(bucket.max, value);
+			}
+			bucket.sum += value;
+			++bucket.count;
+		}
+		m_Latest.store(timestamp, std::memory_order_release);
+	}
+
+	void TrendStore::Push(std::size_t series, float value, uint64_t timestamp) {
+		Push(series, std::span<const float>(&value, 1), timestamp);
+	}
+
+	void TrendStore::Reset() {
+		for (Series &series : m_Series) {
+			series.open.fill({});
+			for (std::size_t level = 0; level < LEVEL_COUNT; ++level) {
+				for (std::size_t i = 0; i < LEVELS[level].capacity; ++i)
+					series.buckets[level][i].Store({});
+			}
+		}
+		m_Latest.store(0, std::memory_order_release);
+	}
+
+	void TrendStore::Open(Series &series, uint64_t timestamp) {
+		uint64_t index = timestamp / LEVELS[0].duration;
+		if (series.open[0].index == index)
+			return;
+		Close(series);
+		series.open[0] = {};
+		series.open[0].index = index;
+	}
+
+	void TrendStore::Close(Series &series) {
+		const Accumulator &closed = series.open[0];
+		if (closed.count == 0)
+			return;
+		Store(series, 0);
+
+		const uint64_t start = closed.index * LEVELS[0].duration;
+		for (std::size_t level = 1; level < LEVEL_COUNT; ++level) {
+			Accumulator &bucket = series.open[level];
+			uint64_t index = start / LEVELS[level].duration;
+			if (bucket.index != index) {
+				bucket = {};
+				bucket.index = index;
+			}
+			if (bucket.count == 0) {
+				bucket.min = closed.min;
+				bucket.max = closed.max;
+			} else {
+				bucket.min = std::min(bucket.min, closed.min);
+				bucket.max = std::max(bucket.max, closed.max);
+			}
+			bucket.sum += closed.sum;
+			bucket.count += closed.count;
+			Store(series, level);
+		}
+	}
+
+	void TrendStore::Store(Series &series, std::size_t level) {
+		const Accumulator &bucket = series.open[level];
+		series.buckets[level][bucket.index % LEVELS[level].capacity].Store({
+			static_cast<uint32_t>(bucket.index), static_cast<uint32_t>(bucket.count), bucket.min, bucket.max, bucket.sum
+		});
+	}
+
+	void TrendStore::Query(std::size_t series, uint64_t start, uint64_t end, std::span<TrendPoint> points) const {
+		std::fill(points.begin(), points.end(), TrendPoint{});
+		if (points.empty() || end <= start)
+			return;
+		const Series &s = m_Series[series];
+
+		// Pixel edges at start + range * i / n, without overflowing
+		const uint64_t range = end - start;
+		const uint64_t n = points.size();
+		const uint64_t step = range / n;
+		const uint64_t remainder = range % n;
+
+		// Coarsest level with buckets no wider than a pixel
+		std::size_t finest = 0;
+		while (finest + 1 < LEVEL_COUNT && LEVELS[finest + 1].duration <= std::max<uint64_t>(step, 1))
+			++finest;
+
+		// Whether a level still holds the bucket of t
+		const uint64_t latest = GetLatest();
+		auto holds = [latest](std::size_t level, uint64_t t) {
+			return t / LEVELS[level].duration + LEVELS[level].capacity > latest / LEVELS[level].duration;
+		};
+		// Pixels older than the finer levels keep are answered by a coarser
+		// one, moving back to the finer ones as the pixels get newer
+		std::size_t level = finest;
+		while (level + 1 < LEVEL_COUNT && !holds(level, start))
+			++level;
+
+		uint64_t from = start;
+		for (uint64_t i = 0; i < n; ++i) {
+			uint64_t to = start + step * (i + 1) + remainder * (i + 1) / n;
+			if (to == from)
+				continue;
+			while (level > finest && holds(level - 1, from))
+				--level;
+			Aggregate(s, level, from, to, points[i]);
+			from = to;
+		}
+	}
+
+	void TrendStore::Aggregate(const Series &series, std::size_t level, uint64_t start, uint64_t end,
+			TrendPoint &point) const {
+		const std::size_t capacity = LEVELS[level].capacity;
+		uint64_t first = start / LEVELS[level].duration;
+		const uint64_t last = (end - 1) / LEVELS[level].duration;
+		// Only the newest capacity buckets can still be held
+		if (last - first >= capacity)
+			first = last - capacity + 1;
+
+		float min = 0.f;
+		float max = 0.f;
+		double sum = 0.0;
+		uint64_t count = 0;
+		for (uint64_t index = first; index <= last; ++index) {
+			Bucket bucket = series.buckets[level][index % capacity].Load();
+			if (bucket.index != static_cast<uint32_t>(index))
+				continue;
+			if (count == 0) {
+				min = bucket.min;
+				max = bucket.max;
+			} else {
+				min = std::min(min, bucket.min);
+				max = std::max(max, bucket.max);
+			}
+			sum += bucket.sum;
+			count += bucket.count;
+		}
+		if (count > 0)
+			point = { min, max, static_cast<float>(sum / static_cast<double>(count)) };
+	}
+}
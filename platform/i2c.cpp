@@ -22,6 +22,7 @@
 
 #include <i2c_mock.h>
 #include <i2c_hw.h>
+#include <i2c_replay.h>
 
 namespace cee {
 namespace platform {
@@ -42,6 +43,13 @@ namespace platform {
 #else
 				error(logger, "Cannot use mock I2C context. Not built in this version");
 				return nullptr;
+#endif
+			case I2CContextType::PLATFORM_I2C_CONTEXT_REPLAY:
+#if defined(BUILD_PLATFORM_I2C_REPLAY) && BUILD_PLATFORM_I2C_REPLAY
+				return std::shared_ptr<I2CController>(new ReplayI2CController(file, ctxType, logger));
+#else
+				error(logger, "Cannot use replay I2C context. Not built in this version");
+				return nullptr;
 #endif
 			default:
 				error(logger, "Invalid I2C backend!");
@@ -51,8 +59,8 @@ namespace platform {
 
 	uint8_t PCF8591::Read() {
 		uint8_t b;
-		m_Ctrl->SelectDevice(m_Address);
-		ssize_t result = m_Ctrl->Read(&b, 1);
+		I2CMessage msg = I2CMessage::MakeRead(m_Address, &b, 1);
+		ssize_t result = m_Ctrl->Transfer({ &msg, 1 });
 		if (result < 0)
 			throw core::InternalError(fmt::format("PCF8591::Read(): Read failed ({})", -result));
 		else if (result != 1)
@@ -61,18 +69,24 @@ namespace platform {
 	}
 
 	void PCF8591::SendControl(int channel, bool autoinc, InputMode mode, bool outputEnable) {
+		m_Scanning = false;
 		m_CurChannel = channel;
 		m_AutoInc = autoinc;
 		m_InputMode = mode;
 		m_OutputEnable = outputEnable;
-		m_Ctrl->SelectDevice(m_Address);
 		uint8_t b = ComposeControlByte(m_CurChannel, m_AutoInc, m_InputMode, m_OutputEnable);
-		ssize_t result = m_Ctrl->Write(&b, 1);
+		uint8_t discard;
+		// The read discards the stale result and starts a conversion on the
+		// newly selected channel.
+		I2CMessage msgs[] = {
+			I2CMessage::MakeWrite(m_Address, &b, 1),
+			I2CMessage::MakeRead(m_Address, &discard, 1),
+		};
+		ssize_t result = m_Ctrl->Transfer(msgs);
 		if (result < 0)
-			throw core::InternalError(fmt::format("PCF8591::SendControl(): Write failed ({})", -result));
-		else if (result != 1)
-			throw core::InternalError("PCF8591::SendControl(): Write failed (Unknown Error)");
-		Read();
+			throw core::InternalError(fmt::format("PCF8591::SendControl(): Transfer failed ({})", -result));
+		else if (result != 2)
+			throw core::InternalError("PCF8591::SendControl(): Transfer failed (Unknown Error)");
 	}
 
 	void PCF8591::SelectChannel(int channel) {
@@ -80,6 +94,31 @@ namespace platform {
 			return;
 		SendControl(channel, m_AutoInc, m_InputMode, m_OutputEnable);
 	}
+
+	void PCF8591::StartScan(InputMode mode, bool outputEnable) {
+		// SendControl() ends with a single byte read, which also starts the
+		// conversion of channel 0.
+		SendControl(0, true, mode, outputEnable);
+		m_Scanning = true;
+	}
+
+	int PCF8591::Scan(std::span<uint8_t> values) {
+		if (!m_Scanning)
+			throw core::UsageError("PCF8591::Scan(): StartScan() has not been called");
+		int count = ChannelCount(m_InputMode);
+		if (values.size() < static_cast<std::size_t>(count))
+			throw core::InvalidParameter(fmt::format("PCF8591::Scan(): Need space for {} values, got {}",
+						count, values.size()));
+		I2CMessage msg = I2CMessage::MakeRead(m_Address, values.data(), count);
+		ssize_t result = m_Ctrl->Transfer({ &msg, 1 });
+		if (result < 0) {
+			m_Scanning = false;
+			throw core::InternalError(fmt::format("PCF8591::Scan(): Read failed ({})", -result));
+		} else if (result != 1) {
+			m_Scanning = false;
+			throw core::InternalError("PCF8591::Scan(): Read failed (Unknown Error)");
+		}
+		return count;
+	}
 }
 }
-
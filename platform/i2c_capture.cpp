@@ -0,0 +1,89 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/platform/i2c_capture.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <time.h>
+
+namespace cee {
+namespace platform {
+	static constexpr std::size_t WRITE_BUFFER_SIZE = 64 * 1024;
+
+	I2CCaptureHeader ReadI2CCaptureHeader(const std::string &path) {
+		std::FILE *file = std::fopen(path.c_str(), "rb");
+		if (!file)
+			throw core::FileError(fmt::format("Failed to open capture {} ({})", path, strerror(errno)));
+		I2CCaptureHeader header;
+		std::size_t read = std::fread(&header, sizeof(header), 1, file);
+		std::fclose(file);
+		if (read != 1 || !header.IsValid())
+			throw core::FileError(fmt::format("{} is not a valid capture file", path));
+		return header;
+	}
+
+	I2CCaptureWriter::I2CCaptureWriter(const std::string &path, float sampleRate,
+			PCF8591::InputMode mode, uint8_t address)
+	 : m_Path(path), m_File(nullptr), m_ChannelCount(PCF8591::ChannelCount(mode)), m_FrameCount(0) {
+		if (!(sampleRate > 0.f))
+			throw core::InvalidParameter(fmt::format("I2CCaptureWriter(): Invalid sample rate {}", sampleRate));
+
+		timespec ts;
+		clock_gettime(CLOCK_REALTIME, &ts);
+
+		I2CCaptureHeader header{};
+		std::memcpy(header.magic, I2CCaptureHeader::MAGIC, sizeof(header.magic));
+		header.version = I2CCaptureHeader::VERSION;
+		header.headerSize = sizeof(header);
+		header.sampleRate = sampleRate;
+		header.address = address;
+		header.inputMode = static_cast<uint8_t>(mode);
+		header.channelCount = static_cast<uint8_t>(m_ChannelCount);
+		header.startTime = static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+
+		m_File = std::fopen(m_Path.c_str(), "wb");
+		if (!m_File)
+			throw core::FileError(fmt::format("Failed to create capture {} ({})", m_Path, strerror(errno)));
+		std::setvbuf(m_File, nullptr, _IOFBF, WRITE_BUFFER_SIZE);
+		if (std::fwrite(&header, sizeof(header), 1, m_File) != 1) {
+			std::fclose(m_File);
+			throw core::FileError(fmt::format("Failed to write capture header to {}", m_Path));
+		}
+	}
+
+	I2CCaptureWriter::~I2CCaptureWriter() {
+		if (m_File)
+			std::fclose(m_File);
+	}
+
+	void I2CCaptureWriter::Write(std::span<const uint8_t> frame) {
+		if (frame.size() < static_cast<std::size_t>(m_ChannelCount))
+			throw core::InvalidParameter(fmt::format("I2CCaptureWriter::Write(): Need {} bytes, got {}",
+						m_ChannelCount, frame.size()));
+		if (std::fwrite(frame.data(), 1, m_ChannelCount, m_File) != static_cast<std::size_t>(m_ChannelCount))
+			throw core::FileError(fmt::format("Failed to write to capture {}", m_Path));
+		++m_FrameCount;
+	}
+
+	void I2CCaptureWriter::Flush() {
+		std::fflush(m_File);
+	}
+}
+}
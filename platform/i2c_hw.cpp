@@ -18,18 +18,20 @@
 
 #include <i2c_hw.h>
 
+#include <cerrno>
 #include <format>
 #include <stdexcept>
 
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <linux/i2c.h>
 #include <linux/i2c-dev.h>
 
 namespace cee {
 namespace platform {
 	HwI2CController::HwI2CController(const std::string &file, I2CContextType ctxType, Logger logger)
-	 : I2CController(ctxType, logger) {
+	 : I2CController(ctxType, logger), m_PrevAddress(NO_ADDRESS) {
 		m_Fd = open(file.c_str(), O_RDWR);
 		if (m_Fd < 0) {
 			throw core::InternalError(fmt::format("I2CController(): Failed to open I2C device {}", file));
@@ -42,6 +44,8 @@ namespace platform {
 	}
 
 	void HwI2CController::SelectDevice(uint8_t address) {
+		if (address == m_PrevAddress)
+			return;
 		int result = ioctl(m_Fd, I2C_SLAVE, address);
 		if (result < 0)
 			throw core::InternalError(fmt::format("Failed to select address {:02X} ({})", address, result));
@@ -55,5 +59,28 @@ namespace platform {
 	ssize_t HwI2CController::Write(const void *data, ssize_t count) {
 		return write(m_Fd, data, count);
 	}
+
+	ssize_t HwI2CController::Transfer(std::span<const I2CMessage> messages) {
+		if (messages.empty())
+			return 0;
+		if (messages.size() > I2C_RDWR_IOCTL_MAX_MSGS)
+			return -EINVAL;
+
+		i2c_msg msgs[I2C_RDWR_IOCTL_MAX_MSGS];
+		for (std::size_t i = 0; i < messages.size(); ++i) {
+			msgs[i].addr = messages[i].address;
+			msgs[i].flags = messages[i].direction == I2CMessage::Direction::Read ? I2C_M_RD : 0;
+			msgs[i].len = messages[i].length;
+			msgs[i].buf = messages[i].data;
+		}
+		i2c_rdwr_ioctl_data data = {
+			.msgs = msgs,
+			.nmsgs = static_cast<uint32_t>(messages.size())
+		};
+		int result = ioctl(m_Fd, I2C_RDWR, &data);
+		if (result < 0)
+			return -errno;
+		return result;
+	}
 }
 }
@@ -35,9 +35,15 @@ namespace platform {
 		virtual ssize_t Read(void *data, ssize_t count) override;
 		virtual ssize_t Write(const void *data, ssize_t count) override;
 
+		virtual ssize_t Transfer(std::span<const I2CMessage> messages) override;
+
+	private:
+		// Not a valid 7-bit address, forces the first SelectDevice() through
+		static constexpr uint16_t NO_ADDRESS = 0xFFFF;
+
 	private:
 		int m_Fd;
-		uint8_t m_PrevAddress;
+		uint16_t m_PrevAddress;
 
 	public:
 		friend std::shared_ptr<I2CController> I2CController::Create(const std::string &file,
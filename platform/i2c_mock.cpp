@@ -19,40 +19,200 @@
 #include <i2c_mock.h>
 #include <log.h>
 
-#include <chrono>
+#include <algorithm>
+#include <cerrno>
 #include <cmath>
-#include <format>
-#include <stdexcept>
+#include <cstdlib>
+#include <numbers>
+#include <string_view>
 
 namespace cee {
 namespace platform {
-	static auto g_TimeStart = std::chrono::steady_clock::now();
-	std::chrono::duration<float, std::milli> ts;
-
-	static uint8_t NextAdcChan0(float f) {
-		using namespace std::chrono;
-		ts = duration_cast<milliseconds>(steady_clock::now() - g_TimeStart);
-		float t = ts.count() / 1000.f;
-
-		float v = 125.f * std::pow(std::sin(t * f), 50.f) +
-			25.f * std::pow(std::sin(t * f - 1), 50.f) +
-			15.f * std::pow(std::sin(t * f + 1), 50.f) -
-			40.f * std::pow(std::sin(t * f - 0.2), 50.f) -
-			15.f * std::pow(std::sin(t * f + 0.4), 50.f) +
-			20.f;
-		return static_cast<uint8_t>(v);
+	static constexpr MockI2CController::Waveform g_DefaultWaveforms[] = {
+		{ MockI2CController::Shape::ECG,      1.2f,  125.f,  20.f },
+		{ MockI2CController::Shape::PRESSURE, 1.2f,  100.f,  80.f },
+		{ MockI2CController::Shape::SINE,     0.25f,  40.f, 128.f },
+		{ MockI2CController::Shape::DC,       0.f,     0.f, 128.f },
+	};
+
+	static constexpr float DEFAULT_RATE = 250.f;
+
+	// One period of the waveform at phase x in [0, 1), roughly within [-1, 1]
+	static float EvaluateShape(MockI2CController::Shape shape, float x) {
+		using std::numbers::pi_v;
+		switch (shape) {
+			case MockI2CController::Shape::DC:
+				return 0.f;
+			case MockI2CController::Shape::SINE:
+				return std::sin(2.f * pi_v<float> * x);
+			case MockI2CController::Shape::SQUARE:
+				return x < 0.5f ? 1.f : -1.f;
+			case MockI2CController::Shape::TRIANGLE:
+				return 1.f - 4.f * std::fabs(x - 0.5f);
+			case MockI2CController::Shape::SAWTOOTH:
+				return 2.f * x - 1.f;
+			case MockI2CController::Shape::ECG: {
+				// P wave, QRS complex and T wave from narrow sin^50 pulses
+				float t = pi_v<float> * x;
+				float v = 125.f * std::pow(std::sin(t), 50.f) +
+					25.f * std::pow(std::sin(t - 1.f), 50.f) +
+					15.f * std::pow(std::sin(t + 1.f), 50.f) -
+					40.f * std::pow(std::sin(t - 0.2f), 50.f) -
+					15.f * std::pow(std::sin(t + 0.4f), 50.f);
+				return v / 125.f;
+			}
+			case MockI2CController::Shape::PRESSURE: {
+				// Systolic peak followed by the dicrotic wave
+				auto pulse = [x](float centre, float width) {
+					float d = (x - centre) / width;
+					return std::exp(-d * d);
+				};
+				return pulse(0.15f, 0.08f) + 0.35f * pulse(0.42f, 0.09f);
+			}
+			default:
+				return 0.f;
+		}
+	}
+
+	static bool ParseShape(std::string_view name, MockI2CController::Shape &shape) {
+		static constexpr std::pair<std::string_view, MockI2CController::Shape> shapes[] = {
+			{ "dc",       MockI2CController::Shape::DC },
+			{ "sine",     MockI2CController::Shape::SINE },
+			{ "square",   MockI2CController::Shape::SQUARE },
+			{ "triangle", MockI2CController::Shape::TRIANGLE },
+			{ "sawtooth", MockI2CController::Shape::SAWTOOTH },
+			{ "ecg",      MockI2CController::Shape::ECG },
+			{ "pressure", MockI2CController::Shape::PRESSURE },
+		};
+		for (const auto &[key, value] : shapes) {
+			if (key == name) {
+				shape = value;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static float ParseFloat(std::string_view str, const std::string &config) {
+		std::string s(str);
+		char *end = nullptr;
+		float f = std::strtof(s.c_str(), &end);
+		if (s.empty() || *end != '\0' || !std::isfinite(f))
+			throw core::InvalidParameter(fmt::format("MockI2CController(): Invalid number '{}' in '{}'",
+						s, config));
+		return f;
 	}
 
 	MockI2CController::MockI2CController(const std::string &file, I2CContextType ctxType, Logger logger)
-	 : I2CController(ctxType, logger), m_PrevAddress(0) {
-		(void)file;
+	 : I2CController(ctxType, logger), m_PrevAddress(0), m_Rate(DEFAULT_RATE), m_Phase{},
+	 m_PhaseInc{}, m_Inputs{}, m_Channel(0), m_StartChannel(0), m_AutoInc(false),
+	 m_Mode(PCF8591::InputMode::SINGLE_ENDED), m_Result(0x80) {
+		std::copy(std::begin(g_DefaultWaveforms), std::end(g_DefaultWaveforms), m_Waveforms.begin());
+		ParseConfig(file);
+		BuildTables();
+		for (int i = 0; i < INPUT_COUNT; ++i)
+			m_Inputs[i] = m_Tables[i][0];
+		debug(logger, "Mock PCF8591 simulating {} Hz", m_Rate);
 	}
 
 	MockI2CController::~MockI2CController() {
 	}
 
+	void MockI2CController::ParseConfig(const std::string &config) {
+		std::string_view rest = config;
+		while (!rest.empty()) {
+			std::size_t comma = rest.find(',');
+			std::string_view option = rest.substr(0, comma);
+			rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+			if (option.empty())
+				continue;
+
+			std::size_t eq = option.find('=');
+			if (eq == std::string_view::npos)
+				throw core::InvalidParameter(fmt::format("MockI2CController(): Invalid option '{}'",
+							option));
+			std::string_view key = option.substr(0, eq);
+			std::string_view value = option.substr(eq + 1);
+
+			if (key == "rate") {
+				m_Rate = ParseFloat(value, config);
+				if (!(m_Rate > 0.f))
+					throw core::InvalidParameter(fmt::format("MockI2CController(): Invalid rate {}",
+								m_Rate));
+			} else if (key.size() == 3 && key.starts_with("ch") && key[2] >= '0' &&
+					key[2] < '0' + INPUT_COUNT) {
+				Waveform &wave = m_Waveforms[key[2] - '0'];
+				if (std::count(value.begin(), value.end(), ':') > 3)
+					throw core::InvalidParameter(fmt::format("MockI2CController(): Too many fields in '{}'",
+								option));
+				std::string_view fields[4];
+				int fieldCount = 0;
+				while (true) {
+					std::size_t colon = value.find(':');
+					fields[fieldCount++] = value.substr(0, colon);
+					if (colon == std::string_view::npos)
+						break;
+					value = value.substr(colon + 1);
+				}
+				if (!ParseShape(fields[0], wave.shape))
+					throw core::InvalidParameter(fmt::format("MockI2CController(): Unknown shape '{}'",
+								fields[0]));
+				if (fieldCount > 1 && !fields[1].empty())
+					wave.frequency = ParseFloat(fields[1], config);
+				if (fieldCount > 2 && !fields[2].empty())
+					wave.amplitude = ParseFloat(fields[2], config);
+				if (fieldCount > 3 && !fields[3].empty())
+					wave.offset = ParseFloat(fields[3], config);
+			} else {
+				throw core::InvalidParameter(fmt::format("MockI2CController(): Unknown option '{}'",
+							key));
+			}
+		}
+	}
+
+	void MockI2CController::BuildTables() {
+		for (int i = 0; i < INPUT_COUNT; ++i) {
+			const Waveform &wave = m_Waveforms[i];
+			for (int j = 0; j < TABLE_SIZE; ++j) {
+				float x = static_cast<float>(j) / TABLE_SIZE;
+				float v = wave.offset + wave.amplitude * EvaluateShape(wave.shape, x);
+				m_Tables[i][j] = static_cast<uint8_t>(std::clamp(std::lround(v), 0l, 255l));
+			}
+			// Phase is a 32 bit fraction of a period, the top bits index the table
+			double cycles = std::fabs(static_cast<double>(wave.frequency)) / m_Rate;
+			m_PhaseInc[i] = static_cast<uint32_t>(std::llround(std::fmod(cycles, 1.0) * 4294967296.0));
+		}
+	}
+
+	void MockI2CController::Tick() {
+		for (int i = 0; i < INPUT_COUNT; ++i) {
+			m_Phase[i] += m_PhaseInc[i];
+			m_Inputs[i] = m_Tables[i][m_Phase[i] >> (32 - TABLE_BITS)];
+		}
+	}
+
+	uint8_t MockI2CController::Convert(int channel) const {
+		// Differential results are two's complement
+		auto diff = [this](int p, int n) {
+			int v = std::clamp(static_cast<int>(m_Inputs[p]) - static_cast<int>(m_Inputs[n]), -128, 127);
+			return static_cast<uint8_t>(v);
+		};
+		switch (m_Mode) {
+			case PCF8591::InputMode::SINGLE_ENDED:
+				return m_Inputs[channel];
+			case PCF8591::InputMode::THREE_DIFFERENTIAL:
+				return diff(channel, 3);
+			case PCF8591::InputMode::ONE_DIFFERENTIAL:
+				return channel < 2 ? m_Inputs[channel] : diff(2, 3);
+			case PCF8591::InputMode::TWO_DIFFERENTIAL:
+				return channel == 0 ? diff(0, 1) : diff(2, 3);
+			default:
+				return 0;
+		}
+	}
+
 	void MockI2CController::SelectDevice(uint8_t address) {
-		if (address == 0x48) {
+		if (address == ADC_ADDRESS) {
 			m_PrevAddress = address;
 			return;
 		}
@@ -64,17 +224,46 @@ namespace platform {
 	}
 
 	ssize_t MockI2CController::Read(void *data, ssize_t count) {
-		if (m_PrevAddress == 0x48 && count == 1) {
-			*reinterpret_cast<uint8_t*>(data) = m_PrevAdcVal;
-			m_PrevAdcVal = NextAdcChan0(2.5f);
-			return count;
+		if (m_PrevAddress != ADC_ADDRESS || count <= 0)
+			return 0;
+		uint8_t *bytes = reinterpret_cast<uint8_t*>(data);
+		int channelCount = PCF8591::ChannelCount(m_Mode);
+		for (ssize_t i = 0; i < count; ++i) {
+			// Each byte clocks out the previous result while the current
+			// channel is converted
+			bytes[i] = m_Result;
+			if (m_Channel == m_StartChannel)
+				Tick();
+			m_Result = Convert(m_Channel);
+			if (m_AutoInc)
+				m_Channel = (m_Channel + 1) % channelCount;
 		}
-		return 0;
+		return count;
 	}
 
 	ssize_t MockI2CController::Write(const void *data, ssize_t count) {
+		if (m_PrevAddress != ADC_ADDRESS || count <= 0)
+			return 0;
+		// Only the control byte matters, any following bytes set the DAC
+		uint8_t control = *reinterpret_cast<const uint8_t*>(data);
+		m_Mode = static_cast<PCF8591::InputMode>((control >> 4) & 0b11);
+		m_AutoInc = control & (1 << 2);
+		m_Channel = std::min<int>(control & 0b11, PCF8591::ChannelCount(m_Mode) - 1);
+		m_StartChannel = m_Channel;
 		return count;
 	}
+
+	ssize_t MockI2CController::Transfer(std::span<const I2CMessage> messages) {
+		ssize_t transferred = 0;
+		for (const I2CMessage &msg : messages) {
+			SelectDevice(msg.address);
+			ssize_t result = msg.direction == I2CMessage::Direction::Read ?
+				Read(msg.data, msg.length) : Write(msg.data, msg.length);
+			if (result != msg.length)
+				return transferred ? transferred : -EIO;
+			++transferred;
+		}
+		return transferred;
+	}
 }
 }
-
@@ -21,9 +21,49 @@
 
 #include <cee/platform/i2c.h>
 
+#include <array>
+
 namespace cee {
 namespace platform {
+	/*
+	 * Emulates a PCF8591 at address 0x48 whose analog inputs are fed from
+	 * precomputed waveform tables. Time is simulated: the clock advances by
+	 * one sample period every time the channel selected by the last control
+	 * byte is converted, i.e. once per auto-increment scan, so the output
+	 * only depends on the configuration and the sequence of accesses and
+	 * samples can be pulled as fast as the consumer wants them.
+	 *
+	 * The waveforms are configured through the file argument of Create()
+	 * as a comma separated list of options:
+	 *
+	 *   rate=<hz>                             simulated sample rate
+	 *   ch<n>=<shape>[:<hz>[:<amp>[:<off>]]]  waveform of analog input n
+	 *
+	 * where shape is one of dc, sine, square, triangle, sawtooth, ecg or
+	 * pressure. Amplitude and offset are in ADC counts, empty fields keep
+	 * the channel's default.
+	 */
 	class MockI2CController : public I2CController {
+	public:
+		static constexpr uint8_t ADC_ADDRESS = 0x48;
+
+		enum class Shape : uint8_t {
+			DC = 0,
+			SINE,
+			SQUARE,
+			TRIANGLE,
+			SAWTOOTH,
+			ECG,
+			PRESSURE,
+		};
+
+		struct Waveform {
+			Shape shape;
+			float frequency;
+			float amplitude;
+			float offset;
+		};
+
 	protected:
 		MockI2CController(const std::string &file, I2CContextType ctxType, Logger logger);
 
@@ -35,9 +75,34 @@ namespace platform {
 		virtual ssize_t Read(void *data, ssize_t count) override;
 		virtual ssize_t Write(const void *data, ssize_t count) override;
 
+		virtual ssize_t Transfer(std::span<const I2CMessage> messages) override;
+
+	private:
+		static constexpr int TABLE_BITS = 10;
+		static constexpr int TABLE_SIZE = 1 << TABLE_BITS;
+		static constexpr int INPUT_COUNT = PCF8591::MAX_CHANNELS;
+
+		void ParseConfig(const std::string &config);
+		void BuildTables();
+		void Tick();
+		uint8_t Convert(int channel) const;
+
 	private:
 		uint8_t m_PrevAddress;
-		uint8_t m_PrevAdcVal;
+
+		float m_Rate;
+		std::array<Waveform, INPUT_COUNT> m_Waveforms;
+		std::array<std::array<uint8_t, TABLE_SIZE>, INPUT_COUNT> m_Tables;
+		std::array<uint32_t, INPUT_COUNT> m_Phase;
+		std::array<uint32_t, INPUT_COUNT> m_PhaseInc;
+		std::array<uint8_t, INPUT_COUNT> m_Inputs;
+
+		// PCF8591 register state
+		int m_Channel;
+		int m_StartChannel;
+		bool m_AutoInc;
+		PCF8591::InputMode m_Mode;
+		uint8_t m_Result;
 
 	public:
 		friend std::shared_ptr<I2CController> I2CController::Create(const std::string &file,
@@ -48,4 +113,3 @@ namespace platform {
 }
 
 #endif
-
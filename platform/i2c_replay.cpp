@@ -0,0 +1,147 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <i2c_replay.h>
+#include <log.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cee {
+namespace platform {
+	// Returned for the priming read, the power-on value of the ADC register
+	static constexpr uint8_t PRIMING_VALUE = 0x80;
+
+	ReplayI2CController::ReplayI2CController(const std::string &file, I2CContextType ctxType, Logger logger)
+	 : I2CController(ctxType, logger), m_Map(nullptr), m_MapSize(0), m_Frames(nullptr),
+	 m_FramesSize(0), m_Offset(0), m_PrevAddress(0), m_Priming(false), m_Loops(0) {
+		int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			throw core::FileError(fmt::format("I2CController(): Failed to open capture {} ({})",
+						file, strerror(errno)));
+		struct stat st;
+		if (fstat(fd, &st) < 0 || st.st_size < static_cast<off_t>(sizeof(I2CCaptureHeader))) {
+			close(fd);
+			throw core::FileError(fmt::format("I2CController(): {} is not a valid capture file", file));
+		}
+		m_MapSize = static_cast<std::size_t>(st.st_size);
+		void *map = mmap(nullptr, m_MapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (map == MAP_FAILED)
+			throw core::FileError(fmt::format("I2CController(): Failed to map capture {} ({})",
+						file, strerror(errno)));
+		madvise(map, m_MapSize, MADV_SEQUENTIAL);
+		m_Map = static_cast<const uint8_t*>(map);
+
+		std::memcpy(&m_Header, m_Map, sizeof(m_Header));
+		if (!m_Header.IsValid() || m_Header.headerSize >= m_MapSize) {
+			munmap(map, m_MapSize);
+			throw core::FileError(fmt::format("I2CController(): {} is not a valid capture file", file));
+		}
+		// A partial frame at the end is left over from an interrupted capture
+		m_Frames = m_Map + m_Header.headerSize;
+		m_FramesSize = m_MapSize - m_Header.headerSize;
+		m_FramesSize -= m_FramesSize % m_Header.channelCount;
+		if (m_FramesSize == 0) {
+			munmap(map, m_MapSize);
+			throw core::FileError(fmt::format("I2CController(): Capture {} holds no frames", file));
+		}
+		debug(logger, "Replaying {} frames of {} channels at {} Hz from {}",
+				m_FramesSize / m_Header.channelCount, m_Header.channelCount, m_Header.sampleRate, file);
+	}
+
+	ReplayI2CController::~ReplayI2CController() {
+		if (m_Map)
+			munmap(const_cast<uint8_t*>(m_Map), m_MapSize);
+	}
+
+	void ReplayI2CController::SelectDevice(uint8_t address) {
+		if (address == m_Header.address) {
+			m_PrevAddress = address;
+			return;
+		}
+		m_PrevAddress = 0;
+#ifndef NDEBUG
+		throw core::InvalidParameter(fmt::format("I2CController::SelectDevice(): Unexpected address {:02X}",
+					address));
+#endif
+	}
+
+	ssize_t ReplayI2CController::Read(void *data, ssize_t count) {
+		if (m_PrevAddress != m_Header.address || count <= 0)
+			return 0;
+		uint8_t *bytes = reinterpret_cast<uint8_t*>(data);
+		std::size_t remaining = static_cast<std::size_t>(count);
+		if (m_Priming) {
+			*bytes++ = PRIMING_VALUE;
+			--remaining;
+			m_Priming = false;
+		}
+		while (remaining > 0) {
+			std::size_t n = std::min(remaining, m_FramesSize - m_Offset);
+			std::memcpy(bytes, m_Frames + m_Offset, n);
+			bytes += n;
+			remaining -= n;
+			m_Offset += n;
+			if (m_Offset == m_FramesSize) {
+				m_Offset = 0;
+				debug(logger(), "Capture finished, restarting playback (loop {})", ++m_Loops);
+			}
+		}
+		return count;
+	}
+
+	ssize_t ReplayI2CController::Write(const void *data, ssize_t count) {
+		if (m_PrevAddress != m_Header.address || count <= 0)
+			return 0;
+		uint8_t control = *reinterpret_cast<const uint8_t*>(data);
+		uint8_t mode = (control >> 4) & 0b11;
+		if (mode != m_Header.inputMode) {
+			error(logger(), "Capture was recorded in input mode {}, not {}", m_Header.inputMode, mode);
+			return 0;
+		}
+		// A new control byte restarts the scan, continue from the next whole
+		// frame so the channels stay aligned
+		std::size_t frame = m_Header.channelCount;
+		m_Offset = (m_Offset + frame - 1) / frame * frame;
+		if (m_Offset == m_FramesSize)
+			m_Offset = 0;
+		m_Priming = true;
+		return count;
+	}
+
+	ssize_t ReplayI2CController::Transfer(std::span<const I2CMessage> messages) {
+		ssize_t transferred = 0;
+		for (const I2CMessage &msg : messages) {
+			SelectDevice(msg.address);
+			ssize_t result = msg.direction == I2CMessage::Direction::Read ?
+				Read(msg.data, msg.length) : Write(msg.data, msg.length);
+			if (result != msg.length)
+				return transferred ? transferred : -EIO;
+			++transferred;
+		}
+		return transferred;
+	}
+}
+}
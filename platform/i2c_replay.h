@@ -0,0 +1,71 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_PLATFORM_I2C_REPLAY_H_
+#define CEE_PLATFORM_I2C_REPLAY_H_
+
+#include <cee/platform/i2c.h>
+#include <cee/platform/i2c_capture.h>
+
+namespace cee {
+namespace platform {
+	/*
+	 * Plays back an I2CCaptureWriter capture in place of the PCF8591. The
+	 * file is memory mapped and each Read() copies the next frame bytes out
+	 * of the mapping into the caller's buffer, as I2CController reads
+	 * always fill a caller buffer, looping at the end. Playback assumes the access pattern of
+	 * PCF8591::StartScan()/Scan(): the single byte read following a control
+	 * byte is the discarded priming read and every other read consumes
+	 * frame data. Pacing is left to the caller, the capture's sample rate is
+	 * available through ReadI2CCaptureHeader().
+	 */
+	class ReplayI2CController : public I2CController {
+	protected:
+		ReplayI2CController(const std::string &file, I2CContextType ctxType, Logger logger);
+
+	public:
+		virtual ~ReplayI2CController();
+
+		virtual void SelectDevice(uint8_t address) override;
+
+		virtual ssize_t Read(void *data, ssize_t count) override;
+		virtual ssize_t Write(const void *data, ssize_t count) override;
+
+		virtual ssize_t Transfer(std::span<const I2CMessage> messages) override;
+
+	private:
+		I2CCaptureHeader m_Header;
+		const uint8_t *m_Map;
+		std::size_t m_MapSize;
+		const uint8_t *m_Frames;
+		std::size_t m_FramesSize;
+		std::size_t m_Offset;
+
+		uint8_t m_PrevAddress;
+		bool m_Priming;
+		uint64_t m_Loops;
+
+	public:
+		friend std::shared_ptr<I2CController> I2CController::Create(const std::string &file,
+				I2CContextType ctxType,
+				Logger logger);
+	};
+}
+}
+
+#endif
@@ -24,6 +24,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
 
 namespace cee {
@@ -32,10 +33,36 @@ namespace platform {
 		PLATFORM_I2C_CONTEXT_NONE = 0,
 		PLATFORM_I2C_CONTEXT_HW  = 1,
 		PLATFORM_I2C_CONTEXT_MOCK  = 2,
+		PLATFORM_I2C_CONTEXT_REPLAY  = 3,
 		
 		PLATFORM_I2C_CONTEXT_ENUM_MAX
 	};
 
+	/*
+	 * One segment of a combined I2C transaction. Segments after the first
+	 * are sent with a repeated start and the bus is only released after the
+	 * last one.
+	 */
+	struct I2CMessage {
+		enum class Direction : uint8_t {
+			Write = 0,
+			Read = 1
+		};
+
+		uint8_t address;
+		Direction direction;
+		uint16_t length;
+		uint8_t *data;
+
+		static I2CMessage MakeWrite(uint8_t address, const void *data, uint16_t length) {
+			return { address, Direction::Write, length,
+				const_cast<uint8_t *>(static_cast<const uint8_t *>(data)) };
+		}
+		static I2CMessage MakeRead(uint8_t address, void *data, uint16_t length) {
+			return { address, Direction::Read, length, static_cast<uint8_t *>(data) };
+		}
+	};
+
 	class I2CController {
 	protected:
 		I2CController(I2CContextType ctxtype, Logger logger)
@@ -50,6 +77,10 @@ namespace platform {
 		virtual ssize_t Read(void *data, ssize_t count) = 0;
 		virtual ssize_t Write(const void *data, ssize_t count) = 0;
 
+		// Runs all messages as a single combined transaction. Returns the
+		// number of messages transferred or a negative errno value.
+		virtual ssize_t Transfer(std::span<const I2CMessage> messages) = 0;
+
 		I2CContextType GetContextType() const { return m_CtxType; }
 
 		static std::shared_ptr<I2CController> Create(const std::string &file,
@@ -73,14 +104,43 @@ namespace platform {
 			TWO_DIFFERENTIAL,
 		};
 
+		static constexpr int MAX_CHANNELS = 4;
+
 	public:
-		PCF8591(std::shared_ptr<I2CController> ctrl, uint8_t addr) : m_Ctrl(ctrl), m_Address(addr) {}
+		PCF8591(std::shared_ptr<I2CController> ctrl, uint8_t addr)
+		 : m_Ctrl(ctrl), m_Address(addr), m_CurChannel(-1), m_AutoInc(false),
+		 m_InputMode(InputMode::SINGLE_ENDED), m_OutputEnable(false), m_Scanning(false) {
+		}
 		~PCF8591() {}
 
 		uint8_t Read();
 		void SendControl(int channel, bool autoinc, InputMode mode, bool outputEnable);
 		void SelectChannel(int channel);
 
+		/*
+		 * Multi-channel scanning. StartScan() puts the chip into
+		 * auto-increment mode starting at channel 0 and primes the
+		 * conversion pipeline, after which every Scan() reads one
+		 * conversion of every channel of the input mode in a single
+		 * burst. The chip converts each channel while the previous result
+		 * is being clocked out, so values[0] holds the conversion that
+		 * completed at the end of the previous scan.
+		 */
+		void StartScan(InputMode mode = InputMode::SINGLE_ENDED, bool outputEnable = false);
+		int Scan(std::span<uint8_t> values);
+		bool IsScanning() const { return m_Scanning; }
+
+		static constexpr int ChannelCount(InputMode mode) {
+			switch (mode) {
+				case InputMode::SINGLE_ENDED:       return 4;
+				case InputMode::THREE_DIFFERENTIAL: return 3;
+				case InputMode::ONE_DIFFERENTIAL:   return 3;
+				case InputMode::TWO_DIFFERENTIAL:   return 2;
+				default:
+					throw core::InvalidParameter("PCF8591::ChannelCount(): Invalid mode");
+			}
+		}
+
 	private:
 		static constexpr uint8_t ComposeControlByte(uint8_t channel,
 				bool autoinc, InputMode mode, bool outputEnable) {
@@ -112,6 +172,7 @@ namespace platform {
 		bool m_AutoInc;
 		InputMode m_InputMode;
 		bool m_OutputEnable;
+		bool m_Scanning;
 	};
 }
 }
@@ -0,0 +1,90 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CEE_PLATFORM_I2C_CAPTURE_H_
+#define CEE_PLATFORM_I2C_CAPTURE_H_
+
+#include <cee/platform/i2c.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+
+namespace cee {
+namespace platform {
+	/*
+	 * Raw ADC capture file, replayed by the PLATFORM_I2C_CONTEXT_REPLAY
+	 * backend. The header is followed by fixed rate frames holding the bytes
+	 * of one PCF8591 scan exactly as they came off the bus, channelCount
+	 * bytes each. Fields are stored in host byte order.
+	 */
+	struct I2CCaptureHeader {
+		static constexpr char MAGIC[8] = { 'C', 'E', 'E', 'I', '2', 'C', 'C', 'P' };
+		static constexpr uint32_t VERSION = 1;
+
+		char magic[8];
+		uint32_t version;
+		uint32_t headerSize;   // Offset of the first frame
+		float sampleRate;      // Frames per second
+		uint8_t address;
+		uint8_t inputMode;     // PCF8591::InputMode
+		uint8_t channelCount;
+		uint8_t reserved;
+		uint64_t startTime;    // CLOCK_REALTIME of the first frame, nanoseconds
+
+		bool IsValid() const {
+			return std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 && version == VERSION &&
+				headerSize >= sizeof(I2CCaptureHeader) && sampleRate > 0.f &&
+				inputMode <= static_cast<uint8_t>(PCF8591::InputMode::TWO_DIFFERENTIAL) &&
+				channelCount == PCF8591::ChannelCount(static_cast<PCF8591::InputMode>(inputMode));
+		}
+	};
+	static_assert(sizeof(I2CCaptureHeader) == 32, "Capture header layout changed");
+
+	// Throws core::FileError if the file can't be read or isn't a capture
+	I2CCaptureHeader ReadI2CCaptureHeader(const std::string &path);
+
+	class I2CCaptureWriter {
+	public:
+		I2CCaptureWriter(const std::string &path, float sampleRate,
+				PCF8591::InputMode mode = PCF8591::InputMode::SINGLE_ENDED,
+				uint8_t address = 0x48);
+		~I2CCaptureWriter();
+
+		I2CCaptureWriter(const I2CCaptureWriter &) = delete;
+		I2CCaptureWriter &operator=(const I2CCaptureWriter &) = delete;
+
+		// frame must hold at least channelCount bytes, extra bytes are ignored
+		void Write(std::span<const uint8_t> frame);
+		void Flush();
+
+		int GetChannelCount() const { return m_ChannelCount; }
+		uint64_t GetFrameCount() const { return m_FrameCount; }
+
+	private:
+		std::string m_Path;
+		std::FILE *m_File;
+		int m_ChannelCount;
+		uint64_t m_FrameCount;
+	};
+}
+}
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * ceeCore
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/core/event_log.h>
+#include <cee/core/except.h>
+
+#include <gtest/gtest.h>
+
+#include "test_utils.h"
+
+#include <filesystem>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cee::test::TempPath;
+
+static std::vector<cee::EventLogEntry> ReadAll(cee::EventLogReader &reader) {
+	std::vector<cee::EventLogEntry> entries;
+	cee::EventLogEntry entry;
+	while (reader.Next(entry))
+		entries.push_back(entry);
+	return entries;
+}
+
+TEST(EventLog, roundTrip)
+{
+	const std::string path = TempPath("cee_events_round_trip.evl");
+	{
+		cee::EventLog events(path);
+		for (int i = 0; i < 3; ++i)
+			CEE_EVENT(events, "sample {} of {}", uint64_t(i), -3);
+		CEE_EVENT(events, "started");
+		CEE_EVENT(events, "{} {} {:.2f} {:.3f} {} {}", true, int8_t(-8), 1.25f, 2.5, uint16_t(65535),
+				int64_t(-1) << 40);
+	}
+
+	cee::EventLogReader reader(path);
+	std::vector<cee::EventLogEntry> entries = ReadAll(reader);
+	EXPECT_FALSE(reader.IsTruncated());
+	EXPECT_EQ(reader.GetFormatCount(), 3u);
+	ASSERT_EQ(entries.size(), 5u);
+	EXPECT_EQ(entries[0].text, "sample 0 of -3");
+	EXPECT_EQ(entries[2].text, "sample 2 of -3");
+	EXPECT_EQ(entries[0].id, entries[2].id);
+	EXPECT_EQ(entries[3].text, "started");
+	EXPECT_EQ(entries[4].text, fmt::format("true -8 1.25 2.500 65535 {}", int64_t(-1) << 40));
+	for (std::size_t i = 0; i < entries.size(); ++i) {
+		EXPECT_EQ(entries[i].kind, cee::EventLogEntry::Kind::EVENT);
+		EXPECT_GE(entries[i].timestamp, reader.GetHeader().startMonotonic);
+		if (i > 0) {
+			EXPECT_GE(entries[i].timestamp, entries[i - 1].timestamp);
+		}
+	}
+}
+
+TEST(EventLog, concurrentWriters)
+{
+	const std::string path = TempPath("cee_events_concurrent.evl");
+	const uint32_t perThread = 3000;
+	uint64_t dropped;
+	{
+		cee::EventLog events(path);
+		std::vector<std::thread> threads;
+		for (uint32_t t = 0; t < 4; ++t) {
+			threads.emplace_back([&events, t, perThread] {
+				for (uint32_t i = 0; i < perThread; ++i)
+					CEE_EVENT(events, "thread {} event {}", t, i);
+			});
+		}
+		for (std::thread &thread : threads)
+			thread.join();
+		dropped = events.GetDroppedCount();
+	}
+
+	cee::EventLogReader reader(path);
+	std::set<std::string> seen;
+	uint64_t reportedDropped = 0;
+	cee::EventLogEntry entry;
+	while (reader.Next(entry)) {
+		if (entry.kind == cee::EventLogEntry::Kind::DROPPED)
+			reportedDropped += entry.droppedCount;
+		else
+			EXPECT_TRUE(seen.insert(entry.text).second) << entry.text;
+	}
+	EXPECT_EQ(reportedDropped, dropped);
+	EXPECT_EQ(seen.size() + dropped, 4 * perThread);
+}
+
+TEST(EventLog, truncated)
+{
+	const std::string path = TempPath("cee_events_truncated.evl");
+	{
+		cee::EventLog events(path);
+		for (uint32_t i = 0; i < 10; ++i)
+			CEE_EVENT(events, "frame {} took {} us", i, 16.5f);
+	}
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+
+	cee::EventLogReader reader(path);
+	std::vector<cee::EventLogEntry> entries = ReadAll(reader);
+	EXPECT_TRUE(reader.IsTruncated());
+	ASSERT_EQ(entries.size(), 9u);
+	EXPECT_EQ(entries[8].text, "frame 8 took 16.5 us");
+
+	std::filesystem::resize_file(path, 8);
+	EXPECT_THROW(cee::EventLogReader bad(path), cee::core::FileError);
+	EXPECT_THROW(cee::EventLogReader missing(TempPath("cee_events_missing.evl")), cee::core::FileError);
+}
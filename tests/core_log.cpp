@@ -0,0 +1,135 @@
+/*
+ * ceeCore
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/core/log.h>
+
+#include <gtest/gtest.h>
+
+#include "test_utils.h"
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using cee::test::TempPath;
+
+// Lines of the log file containing text
+static std::size_t CountLines(const std::string &path, const std::string &text) {
+	std::ifstream file(path);
+	std::size_t count = 0;
+	for (std::string line; std::getline(file, line);)
+		count += line.find(text) != std::string::npos ? 1 : 0;
+	return count;
+}
+
+TEST(Log, asyncBlockKeepsEverything)
+{
+	const std::string path = TempPath("cee_log_block.log");
+	{
+		cee::Log log("cee_log_block", path, spdlog::level::info, cee::LogMode::ASYNC_BLOCK);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t) {
+			threads.emplace_back([&log, t] {
+				cee::Logger logger = log.GetLogger();
+				for (int i = 0; i < 500; ++i)
+					logger->info("block message {} {}", t, i);
+			});
+		}
+		for (std::thread &thread : threads)
+			thread.join();
+		EXPECT_EQ(log.GetDroppedCount(), 0u);
+	}
+	EXPECT_EQ(CountLines(path, "block message"), 2000u);
+	EXPECT_EQ(CountLines(path, "block message 3 499"), 1u);
+}
+
+TEST(Log, asyncStopKeepsRacingMessages)
+{
+	const std::string path = TempPath("cee_log_stop.log");
+	const int sent = 20000;
+	std::atomic<int> logged(0);
+	std::thread thread;
+	cee::Logger logger;
+	{
+		cee::Log log("cee_log_stop", path, spdlog::level::info, cee::LogMode::ASYNC_BLOCK);
+		logger = log.GetLogger();
+		// Still logging while the sink stops and after it has
+		thread = std::thread([logger, &logged] {
+			for (int i = 0; i < sent; ++i) {
+				logger->info("stop message {}", i);
+				logged.fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+		while (logged.load(std::memory_order_relaxed) < 1000)
+			std::this_thread::yield();
+	}
+	thread.join();
+	logger->flush();
+	EXPECT_EQ(CountLines(path, "stop message"), static_cast<std::size_t>(sent));
+}
+
+TEST(Log, asyncDropCounts)
+{
+	const std::string path = TempPath("cee_log_drop.log");
+	const std::size_t sent = 4 * cee::Log::QUEUE_SIZE;
+	uint64_t dropped;
+	{
+		cee::Log log("cee_log_drop", path, spdlog::level::info, cee::LogMode::ASYNC_DROP);
+		cee::Logger child = log.CreateChild("cee_log_drop_child");
+		for (std::size_t i = 0; i < sent; ++i)
+			child->info("drop message {}", i);
+		dropped = log.GetDroppedCount();
+	}
+	EXPECT_EQ(CountLines(path, "drop message") + dropped, sent);
+	EXPECT_EQ(CountLines(path, "cee_log_drop_child: drop message 0"), 1u);
+	if (dropped > 0) {
+		EXPECT_GE(CountLines(path, "log messages dropped"), 1u);
+	}
+}
+
+TEST(Log, asyncTruncatesLongMessages)
+{
+	const std::string path = TempPath("cee_log_long.log");
+	const std::string text(3 * cee::Log::MESSAGE_SIZE, 'x');
+	{
+		cee::Log log("cee_log_long", path, spdlog::level::info, cee::LogMode::ASYNC_DROP);
+		log.GetLogger()->warn("{}", text);
+	}
+	std::string kept = text.substr(0, cee::Log::MESSAGE_SIZE - 3) + "...";
+	EXPECT_EQ(CountLines(path, "cee_log_long: " + kept), 1u);
+	EXPECT_EQ(CountLines(path, kept + "x"), 0u);
+}
+
+TEST(Log, compileTimeLevel)
+{
+	const std::string path = TempPath("cee_log_level.log");
+	cee::Log log("cee_log_level", path, spdlog::level::trace);
+	int evaluated = 0;
+	CEE_LOG_TRACE(log.GetLogger(), "trace {}", ++evaluated);
+	CEE_LOG_DEBUG(log.GetLogger(), "debug {}", ++evaluated);
+	CEE_LOG_INFO(log.GetLogger(), "info {}", ++evaluated);
+	CEE_LOG_WARN(log.GetLogger(), "warn {}", ++evaluated);
+	CEE_LOG_ERROR(log.GetLogger(), "error {}", ++evaluated);
+	CEE_LOG_CRITICAL(log.GetLogger(), "critical {}", ++evaluated);
+	int expected = 0;
+	for (int level = SPDLOG_LEVEL_TRACE; level <= SPDLOG_LEVEL_CRITICAL; ++level)
+		expected += CEE_LOG_ACTIVE_LEVEL <= level ? 1 : 0;
+	EXPECT_EQ(evaluated, expected);
+}
@@ -0,0 +1,173 @@
+/*
+ * ceeCore
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/core/ringbuffer.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+#include <vector>
+
+TEST(RingBuffer, fifo)
+{
+	cee::RingBuffer<int, 4> rb;
+	rb.Enqueue(1);
+	rb.Enqueue(2);
+	rb.Enqueue(3);
+	rb.Enqueue(4);
+	EXPECT_TRUE(rb.Full());
+	EXPECT_THROW(rb.Enqueue(5), cee::core::UsageError);
+	EXPECT_EQ(rb.Dequeue(), 1);
+	rb.Enqueue(5);
+	EXPECT_EQ(rb.Dequeue(), 2);
+	EXPECT_EQ(rb.Dequeue(), 3);
+	EXPECT_EQ(rb.Dequeue(), 4);
+	EXPECT_EQ(rb.Dequeue(), 5);
+	EXPECT_TRUE(rb.Empty());
+	EXPECT_THROW(rb.Dequeue(), cee::core::UsageError);
+}
+
+TEST(SPSCRingBuffer, tryEnqueueDequeue)
+{
+	cee::SPSCRingBuffer<int, 4> rb;
+	int v = 0;
+	EXPECT_FALSE(rb.TryDequeue(v));
+	for (int i = 0; i < 4; ++i)
+		EXPECT_TRUE(rb.TryEnqueue(i));
+	EXPECT_FALSE(rb.TryEnqueue(4));
+	EXPECT_EQ(rb.Size(), 4u);
+	for (int i = 0; i < 4; ++i) {
+		EXPECT_TRUE(rb.TryDequeue(v));
+		EXPECT_EQ(v, i);
+	}
+	EXPECT_TRUE(rb.Empty());
+}
+
+TEST(SPSCRingBuffer, spansWrapAround)
+{
+	cee::SPSCRingBuffer<int, 8> rb;
+	std::array<int, 6> in{ 0, 1, 2, 3, 4, 5 };
+	std::array<int, 6> out{};
+
+	EXPECT_EQ(rb.EnqueueSpan(in), 6u);
+	EXPECT_EQ(rb.DequeueSpan(std::span(out).first(4)), 4u);
+	// Only 6 of the 8 slots are free, the span straddles the end of the buffer
+	EXPECT_EQ(rb.EnqueueSpan(in), 6u);
+	EXPECT_EQ(rb.EnqueueSpan(in), 0u);
+
+	std::array<int, 8> all{};
+	EXPECT_EQ(rb.DequeueSpan(all), 8u);
+	std::array<int, 8> expected{ 4, 5, 0, 1, 2, 3, 4, 5 };
+	EXPECT_EQ(all, expected);
+	EXPECT_EQ(rb.DequeueSpan(all), 0u);
+}
+
+TEST(SPSCRingBuffer, concurrent)
+{
+	constexpr int COUNT = 1 << 16;
+	cee::SPSCRingBuffer<int, 1024> rb;
+	std::thread producer([&rb]() {
+		std::array<int, 37> block;
+		int next = 0;
+		while (next < COUNT) {
+			int n = std::min<int>(block.size(), COUNT - next);
+			for (int i = 0; i < n; ++i)
+				block[i] = next + i;
+			std::size_t pushed = rb.EnqueueSpan(std::span(block).first(n));
+			if (pushed == 0)
+				std::this_thread::yield();
+			next += pushed;
+		}
+	});
+
+	std::array<int, 64> block;
+	int expected = 0;
+	while (expected < COUNT) {
+		std::size_t n = rb.DequeueSpan(block);
+		if (n == 0)
+			std::this_thread::yield();
+		for (std::size_t i = 0; i < n; ++i)
+			ASSERT_EQ(block[i], expected++);
+	}
+	producer.join();
+	EXPECT_TRUE(rb.Empty());
+}
+
+TEST(MPSCRingBuffer, tryEnqueueDequeue)
+{
+	cee::MPSCRingBuffer<int, 4> rb;
+	int v = 0;
+	EXPECT_FALSE(rb.TryDequeue(v));
+	for (int i = 0; i < 4; ++i)
+		EXPECT_TRUE(rb.TryEnqueue(i));
+	EXPECT_FALSE(rb.TryEnqueue(4));
+	std::array<int, 3> in{ 7, 8, 9 };
+	EXPECT_EQ(rb.EnqueueSpan(in), 0u);
+	EXPECT_TRUE(rb.TryDequeue(v));
+	EXPECT_EQ(v, 0);
+	EXPECT_EQ(rb.EnqueueSpan(in), 1u);
+
+	std::array<int, 8> out{};
+	EXPECT_EQ(rb.DequeueSpan(out), 4u);
+	EXPECT_EQ(out[0], 1);
+	EXPECT_EQ(out[1], 2);
+	EXPECT_EQ(out[2], 3);
+	EXPECT_EQ(out[3], 7);
+}
+
+TEST(MPSCRingBuffer, concurrent)
+{
+	constexpr int PRODUCERS = 4;
+	constexpr int COUNT = 1 << 14;
+	cee::MPSCRingBuffer<std::pair<int, int>, 256> rb;
+
+	std::vector<std::thread> producers;
+	for (int p = 0; p < PRODUCERS; ++p) {
+		producers.emplace_back([&rb, p]() {
+			std::array<std::pair<int, int>, 5> block;
+			int next = 0;
+			while (next < COUNT) {
+				int n = std::min<int>(block.size(), COUNT - next);
+				for (int i = 0; i < n; ++i)
+					block[i] = { p, next + i };
+				std::size_t pushed = rb.EnqueueSpan(std::span(block).first(n));
+				if (pushed == 0)
+					std::this_thread::yield();
+				next += pushed;
+			}
+		});
+	}
+
+	std::array<int, PRODUCERS> expected{};
+	std::array<std::pair<int, int>, 32> block;
+	int total = 0;
+	while (total < PRODUCERS * COUNT) {
+		std::size_t n = rb.DequeueSpan(block);
+		if (n == 0)
+			std::this_thread::yield();
+		for (std::size_t i = 0; i < n; ++i) {
+			auto [p, v] = block[i];
+			ASSERT_EQ(v, expected[p]++);
+		}
+		total += n;
+	}
+	for (auto &t : producers)
+		t.join();
+	EXPECT_TRUE(rb.Empty());
+}
@@ -0,0 +1,68 @@
+/*
+ * ceeCore
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/core/seqlock.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+
+struct Snapshot {
+	uint64_t a;
+	float b;
+	uint64_t c;
+};
+
+TEST(SeqLock, storeLoad)
+{
+	cee::SeqLock<Snapshot> lock;
+	EXPECT_EQ(lock.GetVersion(), 0u);
+	EXPECT_EQ(lock.Load().a, 0u);
+	lock.Store({ 1, 2.f, 3 });
+	Snapshot s = lock.Load();
+	EXPECT_EQ(s.a, 1u);
+	EXPECT_EQ(s.b, 2.f);
+	EXPECT_EQ(s.c, 3u);
+	EXPECT_EQ(lock.GetVersion(), 1u);
+}
+
+TEST(SeqLock, concurrent)
+{
+	constexpr uint64_t COUNT = 200000;
+	cee::SeqLock<Snapshot> lock;
+	std::atomic<bool> done = false;
+
+	std::thread writer([&] {
+		for (uint64_t i = 1; i <= COUNT; ++i)
+			lock.Store({ i, static_cast<float>(i % 1000), ~i });
+		done = true;
+	});
+
+	uint64_t last = 0;
+	while (!done) {
+		Snapshot s = lock.Load();
+		// Never a mix of two stores, never going backwards
+		ASSERT_EQ(s.c, s.a == 0 ? 0 : ~s.a);
+		ASSERT_EQ(s.b, static_cast<float>(s.a % 1000));
+		ASSERT_GE(s.a, last);
+		last = s.a;
+	}
+	writer.join();
+	EXPECT_EQ(lock.Load().a, COUNT);
+}
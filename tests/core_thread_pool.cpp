@@ -0,0 +1,96 @@
+/*
+ * ceeCore
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/core/thread_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+TEST(ThreadPool, runsEveryTask)
+{
+	cee::ThreadPool pool(4);
+	EXPECT_EQ(pool.GetThreadCount(), 4u);
+	std::atomic<uint64_t> sum = 0;
+	for (uint64_t i = 1; i <= 10000; ++i)
+		pool.Submit([&sum, i] { sum += i; });
+	pool.Wait();
+	EXPECT_EQ(sum, 10000u * 10001u / 2);
+
+	// Usable again after a wait
+	pool.Submit([&sum] { sum = 0; });
+	pool.Wait();
+	EXPECT_EQ(sum, 0u);
+}
+
+// Sums [first, last) by splitting it in halves down to ranges of 1000
+static void Split(cee::ThreadPool &pool, std::atomic<uint64_t> &sum, uint64_t first, uint64_t last)
+{
+	if (last - first <= 1000) {
+		uint64_t partial = 0;
+		for (uint64_t i = first; i < last; ++i)
+			partial += i;
+		sum += partial;
+		return;
+	}
+	uint64_t middle = first + (last - first) / 2;
+	pool.Submit([&pool, &sum, first, middle] { Split(pool, sum, first, middle); });
+	pool.Submit([&pool, &sum, middle, last] { Split(pool, sum, middle, last); });
+}
+
+TEST(ThreadPool, nestedTasks)
+{
+	cee::ThreadPool pool(4);
+	std::atomic<uint64_t> sum = 0;
+	pool.Submit([&] { Split(pool, sum, 0, 1000000); });
+	pool.Wait();
+	EXPECT_EQ(sum, uint64_t(1000000) * 999999 / 2);
+}
+
+TEST(ThreadPool, stealsFromBusyWorkers)
+{
+	cee::ThreadPool pool(4);
+	std::atomic<int> done = 0;
+	// Everything lands on the deque of the worker running the first task
+	pool.Submit([&] {
+		for (int i = 0; i < 64; ++i) {
+			pool.Submit([&done] {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				++done;
+			});
+		}
+	});
+	pool.Wait();
+	EXPECT_EQ(done, 64);
+	EXPECT_GT(pool.GetStolenCount(), 0u);
+}
+
+TEST(ThreadPool, exceptions)
+{
+	cee::ThreadPool pool(2);
+	std::atomic<int> done = 0;
+	pool.Submit([] { throw std::runtime_error("task failed"); });
+	for (int i = 0; i < 10; ++i)
+		pool.Submit([&done] { ++done; });
+	EXPECT_THROW(pool.Wait(), std::runtime_error);
+	EXPECT_EQ(done, 10);
+	EXPECT_NO_THROW(pool.Wait());
+}
@@ -0,0 +1,126 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/dsp/decimate.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace cee::dsp;
+
+static constexpr float RATE = 1000.f;
+
+template<typename T, typename D>
+static std::vector<double> Decimate(D &decimator, const std::vector<double> &input) {
+	std::vector<T> block(input.size());
+	for (std::size_t i = 0; i < input.size(); ++i)
+		block[i] = SampleTraits<T>::FromFloat(input[i]);
+	std::size_t produced = decimator.Process(std::span<T>(block));
+	std::vector<double> out(produced);
+	for (std::size_t i = 0; i < produced; ++i)
+		out[i] = SampleTraits<T>::ToDouble(block[i]);
+	return out;
+}
+
+TEST(Decimate, dcGain) {
+	std::vector<double> input(1024, 0.3);
+	for (DecimatorKind kind : { DecimatorKind::AVERAGE, DecimatorKind::CIC, DecimatorKind::FIR }) {
+		Decimator<float> decimator(kind, 4, RATE);
+		std::vector<double> out = Decimate<float>(decimator, input);
+		ASSERT_EQ(out.size(), 256u);
+		// Settled once the filter has filled
+		EXPECT_NEAR(out.back(), 0.3, 1e-4) << Decimator<float>::KindName(kind);
+
+		Decimator<Q15> fixed(kind, 4, RATE);
+		out = Decimate<Q15>(fixed, input);
+		ASSERT_EQ(out.size(), 256u);
+		EXPECT_NEAR(out.back(), 0.3, 1e-3) << Decimator<Q15>::KindName(kind);
+	}
+
+	Decimator<float> passThrough(DecimatorKind::FIR, 1, RATE);
+	EXPECT_EQ(Decimate<float>(passThrough, { 0.1, 0.2, 0.3 }), (std::vector<double>{ 0.1f, 0.2f, 0.3f }));
+	EXPECT_EQ(passThrough.GetBitsGained(), 0.0);
+}
+
+TEST(Decimate, cicMatchesConvolution) {
+	std::mt19937 rng(7);
+	std::uniform_int_distribution<int> code(0, 255);
+	std::vector<double> input(600);
+	for (double &x : input)
+		x = code(rng) / 256.0;
+
+	// Three boxcars of 5 convolved, every 5th output, divided by 5^3
+	constexpr std::size_t R = 5;
+	std::vector<double> impulse(1, 1.0);
+	for (int i = 0; i < 3; ++i) {
+		std::vector<double> next(impulse.size() + R - 1, 0.0);
+		for (std::size_t j = 0; j < impulse.size(); ++j)
+			for (std::size_t k = 0; k < R; ++k)
+				next[j + k] += impulse[j] / R;
+		impulse = next;
+	}
+
+	CicDecimator<float, 3> cic(R);
+	std::vector<double> first(input.begin(), input.begin() + 333);
+	std::vector<double> second(input.begin() + 333, input.end());
+	std::vector<double> out = Decimate<float>(cic, first);
+	std::vector<double> rest = Decimate<float>(cic, second);
+	out.insert(out.end(), rest.begin(), rest.end());
+	ASSERT_EQ(out.size(), input.size() / R);
+
+	for (std::size_t n = 0; n < out.size(); ++n) {
+		std::size_t i = (n + 1) * R - 1;
+		double expected = 0.0;
+		for (std::size_t k = 0; k < impulse.size() && k <= i; ++k)
+			expected += impulse[k] * input[i - k];
+		EXPECT_NEAR(out[n], expected, 1e-6) << n;
+	}
+}
+
+TEST(Decimate, bitsGained) {
+	CicDecimator<float, 1> average(16);
+	EXPECT_DOUBLE_EQ(average.GetBitsGained(), 2.0);
+
+	// Higher orders span 3R - 2 inputs, weighted towards the middle
+	CicDecimator<float, 3> cic(16);
+	EXPECT_GT(cic.GetBitsGained(), 2.0);
+	EXPECT_LT(cic.GetBitsGained(), 0.5 * std::log2(3.0 * 16 - 2));
+
+	// Measured on white noise, the standard deviation drops by 2^bits
+	std::mt19937 rng(3);
+	std::normal_distribution<double> noise(0.0, 0.05);
+	std::vector<double> input(1 << 16);
+	for (double &x : input)
+		x = 0.5 + noise(rng);
+	for (DecimatorKind kind : { DecimatorKind::AVERAGE, DecimatorKind::CIC, DecimatorKind::FIR }) {
+		Decimator<float> decimator(kind, 8, RATE);
+		std::vector<double> out = Decimate<float>(decimator, input);
+		out.erase(out.begin(), out.begin() + 32);
+		double mean = 0.0, squares = 0.0;
+		for (double y : out)
+			mean += y;
+		mean /= static_cast<double>(out.size());
+		for (double y : out)
+			squares += (y - mean) * (y - mean);
+		double measured = std::log2(0.05 / std::sqrt(squares / static_cast<double>(out.size())));
+		EXPECT_NEAR(measured, decimator.GetBitsGained(), 0.05) << Decimator<float>::KindName(kind);
+	}
+}
@@ -0,0 +1,128 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/dsp/design.h>
+#include <cee/dsp/filter.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+using namespace cee::dsp;
+
+static double Gain(const BiquadCoefficients &c, double sampleRate, double frequency) {
+	std::complex<double> z1 = std::polar(1.0, -2.0 * M_PI * frequency / sampleRate);
+	std::complex<double> z2 = z1 * z1;
+	std::complex<double> num = static_cast<double>(c.b0) + static_cast<double>(c.b1) * z1 + static_cast<double>(c.b2) * z2;
+	std::complex<double> den = 1.0 + static_cast<double>(c.a1) * z1 + static_cast<double>(c.a2) * z2;
+	return std::abs(num / den);
+}
+
+static std::vector<float> Noise(std::size_t count) {
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> dist(-1.f, 1.f);
+	std::vector<float> v(count);
+	for (float &x : v)
+		x = dist(rng);
+	return v;
+}
+
+// Straightforward cascade, one section after the other
+template<std::size_t N>
+static std::vector<float> ReferenceCascade(const std::array<BiquadCoefficients, N> &sections,
+		std::vector<float> x) {
+	for (const BiquadCoefficients &c : sections) {
+		double s1 = 0.0, s2 = 0.0;
+		for (float &v : x) {
+			double y = c.b0 * v + s1;
+			s1 = c.b1 * v - c.a1 * y + s2;
+			s2 = c.b2 * v - c.a2 * y;
+			v = static_cast<float>(y);
+		}
+	}
+	return x;
+}
+
+TEST(FilterDesign, constexprCoefficients) {
+	constexpr auto lowPass = ButterworthLowPass<4>(250.0, 40.0);
+	constexpr auto notch = Notch(250.0, 50.0);
+	static_assert(lowPass.size() == 2);
+	static_assert(notch.b0 > 0.9f && notch.b0 < 1.f);
+
+	for (const BiquadCoefficients &c : lowPass)
+		EXPECT_NEAR(Gain(c, 250.0, 0.0), 1.0, 1e-5);
+	EXPECT_NEAR(Gain(lowPass[0], 250.0, 40.0) * Gain(lowPass[1], 250.0, 40.0), M_SQRT1_2, 1e-3);
+	EXPECT_LT(Gain(notch, 250.0, 50.0), 1e-3);
+	EXPECT_NEAR(Gain(notch, 250.0, 10.0), 1.0, 1e-2);
+	EXPECT_NEAR(Gain(HighPass(250.0, 0.5), 250.0, 0.0), 0.0, 1e-6);
+
+	// Cutoffs beyond Nyquist pass the signal through
+	constexpr auto identity = Notch(100.0, 60.0);
+	static_assert(identity.b0 == 1.f && identity.a1 == 0.f);
+}
+
+template<std::size_t N>
+static void CheckCascade() {
+	std::array<BiquadCoefficients, N> sections;
+	for (std::size_t i = 0; i < N; ++i)
+		sections[i] = i % 2 ? LowPass(250.0, 20.0 + 10.0 * i) : Notch(250.0, 50.0 + i);
+	BiquadCascade<N> cascade(sections);
+
+	std::vector<float> x = Noise(1000);
+	std::vector<float> expected = ReferenceCascade(sections, x);
+	// Odd block sizes to cover state carried across blocks
+	std::span<float> rest(x);
+	while (!rest.empty()) {
+		std::size_t n = std::min<std::size_t>(rest.size(), 13);
+		cascade.Process(rest.first(n));
+		rest = rest.subspan(n);
+	}
+	for (std::size_t i = BiquadCascade<N>::LATENCY; i < x.size(); ++i)
+		ASSERT_NEAR(x[i], expected[i - BiquadCascade<N>::LATENCY], 1e-4) << N << " sections, sample " << i;
+}
+
+TEST(BiquadCascade, matchesReference) {
+	CheckCascade<1>();
+	CheckCascade<3>();
+	CheckCascade<4>();
+	CheckCascade<6>();
+}
+
+TEST(Fir, matchesConvolution) {
+	constexpr auto taps = FirLowPass<31>(250.0, 20.0);
+	Fir<31> fir(taps);
+	std::vector<float> x = Noise(500);
+	std::vector<float> expected(x.size());
+	for (std::size_t n = 0; n < x.size(); ++n) {
+		double acc = 0.0;
+		for (std::size_t k = 0; k < taps.size() && k <= n; ++k)
+			acc += taps[k] * x[n - k];
+		expected[n] = static_cast<float>(acc);
+	}
+	std::span<float> rest(x);
+	for (std::size_t n = 1; !rest.empty(); n = n % 70 + 7) {
+		n = std::min(n, rest.size());
+		fir.Process(rest.first(n));
+		rest = rest.subspan(n);
+	}
+	for (std::size_t i = 0; i < x.size(); ++i)
+		ASSERT_NEAR(x[i], expected[i], 1e-5) << "sample " << i;
+}
@@ -0,0 +1,165 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/dsp/decimate.h>
+#include <cee/dsp/design.h>
+#include <cee/dsp/filter.h>
+#include <cee/dsp/fixed.h>
+#include <cee/dsp/pipeline.h>
+#include <cee/dsp/stages.h>
+#include <cee/dsp/statistics.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace cee::dsp;
+
+static constexpr double RATE = 250.0;
+
+// ECG-like test signal in [0, 1): baseline wander, mains and a pulse train
+static std::vector<double> Signal(std::size_t count) {
+	std::mt19937 rng(42);
+	std::normal_distribution<double> noise(0.0, 0.01);
+	std::vector<double> v(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		double t = static_cast<double>(i) / RATE;
+		double phase = std::fmod(t, 0.8);
+		v[i] = 0.5 + 0.1 * std::sin(2.0 * M_PI * 0.3 * t) + 0.05 * std::sin(2.0 * M_PI * 50.0 * t)
+			+ (phase < 0.04 ? 0.3 * std::sin(M_PI * phase / 0.04) : 0.0) + noise(rng);
+	}
+	return v;
+}
+
+template<typename T, typename F>
+static std::vector<double> Filter(F &filter, const std::vector<double> &input) {
+	std::vector<T> block(input.size());
+	for (std::size_t i = 0; i < input.size(); ++i)
+		block[i] = SampleTraits<T>::FromFloat(input[i]);
+	filter.Process(std::span<T>(block));
+	std::vector<double> out(input.size());
+	for (std::size_t i = 0; i < input.size(); ++i)
+		out[i] = SampleTraits<T>::ToDouble(block[i]);
+	return out;
+}
+
+// Cascade in double precision, one section after the other
+template<std::size_t N>
+static std::vector<double> ReferenceCascade(const std::array<BiquadCoefficients, N> &sections,
+		std::vector<double> x) {
+	for (const BiquadCoefficients &c : sections) {
+		double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+		for (double &v : x) {
+			double y = c.b0 * v + c.b1 * x1 + c.b2 * x2 - c.a1 * y1 - c.a2 * y2;
+			x2 = x1;
+			x1 = v;
+			y2 = y1;
+			y1 = y;
+			v = y;
+		}
+	}
+	return x;
+}
+
+static double MaxError(const std::vector<double> &a, const std::vector<double> &b) {
+	double error = 0.0;
+	for (std::size_t i = 0; i < a.size(); ++i)
+		error = std::max(error, std::fabs(a[i] - b[i]));
+	return error;
+}
+
+TEST(Fixed, conversions) {
+	static_assert(Q15::FromFloat(0.5).raw == 16384);
+	static_assert(Q15::FromFloat(1.0).raw == 32767);
+	static_assert(Q15::FromFloat(-2.0).raw == -32768);
+	static_assert(Q31::FromFloat(-0.25).raw == -(1 << 29));
+	static_assert((Q15::FromFloat(0.5) * Q15::FromFloat(0.5)).raw == 8192);
+	static_assert((Q15::FromFloat(0.75) + Q15::FromFloat(0.75)).raw == 32767);
+	static_assert(Q15::FromFloat(-0.5) < Q15::FromFloat(0.25));
+	EXPECT_FLOAT_EQ(Q15::FromRaw(-16384).ToFloat(), -0.5f);
+}
+
+TEST(Fixed, biquadCascade) {
+	constexpr auto design = Cascade(
+			ButterworthHighPass<2>(RATE, 0.5),
+			std::array{ Notch(RATE, 50.0) },
+			ButterworthLowPass<4>(RATE, 40.0));
+	std::vector<double> input = Signal(5000);
+
+	std::vector<double> expected = ReferenceCascade(design, input);
+
+	BiquadCascade<4, Q15> q15(design);
+	EXPECT_LT(MaxError(Filter<Q15>(q15, input), expected), 1e-3);
+
+	BiquadCascade<4, Q31> q31(design);
+	EXPECT_LT(MaxError(Filter<Q31>(q31, input), expected), 1e-6);
+}
+
+TEST(Fixed, fir) {
+	constexpr auto taps = FirLowPass<31>(RATE, 20.0);
+	std::vector<double> input = Signal(2000);
+
+	Fir<31> reference(taps);
+	std::vector<double> expected = Filter<float>(reference, input);
+
+	Fir<31, Q15> q15(taps);
+	EXPECT_LT(MaxError(Filter<Q15>(q15, input), expected), 5e-4);
+
+	// Split across blocks
+	Fir<31, Q31> q31(taps);
+	std::vector<double> first(input.begin(), input.begin() + 777);
+	std::vector<double> second(input.begin() + 777, input.end());
+	std::vector<double> out = Filter<Q31>(q31, first);
+	std::vector<double> rest = Filter<Q31>(q31, second);
+	out.insert(out.end(), rest.begin(), rest.end());
+	EXPECT_LT(MaxError(out, expected), 1e-6);
+}
+
+TEST(Fixed, scaleAndDecimate) {
+	// ADC codes as raw Q15 brought to full scale and re-centred
+	Pipeline<Q15, Scale<Q15>, AverageDecimator<Q15>> p(Scale<Q15>(32768.0 / 255.0, -0.5),
+			AverageDecimator<Q15>(2));
+	std::vector<Q15> block = { Q15::FromRaw(0), Q15::FromRaw(0), Q15::FromRaw(255), Q15::FromRaw(255),
+		Q15::FromRaw(51), Q15::FromRaw(153) };
+	ASSERT_EQ(p.Process(block), 3u);
+	EXPECT_NEAR(block[0].ToDouble(), -0.5, 1e-4);
+	EXPECT_NEAR(block[1].ToDouble(), 0.5, 1e-4);
+	EXPECT_NEAR(block[2].ToDouble(), 0.4 - 0.5, 1e-4);
+
+	Scale<Q31> small(1.0 / 1000.0);
+	std::vector<Q31> x = { Q31::FromFloat(0.5) };
+	small.Process(x);
+	EXPECT_NEAR(x[0].ToDouble(), 0.0005, 1e-9);
+}
+
+TEST(Fixed, statistics) {
+	std::vector<double> input = Signal(3000);
+	RollingStatistics<Q15, 1024> fixed(1000);
+	RollingStatistics<double, 1024> reference(1000);
+	for (double x : input) {
+		Q15 q = Q15::FromFloat(x);
+		fixed.Push(q);
+		reference.Push(q.ToDouble());
+	}
+	EXPECT_DOUBLE_EQ(fixed.GetMin().ToDouble(), reference.GetMin());
+	EXPECT_DOUBLE_EQ(fixed.GetMax().ToDouble(), reference.GetMax());
+	EXPECT_NEAR(fixed.GetMean(), reference.GetMean(), 1e-12);
+	EXPECT_NEAR(fixed.GetStdDev(), reference.GetStdDev(), 1e-9);
+}
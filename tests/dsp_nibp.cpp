@@ -0,0 +1,115 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/dsp/nibp.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+using namespace cee::dsp;
+
+static constexpr float RATE = 250.f;
+
+struct Measurement {
+	std::vector<float> pressure;
+	std::vector<float> oscillation;
+};
+
+/*
+ * Inflation to peak mmHg, then a linear deflation at 3 mmHg/s. The
+ * oscillation envelope is a Gaussian in cuff pressure around map, with
+ * widths chosen so it falls to the systolic and diastolic ratios at sys
+ * and dia.
+ */
+static Measurement Cuff(float sys, float dia, float map, float peak = 180.f, float bpm = 75.f) {
+	std::mt19937 rng(7);
+	std::normal_distribution<float> noise(0.f, 0.02f);
+	const float upper = (sys - map) / std::sqrt(-std::log(NibpEngine::SYSTOLIC_RATIO));
+	const float lower = (map - dia) / std::sqrt(-std::log(NibpEngine::DIASTOLIC_RATIO));
+
+	Measurement m;
+	const float inflate = 5.f;
+	const float deflate = (peak - 20.f) / 3.f;
+	const std::size_t count = static_cast<std::size_t>((1.f + inflate + deflate + 2.f) * RATE);
+	for (std::size_t i = 0; i < count; ++i) {
+		float t = static_cast<float>(i) / RATE;
+		float cuff;
+		if (t < 1.f) {
+			cuff = 0.f;
+		} else if (t < 1.f + inflate) {
+			cuff = peak * (t - 1.f) / inflate;
+		} else {
+			cuff = std::max(peak - 3.f * (t - 1.f - inflate), 0.f);
+		}
+		float width = cuff > map ? upper : lower;
+		float d = (cuff - map) / width;
+		float envelope = 2.f * std::exp(-d * d);
+		float phase = std::fmod(t * bpm / 60.f, 1.f);
+		float pulse = phase < 0.4f ? std::sin(std::numbers::pi_v<float> * phase / 0.4f) : 0.f;
+		float osc = envelope * pulse + noise(rng);
+		m.pressure.push_back(cuff + osc);
+		m.oscillation.push_back(osc);
+	}
+	return m;
+}
+
+static void Feed(NibpEngine &engine, const Measurement &m) {
+	std::span<const float> pressure(m.pressure);
+	std::span<const float> oscillation(m.oscillation);
+	while (!pressure.empty()) {
+		std::size_t n = std::min<std::size_t>(pressure.size(), 8);
+		engine.Process(pressure.first(n), oscillation.first(n));
+		pressure = pressure.subspan(n);
+		oscillation = oscillation.subspan(n);
+	}
+}
+
+TEST(NibpEngine, measures) {
+	NibpEngine engine(RATE, 1.f, 0.1f);
+	Feed(engine, Cuff(120.f, 80.f, 93.f));
+	ASSERT_EQ(engine.GetMeasurementCount(), 1u);
+	const NibpResult &result = engine.GetResult();
+	ASSERT_TRUE(result.IsValid()) << static_cast<int>(result.status);
+	EXPECT_NEAR(result.systolic, 120.f, 3.f);
+	EXPECT_NEAR(result.diastolic, 80.f, 3.f);
+	EXPECT_NEAR(result.mean, 93.f, 3.f);
+	EXPECT_GT(result.pulseCount, 30u);
+	EXPECT_EQ(engine.GetState(), NibpEngine::State::IDLE);
+}
+
+TEST(NibpEngine, hypertensive) {
+	NibpEngine engine(RATE, 1.f, 0.1f);
+	Feed(engine, Cuff(170.f, 105.f, 127.f, 220.f, 95.f));
+	const NibpResult &result = engine.GetResult();
+	ASSERT_TRUE(result.IsValid()) << static_cast<int>(result.status);
+	EXPECT_NEAR(result.systolic, 170.f, 3.f);
+	EXPECT_NEAR(result.diastolic, 105.f, 3.f);
+	EXPECT_NEAR(result.mean, 127.f, 3.f);
+}
+
+TEST(NibpEngine, underInflated) {
+	NibpEngine engine(RATE, 1.f, 0.1f);
+	// Deflation starts below systolic
+	Feed(engine, Cuff(150.f, 80.f, 100.f, 120.f));
+	ASSERT_EQ(engine.GetMeasurementCount(), 1u);
+	EXPECT_EQ(engine.GetResult().status, NibpResult::Status::NO_SYSTOLIC);
+}
@@ -0,0 +1,78 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/dsp/decimate.h>
+#include <cee/dsp/pipeline.h>
+#include <cee/dsp/stages.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+using namespace cee::dsp;
+
+TEST(Pipeline, scale) {
+	Pipeline<float, Scale<float>> p(Scale<float>(2.f, 1.f));
+	std::array<float, 4> block = { 0.f, 1.f, 2.f, 3.f };
+	ASSERT_EQ(p.Process(block), 4u);
+	EXPECT_EQ(block, (std::array<float, 4>{ 1.f, 3.f, 5.f, 7.f }));
+}
+
+TEST(Pipeline, decimateAcrossBlocks) {
+	Pipeline<float, AverageDecimator<float>> p(AverageDecimator<float>(3));
+	std::vector<float> out;
+	for (int b = 0; b < 4; ++b) {
+		std::array<float, 4> block;
+		for (int i = 0; i < 4; ++i)
+			block[i] = static_cast<float>(b * 4 + i);
+		std::size_t n = p.Process(block);
+		out.insert(out.end(), block.begin(), block.begin() + n);
+	}
+	// Averages of 0..2, 3..5, ... 12..14
+	EXPECT_EQ(out, (std::vector<float>{ 1.f, 4.f, 7.f, 10.f, 13.f }));
+
+	p.Reset();
+	std::array<float, 2> block = { 5.f, 5.f };
+	EXPECT_EQ(p.Process(block), 0u);
+}
+
+TEST(Pipeline, stagesRunInOrder) {
+	std::vector<float> seen;
+	auto tap = [&seen](std::span<const float> block) {
+		seen.insert(seen.end(), block.begin(), block.end());
+	};
+	Pipeline<float, AverageDecimator<float>, Tap<float, decltype(tap)>, Scale<float>> p(
+			AverageDecimator<float>(2), Tap<float, decltype(tap)>(tap), Scale<float>(10.f));
+
+	std::array<float, 4> block = { 1.f, 3.f, 5.f, 7.f };
+	ASSERT_EQ(p.Process(block), 2u);
+	EXPECT_EQ(seen, (std::vector<float>{ 2.f, 6.f }));
+	EXPECT_EQ(block[0], 20.f);
+	EXPECT_EQ(block[1], 60.f);
+
+	// Stages after one returning nothing don't run
+	std::array<float, 1> single = { 1.f };
+	EXPECT_EQ(p.Process(single), 0u);
+	EXPECT_EQ(seen.size(), 2u);
+
+	p.Get<Scale<float>>().Set(1.f, 0.f);
+	single[0] = 3.f;
+	ASSERT_EQ(p.Process(single), 1u);
+	EXPECT_EQ(single[0], 2.f);
+}
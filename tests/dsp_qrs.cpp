@@ -0,0 +1,91 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/dsp/qrs.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+using namespace cee::dsp;
+
+static constexpr float RATE = 250.f;
+
+// P-QRS-T complexes at the given heart rate, with baseline wander and noise
+static std::vector<float> Ecg(float bpm, float seconds, unsigned seed = 1) {
+	std::mt19937 rng(seed);
+	std::normal_distribution<float> noise(0.f, 0.01f);
+	std::vector<float> x(static_cast<std::size_t>(seconds * RATE));
+	for (std::size_t i = 0; i < x.size(); ++i) {
+		float t = static_cast<float>(i) / RATE;
+		float phase = std::fmod(t * bpm / 60.f, 1.f);
+		float p = std::numbers::pi_v<float> * phase;
+		float v = 125.f * std::pow(std::sin(p), 50.f) +
+			25.f * std::pow(std::sin(p - 1.f), 50.f) +
+			15.f * std::pow(std::sin(p + 1.f), 50.f) -
+			40.f * std::pow(std::sin(p - 0.2f), 50.f) -
+			15.f * std::pow(std::sin(p + 0.4f), 50.f);
+		x[i] = 0.3f * v / 125.f + 0.05f * std::sin(2.f * std::numbers::pi_v<float> * 0.3f * t) + noise(rng);
+	}
+	return x;
+}
+
+static void Feed(QrsDetector &detector, std::vector<float> x) {
+	std::span<float> rest(x);
+	for (std::size_t n = 3; !rest.empty(); n = n % 40 + 5) {
+		n = std::min(n, rest.size());
+		detector.Process(rest.first(n));
+		rest = rest.subspan(n);
+	}
+}
+
+TEST(QrsDetector, heartRate) {
+	for (float bpm : { 45.f, 72.f, 120.f, 180.f }) {
+		QrsDetector detector(RATE);
+		Feed(detector, Ecg(bpm, 30.f));
+		// Beats in the learning period are not counted
+		float expected = (30.f - 2.f) * bpm / 60.f;
+		EXPECT_NEAR(static_cast<float>(detector.GetBeatCount()), expected, 1.5f) << bpm << " bpm";
+		EXPECT_NEAR(detector.GetHeartRate(), bpm, 1.f) << bpm << " bpm";
+		// A single interval is only good to a sample or two
+		EXPECT_NEAR(detector.GetBeatRate(), bpm, 0.05f * bpm) << bpm << " bpm";
+	}
+}
+
+TEST(QrsDetector, followsRateChange) {
+	QrsDetector detector(RATE);
+	Feed(detector, Ecg(60.f, 20.f));
+	EXPECT_NEAR(detector.GetHeartRate(), 60.f, 1.f);
+	Feed(detector, Ecg(100.f, 20.f, 2));
+	EXPECT_NEAR(detector.GetHeartRate(), 100.f, 1.f);
+}
+
+TEST(QrsDetector, asystole) {
+	QrsDetector detector(RATE);
+	Feed(detector, Ecg(80.f, 10.f));
+	EXPECT_GT(detector.GetHeartRate(), 0.f);
+	uint64_t beats = detector.GetBeatCount();
+
+	std::vector<float> flat(static_cast<std::size_t>(6.f * RATE), 0.f);
+	Feed(detector, flat);
+	EXPECT_EQ(detector.GetHeartRate(), 0.f);
+	EXPECT_EQ(detector.GetBeatCount(), beats);
+}
@@ -0,0 +1,76 @@
+/*
+ * ceeDSP
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/dsp/statistics.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace cee::dsp;
+
+TEST(RollingStatistics, matchesScan) {
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> dist(-100.f, 100.f);
+	std::vector<float> x(5000);
+	for (std::size_t i = 0; i < x.size(); ++i)
+		// Offset and drifting, where naive sums of squares lose precision
+		x[i] = 1000.f + 0.05f * static_cast<float>(i) + dist(rng);
+
+	for (std::size_t window : { 1u, 7u, 256u, 1000u }) {
+		RollingStatistics<float, 1024> stats(window);
+		for (std::size_t i = 0; i < x.size(); ++i) {
+			stats.Push(x[i]);
+			std::size_t first = i + 1 > window ? i + 1 - window : 0;
+			auto begin = x.begin() + first;
+			auto end = x.begin() + i + 1;
+			ASSERT_EQ(stats.GetCount(), static_cast<std::size_t>(end - begin));
+			ASSERT_EQ(stats.GetMin(), *std::min_element(begin, end)) << window << " " << i;
+			ASSERT_EQ(stats.GetMax(), *std::max_element(begin, end)) << window << " " << i;
+			if (i % 97 != 0)
+				continue;
+			double n = static_cast<double>(end - begin);
+			double mean = std::accumulate(begin, end, 0.0) / n;
+			double variance = 0.0;
+			for (auto it = begin; it != end; ++it)
+				variance += (*it - mean) * (*it - mean);
+			variance /= n;
+			ASSERT_NEAR(stats.GetMean(), mean, 1e-6 * std::abs(mean));
+			ASSERT_NEAR(stats.GetVariance(), variance, 1e-6 * variance + 1e-9);
+		}
+	}
+}
+
+TEST(RollingStatistics, fullCapacityWindow) {
+	RollingStatistics<int, 8> stats;
+	EXPECT_EQ(stats.GetWindow(), 8u);
+	// Strictly decreasing fills the whole min deque
+	for (int i = 20; i > 0; --i)
+		stats.Push(i);
+	EXPECT_EQ(stats.GetMin(), 1);
+	EXPECT_EQ(stats.GetMax(), 8);
+	EXPECT_DOUBLE_EQ(stats.GetMean(), 4.5);
+	EXPECT_DOUBLE_EQ(stats.GetVariance(), 5.25);
+
+	stats.SetWindow(100);
+	EXPECT_EQ(stats.GetWindow(), 8u);
+	EXPECT_EQ(stats.GetCount(), 0u);
+}
@@ -0,0 +1,71 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/acquisition.h>
+
+#include <cee/core/except.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace cee;
+using cee::platform::I2CContextType;
+using cee::platform::I2CController;
+using cee::platform::PCF8591;
+
+namespace {
+	class ThrowingProcessor : public SampleProcessor {
+	public:
+		void Process(std::span<const Sample> samples) override {
+			m_Blocks.fetch_add(1, std::memory_order_relaxed);
+			throw core::InternalError("processor failed");
+		}
+
+		void OnReadError(uint64_t timestamp) override {
+			m_ReadErrors.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		std::atomic<int> m_Blocks = 0;
+		std::atomic<int> m_ReadErrors = 0;
+	};
+}
+
+TEST(Acquisition, processorErrorsAreNotReadErrors)
+{
+	auto ctrl = I2CController::Create("ch0=dc::0:128", I2CContextType::PLATFORM_I2C_CONTEXT_MOCK, nullptr);
+	Acquisition acquisition(std::make_unique<PCF8591>(ctrl, 0x48), 250.f, Acquisition::Pacing::UNTHROTTLED);
+	ThrowingProcessor processor;
+	acquisition.AddProcessor(&processor);
+
+	acquisition.Start();
+	Sample sample;
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (processor.m_Blocks.load() < 4 && std::chrono::steady_clock::now() < deadline) {
+		while (acquisition.GetQueue().TryDequeue(sample)) {}
+		std::this_thread::yield();
+	}
+	EXPECT_TRUE(acquisition.IsRunning());
+	acquisition.Stop();
+
+	EXPECT_GE(processor.m_Blocks.load(), 4);
+	EXPECT_EQ(acquisition.GetErrorCount(), 0u);
+	EXPECT_EQ(processor.m_ReadErrors.load(), 0);
+}
@@ -0,0 +1,172 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/alarms.h>
+
+#include <cee/core/except.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace cee;
+
+static constexpr uint64_t MS = 1000000;
+
+static AlarmConfig Limit(float low, float high, float hysteresis = 0.f, float onsetDelay = 0.f) {
+	return { .name = "limit", .kind = AlarmConfig::Kind::LIMIT, .priority = AlarmPriority::MEDIUM,
+		.low = low, .high = high, .hysteresis = hysteresis, .onsetDelay = onsetDelay };
+}
+
+TEST(AlarmEngine, limitHysteresis)
+{
+	AlarmEngine engine;
+	AlarmEngine::Id id = engine.Add(Limit(50.f, 120.f, 5.f));
+
+	engine.Update(id, 100.f, 0);
+	engine.Publish();
+	EXPECT_EQ(engine.GetVersion(), 0u);
+
+	engine.Update(id, 121.f, 4 * MS);
+	engine.Publish();
+	AlarmEngine::Snapshot snapshot = engine.GetSnapshot();
+	EXPECT_EQ(snapshot.alarms[id].state, AlarmState::ACTIVE);
+	EXPECT_EQ(snapshot.alarms[id].direction, 1);
+	EXPECT_EQ(snapshot.alarms[id].onset, 4 * MS);
+	EXPECT_EQ(snapshot.highest, AlarmPriority::MEDIUM);
+	EXPECT_EQ(snapshot.highestAlarm, 0);
+
+	// Inside the limit but not by the hysteresis
+	engine.Update(id, 117.f, 8 * MS);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().alarms[id].state, AlarmState::ACTIVE);
+
+	engine.Update(id, 114.f, 12 * MS);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().alarms[id].state, AlarmState::INACTIVE);
+	EXPECT_EQ(engine.GetSnapshot().highest, AlarmPriority::NONE);
+
+	engine.Update(id, 40.f, 16 * MS);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().alarms[id].direction, -1);
+
+	// Unavailable values clear the condition
+	engine.Update(id, std::nanf(""), 20 * MS);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().alarms[id].state, AlarmState::INACTIVE);
+}
+
+TEST(AlarmEngine, onsetDelay)
+{
+	AlarmEngine engine;
+	AlarmEngine::Id id = engine.Add(Limit(0.f, 1.f, 0.f, 0.5f));
+
+	// A short excursion never raises the alarm
+	engine.Update(id, 2.f, 0);
+	engine.Update(id, 2.f, 400 * MS);
+	engine.Update(id, 0.5f, 450 * MS);
+	engine.Update(id, 2.f, 500 * MS);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().alarms[id].state, AlarmState::INACTIVE);
+
+	engine.Update(id, 2.f, 999 * MS);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().alarms[id].state, AlarmState::INACTIVE);
+	engine.Update(id, 2.f, 1000 * MS);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().alarms[id].state, AlarmState::ACTIVE);
+}
+
+TEST(AlarmEngine, latchingAcknowledge)
+{
+	AlarmEngine engine;
+	AlarmConfig config{ .name = "technical", .priority = AlarmPriority::HIGH, .latching = true };
+	AlarmEngine::Id id = engine.Add(config);
+
+	engine.SetCondition(id, true, 0);
+	engine.SetCondition(id, false, 4 * MS);
+	engine.Publish();
+	AlarmEngine::Snapshot snapshot = engine.GetSnapshot();
+	EXPECT_EQ(snapshot.alarms[id].state, AlarmState::LATCHED);
+	EXPECT_EQ(snapshot.highest, AlarmPriority::HIGH);
+
+	engine.Acknowledge(id);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().alarms[id].state, AlarmState::INACTIVE);
+
+	// Acknowledged while active, it does not latch once it clears
+	engine.SetCondition(id, true, 8 * MS);
+	engine.Publish();
+	engine.AcknowledgeAll();
+	engine.Publish();
+	snapshot = engine.GetSnapshot();
+	EXPECT_TRUE(snapshot.alarms[id].acknowledged);
+	EXPECT_EQ(snapshot.highest, AlarmPriority::NONE);
+	engine.SetCondition(id, false, 12 * MS);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().alarms[id].state, AlarmState::INACTIVE);
+}
+
+TEST(AlarmEngine, rate)
+{
+	AlarmEngine engine;
+	AlarmEngine::Id id = engine.Add({ .name = "rate", .kind = AlarmConfig::Kind::RATE,
+			.priority = AlarmPriority::LOW, .maxRate = 3.f, .rateWindow = 10.f });
+
+	const uint64_t second = 1000 * MS;
+	engine.Update(id, 70.f, 0);
+	engine.Update(id, 90.f, 10 * second);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().alarms[id].state, AlarmState::INACTIVE);
+
+	engine.Update(id, 140.f, 20 * second);
+	engine.Publish();
+	AlarmEngine::Snapshot snapshot = engine.GetSnapshot();
+	EXPECT_EQ(snapshot.alarms[id].state, AlarmState::ACTIVE);
+	EXPECT_FLOAT_EQ(snapshot.alarms[id].value, 5.f);
+	EXPECT_EQ(snapshot.alarms[id].direction, 1);
+
+	// Held between measurements
+	engine.Update(id, 140.f, 25 * second);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().alarms[id].state, AlarmState::ACTIVE);
+	engine.Update(id, 140.f, 30 * second);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().alarms[id].state, AlarmState::INACTIVE);
+}
+
+TEST(AlarmEngine, priorities)
+{
+	AlarmEngine engine;
+	AlarmEngine::Id low = engine.Add({ .name = "low", .priority = AlarmPriority::LOW });
+	AlarmEngine::Id high = engine.Add({ .name = "high", .priority = AlarmPriority::HIGH });
+
+	engine.SetCondition(high, true, 0);
+	engine.SetCondition(low, true, 4 * MS);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().highestAlarm, static_cast<int8_t>(high));
+
+	engine.Acknowledge(high);
+	engine.Publish();
+	EXPECT_EQ(engine.GetSnapshot().highest, AlarmPriority::LOW);
+	EXPECT_EQ(engine.GetSnapshot().highestAlarm, static_cast<int8_t>(low));
+
+	for (std::size_t i = engine.GetCount(); i < AlarmEngine::MAX_ALARMS; ++i)
+		engine.Add({});
+	EXPECT_THROW(engine.Add({}), core::InvalidParameter);
+}
@@ -0,0 +1,176 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/analysis.h>
+#include <cee/mppm/recording.h>
+
+#include <gtest/gtest.h>
+
+#include "test_recording.h"
+
+#include <cmath>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+using namespace cee;
+using cee::test::TempPath;
+
+static constexpr float RATE = 250.f;
+static constexpr std::size_t CHUNK_SAMPLES = 1024;
+
+// ECG at bpm with a little baseline wander on Lead II, a steady cuff
+// pressure and a flat oscillation channel
+static uint8_t EcgCode(uint64_t sample, int channel, double bpm) {
+	switch (channel) {
+	case 0: {
+		double t = static_cast<double>(sample) / RATE;
+		double phase = std::fmod(t, 60.0 / bpm);
+		double ecg = 0.5 + 0.1 * std::sin(2.0 * M_PI * 0.2 * t)
+			+ (phase < 0.04 ? 0.35 * std::sin(M_PI * phase / 0.04) : 0.0)
+			+ (phase > 0.25 && phase < 0.45 ? 0.08 * std::sin(M_PI * (phase - 0.25) / 0.2) : 0.0);
+		return static_cast<uint8_t>(std::lround(ecg * 255.0));
+	}
+	case 1:
+		return 20;
+	case 2:
+		return 128;
+	default:
+		return 0;
+	}
+}
+
+static void WriteEcg(const std::string &path, double seconds, double bpm) {
+	test::WriteRecording(path, static_cast<uint64_t>(seconds * RATE),
+			{ .sampleRate = RATE, .chunkSamples = CHUNK_SAMPLES },
+			[bpm](uint64_t i, int c) { return EcgCode(i, c, bpm); });
+}
+
+TEST(Analysis, segmentsMatchWholeFile)
+{
+	std::vector<std::string> paths = { TempPath("cee_analysis_72.rec"), TempPath("cee_analysis_90.rec") };
+	WriteEcg(paths[0], 300.0, 72.0);
+	WriteEcg(paths[1], 200.0, 90.0);
+
+	ThreadPool pool(4);
+	AnalysisOptions whole;
+	whole.segmentDuration = 1e9;
+	std::vector<AnalysisResult> reference = AnalyseRecordings(pool, paths, whole);
+
+	AnalysisOptions split;
+	split.segmentDuration = 30.0;
+	split.warmup = 10.0;
+	std::vector<AnalysisResult> results = AnalyseRecordings(pool, paths, split);
+
+	ASSERT_EQ(results.size(), 2u);
+	for (std::size_t i = 0; i < results.size(); ++i) {
+		const AnalysisResult &r = results[i];
+		const AnalysisResult &ref = reference[i];
+		ASSERT_TRUE(r.IsValid()) << r.error;
+		EXPECT_EQ(r.path, paths[i]);
+		EXPECT_EQ(ref.segmentCount, 1u);
+		EXPECT_GT(r.segmentCount, 5u);
+		EXPECT_EQ(r.sampleCount, ref.sampleCount);
+		EXPECT_NEAR(r.duration, i == 0 ? 300.0 : 200.0, 0.01);
+		// Beats are only lost or doubled at segment edges
+		EXPECT_NEAR(static_cast<double>(r.beatCount), static_cast<double>(ref.beatCount),
+				static_cast<double>(r.segmentCount));
+		EXPECT_NEAR(r.meanHeartRate, i == 0 ? 72.f : 90.f, 1.f);
+		EXPECT_NEAR(r.meanHeartRate, ref.meanHeartRate, 0.5f);
+		for (int channel = 0; channel < SignalChain::CHANNEL_COUNT; ++channel) {
+			EXPECT_EQ(r.channels[channel].count, ref.channels[channel].count);
+			EXPECT_NEAR(r.channels[channel].mean, ref.channels[channel].mean, 1e-3f);
+		}
+	}
+	EXPECT_NEAR(static_cast<double>(results[0].beatCount), 300.0 * 72.0 / 60.0, 5.0);
+	EXPECT_NEAR(results[1].channels[SignalChain::PRESSURE].mean, 20.f / 255.f, 1e-3f);
+}
+
+TEST(Analysis, asystoleCountsAsZeroRate)
+{
+	// A minute at 72 bpm either side of 20 s with no beats but the leads on
+	const uint64_t beating = static_cast<uint64_t>(60.0 * RATE);
+	const uint64_t stopped = static_cast<uint64_t>(20.0 * RATE);
+	std::vector<std::string> paths = { TempPath("cee_analysis_asystole.rec") };
+	test::WriteRecording(paths[0], 2 * beating + stopped,
+			{ .sampleRate = RATE, .chunkSamples = CHUNK_SAMPLES },
+			[&](uint64_t i, int c) -> uint8_t {
+				if (c == 0 && i >= beating && i < beating + stopped)
+					return 128;
+				return EcgCode(i, c, 72.0);
+			});
+
+	ThreadPool pool(2);
+	AnalysisOptions options;
+	options.segmentDuration = 1e9;
+	std::vector<AnalysisResult> results = AnalyseRecordings(pool, paths, options);
+	ASSERT_EQ(results.size(), 1u);
+	const AnalysisResult &r = results[0];
+	ASSERT_TRUE(r.IsValid()) << r.error;
+	EXPECT_EQ(r.minHeartRate, 0.f);
+	EXPECT_NEAR(r.maxHeartRate, 72.f, 2.f);
+	// About 15 s of the 140 s are a known 0 once the detector times out
+	EXPECT_LT(r.meanHeartRate, 72.f * 0.95f);
+	EXPECT_GT(r.meanHeartRate, 72.f * 0.75f);
+}
+
+TEST(Analysis, oversamplingFromHeader)
+{
+	// The ADC at four times the output rate, each code held for four samples
+	const std::size_t factor = 4;
+	std::vector<std::string> paths = { TempPath("cee_analysis_oversampled.rec") };
+	test::WriteRecording(paths[0], static_cast<uint64_t>(60.0 * RATE) * factor,
+			{ .sampleRate = RATE * factor, .chunkSamples = CHUNK_SAMPLES, .oversampling = factor,
+				.decimator = dsp::DecimatorKind::FIR },
+			[](uint64_t i, int c) { return EcgCode(i / factor, c, 72.0); });
+
+	ThreadPool pool(2);
+	std::vector<AnalysisResult> results = AnalyseRecordings(pool, paths);
+	ASSERT_EQ(results.size(), 1u);
+	ASSERT_TRUE(results[0].IsValid()) << results[0].error;
+	EXPECT_EQ(results[0].oversampling, factor);
+	EXPECT_EQ(results[0].decimator, dsp::DecimatorKind::FIR);
+	EXPECT_FLOAT_EQ(results[0].outputRate, RATE);
+	EXPECT_NEAR(results[0].meanHeartRate, 72.f, 1.f);
+
+	// Options still override the header
+	AnalysisOptions options;
+	options.oversampling = 2;
+	options.decimator = dsp::DecimatorKind::AVERAGE;
+	results = AnalyseRecordings(pool, paths, options);
+	ASSERT_TRUE(results[0].IsValid()) << results[0].error;
+	EXPECT_EQ(results[0].oversampling, 2u);
+	EXPECT_EQ(results[0].decimator, dsp::DecimatorKind::AVERAGE);
+	EXPECT_FLOAT_EQ(results[0].outputRate, 2.f * RATE);
+}
+
+TEST(Analysis, reportsErrors)
+{
+	ThreadPool pool(2);
+	std::string good = TempPath("cee_analysis_good.rec");
+	WriteEcg(good, 20.0, 60.0);
+	std::vector<std::string> paths = { TempPath("cee_analysis_missing.rec"), good };
+	std::filesystem::remove(paths[0]);
+
+	std::vector<AnalysisResult> results = AnalyseRecordings(pool, paths);
+	ASSERT_EQ(results.size(), 2u);
+	EXPECT_FALSE(results[0].IsValid());
+	EXPECT_EQ(results[0].sampleCount, 0u);
+	EXPECT_TRUE(results[1].IsValid());
+	EXPECT_EQ(results[1].sampleCount, 20u * 250u);
+}
@@ -0,0 +1,123 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/codec.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace cee;
+
+template<typename T>
+static std::vector<T> RoundTrip(const std::vector<T> &values, std::size_t *encodedSize = nullptr) {
+	std::vector<uint8_t> encoded;
+	EncodePlane(std::span<const T>(values), encoded);
+	// A second plane behind it must be left alone
+	encoded.push_back(0xAB);
+	if (encodedSize)
+		*encodedSize = encoded.size() - 1;
+
+	std::vector<T> decoded(values.size());
+	std::span<const uint8_t> in(encoded);
+	EXPECT_TRUE(DecodePlane(in, std::span<T>(decoded)));
+	EXPECT_EQ(in.size(), 1u);
+	return decoded;
+}
+
+TEST(Codec, waveforms)
+{
+	std::mt19937 rng(11);
+	std::normal_distribution<double> noise(0.0, 1.0);
+	std::uniform_int_distribution<int> code(0, 255);
+
+	// ECG-like codes with a little noise, sizes around block boundaries
+	for (std::size_t size : { 1u, 2u, 3u, 129u, 130u, 131u, 1024u, 1001u }) {
+		std::vector<uint8_t> ecg(size);
+		for (std::size_t i = 0; i < size; ++i) {
+			double t = static_cast<double>(i) / 250.0;
+			double phase = std::fmod(t, 0.8);
+			ecg[i] = static_cast<uint8_t>(std::clamp(128.0 + 20.0 * std::sin(2.0 * M_PI * t) +
+						(phase < 0.04 ? 90.0 * std::sin(M_PI * phase / 0.04) : 0.0) + noise(rng), 0.0, 255.0));
+		}
+		std::size_t encodedSize;
+		EXPECT_EQ(RoundTrip(ecg, &encodedSize), ecg) << size;
+		// Noise of an LSB or so costs about 4 bits a sample
+		if (size == 1024) {
+			EXPECT_LT(encodedSize, size * 6 / 10);
+		}
+	}
+
+	// Noise and rail to rail jumps need the full width and still round trip
+	std::vector<uint8_t> random(1000);
+	for (uint8_t &x : random)
+		x = static_cast<uint8_t>(code(rng));
+	random[500] = 0;
+	random[501] = 255;
+	random[502] = 0;
+	EXPECT_EQ(RoundTrip(random), random);
+
+	// Down to the header and a descriptor per block
+	std::vector<uint8_t> flat(1000, 77);
+	std::size_t encodedSize;
+	EXPECT_EQ(RoundTrip(flat, &encodedSize), flat);
+	EXPECT_EQ(encodedSize, 2 + (flat.size() - 2 + CODEC_BLOCK_SIZE - 1) / CODEC_BLOCK_SIZE);
+}
+
+TEST(Codec, timestamps)
+{
+	std::mt19937 rng(5);
+	std::normal_distribution<double> jitter(0.0, 20000.0);
+	std::vector<uint64_t> timestamps(1024);
+	uint64_t t = 123456789012345ull;
+	for (uint64_t &x : timestamps) {
+		x = t + static_cast<uint64_t>(static_cast<int64_t>(jitter(rng)));
+		t += 4000000;
+	}
+	std::size_t encodedSize;
+	EXPECT_EQ(RoundTrip(timestamps, &encodedSize), timestamps);
+	EXPECT_LT(encodedSize, timestamps.size() * sizeof(uint64_t) / 3);
+
+	// Simulated time packs down to the header and descriptors
+	std::vector<uint64_t> steady(1024);
+	for (std::size_t i = 0; i < steady.size(); ++i)
+		steady[i] = 1000 + i * 4000000;
+	EXPECT_EQ(RoundTrip(steady, &encodedSize), steady);
+	EXPECT_EQ(encodedSize, 16 + (steady.size() - 2 + CODEC_BLOCK_SIZE - 1) / CODEC_BLOCK_SIZE);
+
+	// Wrapping differences
+	std::vector<uint64_t> extremes = { 0, ~0ull, 0, 1ull << 63, 5, ~0ull - 3, 42 };
+	EXPECT_EQ(RoundTrip(extremes), extremes);
+}
+
+TEST(Codec, rejectsTruncated)
+{
+	std::vector<uint8_t> codes(300);
+	for (std::size_t i = 0; i < codes.size(); ++i)
+		codes[i] = static_cast<uint8_t>(i * 7);
+	std::vector<uint8_t> encoded;
+	EncodePlane(std::span<const uint8_t>(codes), encoded);
+
+	std::vector<uint8_t> decoded(codes.size());
+	for (std::size_t size : { std::size_t(0), std::size_t(1), encoded.size() / 2, encoded.size() - 1 }) {
+		std::span<const uint8_t> in(encoded.data(), size);
+		EXPECT_FALSE(DecodePlane(in, std::span<uint8_t>(decoded))) << size;
+	}
+}
@@ -0,0 +1,231 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/acquisition.h>
+#include <cee/mppm/export.h>
+#include <cee/mppm/recording.h>
+
+#include <cee/core/except.h>
+#include <cee/dsp/simd.h>
+
+#include <gtest/gtest.h>
+
+#include "test_recording.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace cee;
+using cee::test::TempPath;
+
+static constexpr float RATE = 250.f;
+
+static uint8_t Code(uint64_t sample, int channel) {
+	return static_cast<uint8_t>(sample * (channel + 1) * 7 + channel * 31);
+}
+
+// Chunks of chunkSamples from a second in, samples from gapAt on gap seconds late
+static void WriteRecording(const std::string &path, uint64_t total, std::size_t chunkSamples, double gap = 0.0,
+		uint64_t gapAt = 0) {
+	test::WriteRecording(path, total, { .sampleRate = RATE, .chunkSamples = chunkSamples, .start = 1000000000,
+			.gap = gap, .gapAt = gapAt }, Code);
+}
+
+static std::string ReadFile(const std::string &path) {
+	std::ifstream file(path, std::ios::binary);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static std::string Field(const std::string &edf, std::size_t offset, std::size_t width) {
+	std::string field = edf.substr(offset, width);
+	field.erase(field.find_last_not_of(' ') + 1);
+	return field;
+}
+
+static int16_t ReadInt16(const std::string &edf, std::size_t offset) {
+	return static_cast<int16_t>(static_cast<uint8_t>(edf[offset]) | static_cast<uint8_t>(edf[offset + 1]) << 8);
+}
+
+TEST(Export, simdConversions)
+{
+	std::vector<uint8_t> planes[4];
+	for (int c = 0; c < 4; ++c)
+		for (int i = 0; i < 77; ++i)
+			planes[c].push_back(Code(i, c));
+
+	std::vector<int16_t> widened(77);
+	dsp::WidenOffset(planes[1].data(), widened.data(), widened.size());
+	std::vector<uint8_t> frames(4 * 77);
+	dsp::Interleave4(planes[0].data(), planes[1].data(), planes[2].data(), planes[3].data(), frames.data(), 77);
+	for (int i = 0; i < 77; ++i) {
+		EXPECT_EQ(widened[i], planes[1][i] - 128);
+		for (int c = 0; c < 4; ++c)
+			EXPECT_EQ(frames[4 * i + c], planes[c][i]);
+	}
+}
+
+TEST(Export, edf)
+{
+	const uint64_t total = 625;
+	std::string recording = TempPath("cee_export_edf.rec");
+	std::string path = TempPath("cee_export.edf");
+	WriteRecording(recording, total, 200);
+	ExportEdf(recording, path);
+
+	const std::size_t signals = ADC_CHANNEL_COUNT + 1;
+	const std::size_t recordBytes = (ADC_CHANNEL_COUNT * 250 + 32) * 2;
+	std::string edf = ReadFile(path);
+	ASSERT_EQ(edf.size(), 256 * (signals + 1) + 3 * recordBytes);
+	EXPECT_EQ(Field(edf, 0, 8), "0");
+	EXPECT_EQ(Field(edf, 184, 8), std::to_string(256 * (signals + 1)));
+	EXPECT_EQ(Field(edf, 192, 44), "EDF+C");
+	EXPECT_EQ(Field(edf, 236, 8), "3");
+	EXPECT_EQ(Field(edf, 244, 8), "1");
+	EXPECT_EQ(Field(edf, 252, 4), std::to_string(signals));
+	EXPECT_EQ(Field(edf, 256, 16), "ECG II");
+	EXPECT_EQ(Field(edf, 256 + 16 * ADC_CHANNEL_COUNT, 16), "EDF Annotations");
+	// Physical maximum of the cuff pressure
+	EXPECT_EQ(Field(edf, 256 + signals * (16 + 80 + 8 + 8) + 8, 8), "300");
+
+	std::size_t data = 256 * (signals + 1);
+	for (uint64_t i = 0; i < 3 * 250; ++i) {
+		uint64_t record = i / 250;
+		uint64_t sample = std::min(i, total - 1);
+		for (int c = 0; c < ADC_CHANNEL_COUNT; ++c) {
+			std::size_t offset = data + record * recordBytes + (c * 250 + i % 250) * 2;
+			ASSERT_EQ(ReadInt16(edf, offset), Code(sample, c) - 128) << "sample " << i << " channel " << c;
+		}
+	}
+	std::size_t annotations = data + recordBytes + ADC_CHANNEL_COUNT * 250 * 2;
+	EXPECT_EQ(edf.substr(annotations, 5), std::string("+1\x14\x14\0", 5));
+}
+
+TEST(Export, edfDiscontinuous)
+{
+	std::string recording = TempPath("cee_export_gap.rec");
+	std::string path = TempPath("cee_export_gap.edf");
+	WriteRecording(recording, 500, 250, 10.0, 250);
+	ExportEdf(recording, path);
+
+	const std::size_t recordBytes = (ADC_CHANNEL_COUNT * 250 + 32) * 2;
+	std::string edf = ReadFile(path);
+	EXPECT_EQ(Field(edf, 192, 44), "EDF+D");
+	EXPECT_EQ(Field(edf, 236, 8), "2");
+	std::size_t annotations = 256 * (ADC_CHANNEL_COUNT + 2) + recordBytes + ADC_CHANNEL_COUNT * 250 * 2;
+	EXPECT_EQ(edf.substr(annotations, 6), std::string("+11\x14\x14\0", 6));
+
+	EXPECT_THROW(ExportEdf(TempPath("cee_export_missing.rec"), path), core::FileError);
+}
+
+TEST(Export, edfGapInsideChunk)
+{
+	// One chunk with a gap 100 samples into the first record
+	std::string recording = TempPath("cee_export_chunk_gap.rec");
+	std::string path = TempPath("cee_export_chunk_gap.edf");
+	WriteRecording(recording, 750, 1000, 10.0, 100);
+	ExportEdf(recording, path);
+
+	const std::size_t data = 256 * (ADC_CHANNEL_COUNT + 2);
+	const std::size_t recordBytes = (ADC_CHANNEL_COUNT * 250 + 32) * 2;
+	std::string edf = ReadFile(path);
+	EXPECT_EQ(Field(edf, 192, 44), "EDF+D");
+	EXPECT_EQ(Field(edf, 236, 8), "4");
+	ASSERT_EQ(edf.size(), data + 4 * recordBytes);
+
+	// The record before the gap is padded with its last sample and the
+	// next starts with the sample after it, at its own time
+	const char *onsets[] = { "+0\x14\x14", "+10.4\x14\x14", "+11.4\x14\x14", "+12.4\x14\x14" };
+	for (std::size_t r = 0; r < 4; ++r) {
+		std::size_t annotations = data + r * recordBytes + ADC_CHANNEL_COUNT * 250 * 2;
+		EXPECT_EQ(edf.substr(annotations, std::strlen(onsets[r])), onsets[r]) << "record " << r;
+	}
+	for (int c = 0; c < ADC_CHANNEL_COUNT; ++c) {
+		EXPECT_EQ(ReadInt16(edf, data + (c * 250 + 99) * 2), Code(99, c) - 128);
+		EXPECT_EQ(ReadInt16(edf, data + (c * 250 + 249) * 2), Code(99, c) - 128);
+		EXPECT_EQ(ReadInt16(edf, data + recordBytes + c * 250 * 2), Code(100, c) - 128);
+	}
+}
+
+TEST(Export, edfShortGapHeld)
+{
+	// 50 samples missing mid-record, held rather than starting a record
+	// that would overlap the current one
+	std::string recording = TempPath("cee_export_short_gap.rec");
+	std::string path = TempPath("cee_export_short_gap.edf");
+	WriteRecording(recording, 500, 1000, 0.2, 100);
+	ExportEdf(recording, path);
+
+	const std::size_t data = 256 * (ADC_CHANNEL_COUNT + 2);
+	std::string edf = ReadFile(path);
+	EXPECT_EQ(Field(edf, 192, 44), "EDF+C");
+	EXPECT_EQ(Field(edf, 236, 8), "3");
+	for (int c = 0; c < ADC_CHANNEL_COUNT; ++c) {
+		EXPECT_EQ(ReadInt16(edf, data + (c * 250 + 149) * 2), Code(99, c) - 128);
+		EXPECT_EQ(ReadInt16(edf, data + (c * 250 + 150) * 2), Code(100, c) - 128);
+	}
+}
+
+TEST(Export, wfdb)
+{
+	const uint64_t total = 1001;
+	std::string recording = TempPath("cee_export_wfdb.rec");
+	std::string record = TempPath("cee_export_wfdb");
+	const std::string recordName = std::filesystem::path(record).filename().string();
+	WriteRecording(recording, total, 300);
+	ExportWfdb(recording, record);
+
+	std::string dat = ReadFile(record + ".dat");
+	ASSERT_EQ(dat.size(), total * ADC_CHANNEL_COUNT);
+	int checksums[ADC_CHANNEL_COUNT] = {};
+	for (uint64_t i = 0; i < total; ++i) {
+		for (int c = 0; c < ADC_CHANNEL_COUNT; ++c) {
+			ASSERT_EQ(static_cast<uint8_t>(dat[i * ADC_CHANNEL_COUNT + c]), Code(i, c));
+			checksums[c] += Code(i, c) - 128;
+		}
+	}
+
+	std::istringstream hea(ReadFile(record + ".hea"));
+	std::string name, time, date;
+	int signals = 0;
+	float rate = 0.f;
+	uint64_t samples = 0;
+	hea >> name >> signals >> rate >> samples >> time >> date;
+	EXPECT_EQ(name, recordName);
+	EXPECT_EQ(signals, ADC_CHANNEL_COUNT);
+	EXPECT_EQ(rate, RATE);
+	EXPECT_EQ(samples, total);
+	for (int c = 0; c < ADC_CHANNEL_COUNT; ++c) {
+		std::string file, format, gain, bits, zero, description;
+		int initial = 0, checksum = 0;
+		hea >> file >> format >> gain >> bits >> zero >> initial >> checksum >> zero;
+		std::getline(hea, description);
+		EXPECT_EQ(file, recordName + ".dat");
+		EXPECT_EQ(format, "80");
+		EXPECT_EQ(initial, Code(0, c) - 128);
+		EXPECT_EQ(checksum, static_cast<int16_t>(checksums[c]));
+		if (c == 1) {
+			EXPECT_EQ(gain, "0.85(-128)/mmHg");
+		}
+	}
+}
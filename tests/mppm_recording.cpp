@@ -0,0 +1,215 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/capture.h>
+#include <cee/mppm/recorder.h>
+#include <cee/mppm/recording.h>
+
+#include <cee/core/except.h>
+
+#include <gtest/gtest.h>
+
+#include "test_recording.h"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace cee;
+using cee::test::TempPath;
+
+// Sample i has timestamp 4 ms * i and code (i * (channel + 1)) % 256 on each channel
+static RecordingChunk MakeChunk(uint64_t first, std::size_t count, int channels) {
+	RecordingChunk chunk;
+	chunk.channels.resize(channels);
+	for (uint64_t i = first; i < first + count; ++i) {
+		chunk.timestamps.push_back(i * 4000000);
+		for (int c = 0; c < channels; ++c)
+			chunk.channels[c].push_back(static_cast<uint8_t>(i * (c + 1)));
+	}
+	return chunk;
+}
+
+// Chunks of samples as MakeChunk() makes them
+static void WriteRecording(const std::string &path, std::size_t chunks, std::size_t samples,
+		RecordingEncoding encoding = RecordingEncoding::PACKED) {
+	test::WriteRecording(path, chunks * samples, { .channels = 4, .chunkSamples = samples, .encoding = encoding },
+			[](uint64_t i, int c) { return static_cast<uint8_t>(i * (c + 1)); });
+}
+
+TEST(Recording, roundTripAndSeek)
+{
+	for (RecordingEncoding encoding : { RecordingEncoding::RAW, RecordingEncoding::PACKED }) {
+		std::string path = TempPath("cee_recording_test.rec");
+		WriteRecording(path, 40, 100, encoding);
+
+		RecordingReader reader(path);
+		EXPECT_FALSE(reader.IsRecovered());
+		EXPECT_EQ(reader.GetSampleRate(), 250.f);
+		EXPECT_EQ(reader.GetChannelCount(), 4);
+		EXPECT_EQ(reader.GetChunkCount(), 40u);
+		EXPECT_EQ(reader.GetSampleCount(), 4000u);
+
+		EXPECT_EQ(reader.FindSample(0), 0u);
+		EXPECT_EQ(reader.FindSample(1234), 12u);
+		EXPECT_EQ(reader.FindSample(4000), 40u);
+		EXPECT_EQ(reader.FindTime(1234 * 4000000ull), 12u);
+		EXPECT_EQ(reader.FindTime(1200 * 4000000ull - 1), 11u);
+
+		RecordingChunk chunk;
+		reader.ReadChunk(reader.FindSample(1234), chunk);
+		EXPECT_EQ(chunk.firstSample, 1200u);
+		ASSERT_EQ(chunk.GetSampleCount(), 100u);
+		EXPECT_EQ(chunk.timestamps[34], 1234 * 4000000ull);
+		EXPECT_EQ(chunk.channels[2][34], static_cast<uint8_t>(1234 * 3));
+		std::filesystem::remove(path);
+	}
+}
+
+TEST(Recording, recoversWithoutFooter)
+{
+	std::string path = TempPath("cee_recording_crash.rec");
+	WriteRecording(path, 10, 100);
+	// No index or footer, and the last chunk cut short mid-write
+	std::filesystem::resize_file(path, std::filesystem::file_size(path) - sizeof(RecordingFooter) -
+			10 * sizeof(RecordingIndexEntry) - 50);
+
+	RecordingReader reader(path);
+	EXPECT_TRUE(reader.IsRecovered());
+	EXPECT_EQ(reader.GetChunkCount(), 9u);
+	EXPECT_EQ(reader.GetSampleCount(), 900u);
+	RecordingChunk chunk;
+	reader.ReadChunk(8, chunk);
+	EXPECT_EQ(chunk.channels[0][99], static_cast<uint8_t>(899));
+	std::filesystem::remove(path);
+}
+
+TEST(Recording, flushedTailRewritten)
+{
+	std::string path = TempPath("cee_recording_flush.rec");
+	RecordingWriter writer(path, 250.f, 4, RecordingEncoding::RAW);
+	writer.Write(MakeChunk(0, 100, 4));
+	writer.Flush();
+	// Everything so far is on disk while still buffered
+	{
+		RecordingReader reader(path);
+		EXPECT_TRUE(reader.IsRecovered());
+		EXPECT_EQ(reader.GetSampleCount(), 100u);
+	}
+
+	// Crosses WRITE_SIZE, so the flushed tail goes out again with the block
+	for (uint64_t i = 1; i < 100; ++i)
+		writer.Write(MakeChunk(i * 100, 100, 4));
+	writer.Close();
+
+	RecordingReader reader(path);
+	EXPECT_FALSE(reader.IsRecovered());
+	ASSERT_EQ(reader.GetSampleCount(), 10000u);
+	RecordingChunk chunk;
+	for (std::size_t i : { std::size_t(0), std::size_t(1), std::size_t(99) }) {
+		reader.ReadChunk(i, chunk);
+		EXPECT_EQ(chunk.timestamps[99], (i * 100 + 99) * 4000000);
+		EXPECT_EQ(chunk.channels[1][99], static_cast<uint8_t>((i * 100 + 99) * 2));
+	}
+	std::filesystem::remove(path);
+}
+
+TEST(Recording, detectsDamage)
+{
+	std::string path = TempPath("cee_recording_damaged.rec");
+	WriteRecording(path, 4, 100);
+	{
+		RecordingReader reader(path);
+		std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp(static_cast<std::streamoff>(reader.GetChunkInfo(2).offset + sizeof(RecordingChunkHeader) + 10));
+		file.put('\x55');
+	}
+	RecordingReader reader(path);
+	RecordingChunk chunk;
+	reader.ReadChunk(1, chunk);
+	EXPECT_THROW(reader.ReadChunk(2, chunk), core::FileError);
+
+	{
+		std::ofstream out(path, std::ios::binary);
+		out << "definitely not a recording, but long enough for a header";
+	}
+	EXPECT_THROW(RecordingReader{ path }, core::FileError);
+	std::filesystem::remove(path);
+}
+
+TEST(Recording, recorder)
+{
+	std::string path = TempPath("cee_recorder_test.rec");
+	const std::size_t count = 3 * Recorder::CHUNK_SAMPLES + 40;
+	{
+		Recorder recorder(path, 500.f, 2, dsp::DecimatorKind::FIR);
+		recorder.Start();
+		std::vector<Sample> samples(count);
+		for (std::size_t i = 0; i < count; ++i)
+			samples[i] = { i * 2000000, { static_cast<uint8_t>(i), 1, 2, static_cast<uint8_t>(i >> 8) } };
+		for (std::size_t i = 0; i < count; i += 8)
+			recorder.Process(std::span<const Sample>(samples).subspan(i, std::min<std::size_t>(8, count - i)));
+		recorder.Stop();
+		EXPECT_EQ(recorder.GetRecordedCount(), count);
+		EXPECT_EQ(recorder.GetDroppedCount(), 0u);
+	}
+
+	RecordingReader reader(path);
+	ASSERT_EQ(reader.GetSampleCount(), count);
+	EXPECT_EQ(reader.GetChunkCount(), 4u);
+	EXPECT_EQ(reader.GetOversampling(), 2u);
+	EXPECT_EQ(reader.GetDecimator(), dsp::DecimatorKind::FIR);
+	RecordingChunk chunk;
+	reader.ReadChunk(3, chunk);
+	ASSERT_EQ(chunk.GetSampleCount(), 40u);
+	EXPECT_EQ(chunk.timestamps[39], (count - 1) * 2000000);
+	EXPECT_EQ(chunk.channels[0][39], static_cast<uint8_t>(count - 1));
+	EXPECT_EQ(chunk.channels[3][39], static_cast<uint8_t>((count - 1) >> 8));
+	std::filesystem::remove(path);
+}
+
+TEST(Recording, capturer)
+{
+	std::string path = TempPath("cee_capturer_test.cap");
+	const std::size_t count = 1000;
+	{
+		Capturer capturer(path, 500.f);
+		capturer.Start();
+		std::vector<Sample> samples(count);
+		for (std::size_t i = 0; i < count; ++i)
+			samples[i] = { i * 2000000, { static_cast<uint8_t>(i), 1, 2, static_cast<uint8_t>(i >> 8) } };
+		for (std::size_t i = 0; i < count; i += 8)
+			capturer.Process(std::span<const Sample>(samples).subspan(i, std::min<std::size_t>(8, count - i)));
+		capturer.Stop();
+		EXPECT_EQ(capturer.GetCapturedCount(), count);
+		EXPECT_EQ(capturer.GetDroppedCount(), 0u);
+		EXPECT_FALSE(capturer.HasFailed());
+	}
+
+	platform::I2CCaptureHeader header = platform::ReadI2CCaptureHeader(path);
+	EXPECT_EQ(header.sampleRate, 500.f);
+	ASSERT_EQ(std::filesystem::file_size(path), header.headerSize + count * header.channelCount);
+	std::ifstream in(path, std::ios::binary);
+	in.seekg(header.headerSize + (count - 1) * header.channelCount);
+	std::array<char, 4> last;
+	in.read(last.data(), last.size());
+	EXPECT_EQ(static_cast<uint8_t>(last[0]), static_cast<uint8_t>(count - 1));
+	EXPECT_EQ(static_cast<uint8_t>(last[3]), static_cast<uint8_t>((count - 1) >> 8));
+	std::filesystem::remove(path);
+}
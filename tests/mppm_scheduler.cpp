@@ -0,0 +1,144 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/scheduler.h>
+
+#include <cee/core/except.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace cee;
+
+TEST(JitterHistogram, bucketing)
+{
+	// Small values are exact
+	for (uint64_t value = 0; value < JitterHistogram::SUB_BUCKETS; ++value) {
+		EXPECT_EQ(JitterHistogram::BucketIndex(value), static_cast<int>(value));
+		EXPECT_EQ(JitterHistogram::BucketUpperBound(static_cast<int>(value)), value);
+	}
+
+	std::vector<uint64_t> values;
+	for (int bit = 4; bit < 64; ++bit) {
+		uint64_t power = uint64_t(1) << bit;
+		values.insert(values.end(), { power - 1, power, power + 1, power + power / 3 });
+	}
+	values.insert(values.end(), { 1000, 12345, 999999, 1000000000, UINT64_MAX });
+
+	for (uint64_t value : values) {
+		int index = JitterHistogram::BucketIndex(value);
+		ASSERT_GE(index, 0);
+		ASSERT_LT(index, JitterHistogram::BUCKET_COUNT);
+		uint64_t upper = JitterHistogram::BucketUpperBound(index);
+		EXPECT_GE(upper, value) << value;
+		EXPECT_LE(static_cast<double>(upper - value), static_cast<double>(value) / JitterHistogram::SUB_BUCKETS) << value;
+		// Upper bounds are the last value of their bucket
+		EXPECT_EQ(JitterHistogram::BucketIndex(upper), index);
+		if (upper != UINT64_MAX) {
+			EXPECT_EQ(JitterHistogram::BucketIndex(upper + 1), index + 1);
+		}
+	}
+	EXPECT_EQ(JitterHistogram::BucketIndex(UINT64_MAX), JitterHistogram::BUCKET_COUNT - 1);
+}
+
+TEST(JitterHistogram, statistics)
+{
+	JitterHistogram histogram;
+	EXPECT_EQ(histogram.GetCount(), 0u);
+	EXPECT_EQ(histogram.GetPercentile(99.0), 0u);
+	EXPECT_EQ(histogram.GetMean(), 0.0);
+
+	// 1 to 100 us
+	for (uint64_t i = 1; i <= 100; ++i)
+		histogram.Record(i * 1000);
+	EXPECT_EQ(histogram.GetCount(), 100u);
+	EXPECT_EQ(histogram.GetMin(), 1000u);
+	EXPECT_EQ(histogram.GetMax(), 100000u);
+	EXPECT_DOUBLE_EQ(histogram.GetMean(), 50500.0);
+	EXPECT_EQ(histogram.GetPercentile(50.0),
+			JitterHistogram::BucketUpperBound(JitterHistogram::BucketIndex(50000)));
+	// The bucket of the 99th value reaches past the maximum
+	EXPECT_EQ(histogram.GetPercentile(99.0), 100000u);
+	EXPECT_EQ(histogram.GetPercentile(100.0), 100000u);
+
+	histogram.Reset();
+	EXPECT_EQ(histogram.GetCount(), 0u);
+	EXPECT_EQ(histogram.GetMin(), UINT64_MAX);
+	EXPECT_EQ(histogram.GetMax(), 0u);
+}
+
+TEST(SampleScheduler, stats)
+{
+	SampleScheduler scheduler(1000.f);
+	JitterStats stats = scheduler.GetStats();
+	EXPECT_EQ(stats.wakeups, 0u);
+	EXPECT_EQ(stats.missedDeadlines, 0u);
+
+	// 99 wakeups 10 us late and one 5 ms late that skipped 3 periods
+	for (int i = 0; i < 99; ++i)
+		scheduler.RecordWakeup(10000, 1);
+	scheduler.RecordWakeup(5000000, 4);
+
+	stats = scheduler.GetStats();
+	EXPECT_EQ(stats.wakeups, 100u);
+	EXPECT_EQ(stats.missedDeadlines, 3u);
+	EXPECT_DOUBLE_EQ(stats.min, 10.0);
+	EXPECT_DOUBLE_EQ(stats.mean, (99 * 10.0 + 5000.0) / 100.0);
+	// The outlier stays out of the 99th percentile, which is within a
+	// bucket of the typical lateness
+	EXPECT_DOUBLE_EQ(stats.p99,
+			JitterHistogram::BucketUpperBound(JitterHistogram::BucketIndex(10000)) / 1000.0);
+	EXPECT_LE(stats.p99, 10.0 * (1.0 + 1.0 / JitterHistogram::SUB_BUCKETS));
+	EXPECT_DOUBLE_EQ(stats.max, 5000.0);
+
+	scheduler.RecordWakeup(0, 2);
+	stats = scheduler.GetStats();
+	EXPECT_EQ(stats.missedDeadlines, 4u);
+	EXPECT_DOUBLE_EQ(stats.min, 0.0);
+
+	scheduler.ResetStats();
+	stats = scheduler.GetStats();
+	EXPECT_EQ(stats.wakeups, 0u);
+	EXPECT_EQ(stats.missedDeadlines, 0u);
+}
+
+TEST(SampleScheduler, wait)
+{
+	SampleScheduler scheduler(1000.f);
+	EXPECT_EQ(scheduler.GetPeriod(), 1000000u);
+	EXPECT_THROW(scheduler.Wait(), core::UsageError);
+
+	scheduler.Start();
+	uint64_t wakeups = 0, periods = 0;
+	while (wakeups < 5) {
+		uint64_t expirations = scheduler.Wait();
+		if (expirations > 0) {
+			++wakeups;
+			periods += expirations;
+		}
+	}
+	scheduler.Stop();
+
+	JitterStats stats = scheduler.GetStats();
+	EXPECT_EQ(stats.wakeups, wakeups);
+	EXPECT_EQ(stats.missedDeadlines, periods - wakeups);
+	EXPECT_LE(stats.min, stats.mean);
+	EXPECT_LE(stats.p99, stats.max);
+}
@@ -0,0 +1,188 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/signals.h>
+
+#include <cee/core/except.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace cee;
+
+// Peak to peak of Lead II over its last second, after seconds of a tone at
+// hz sampled at adcRate
+static float LeadIISwing(SignalChain &chain, float adcRate, double hz, double seconds) {
+	const std::size_t count = static_cast<std::size_t>(seconds * adcRate);
+	std::vector<Sample> samples(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		double t = static_cast<double>(i) / adcRate;
+		samples[i].timestamp = static_cast<uint64_t>(t * 1e9);
+		samples[i].channels.fill(128);
+		samples[i].channels[0] = static_cast<uint8_t>(std::lround(128.0 + 100.0 * std::sin(2.0 * M_PI * hz * t)));
+	}
+	chain.Process(samples);
+
+	std::vector<float> output(SignalChain::OUTPUT_QUEUE_SIZE);
+	output.resize(chain.GetOutput(SignalChain::LEAD_II).DequeueSpan(std::span<float>(output)));
+	const std::size_t tail = static_cast<std::size_t>(chain.GetOutputRate());
+	EXPECT_GE(output.size(), tail);
+	auto [min, max] = std::minmax_element(output.end() - tail, output.end());
+	return *max - *min;
+}
+
+TEST(SignalChain, oversampledFilters)
+{
+	// The ADC runs four times faster than the channels are shown
+	const float adcRate = 1000.f;
+	const float inputSwing = 200.f / 255.f;
+
+	SignalChain inBand(adcRate, 50.f, SignalChain::DEFAULT_STATISTICS_WINDOW, 4);
+	EXPECT_FLOAT_EQ(inBand.GetOutputRate(), 250.f);
+	EXPECT_GT(LeadIISwing(inBand, adcRate, 10.0, 4.0), 0.8f * inputSwing);
+
+	SignalChain mains(adcRate, 50.f, SignalChain::DEFAULT_STATISTICS_WINDOW, 4);
+	EXPECT_LT(LeadIISwing(mains, adcRate, 50.0, 4.0), 0.05f * inputSwing);
+
+	SignalChain aboveLowPass(adcRate, 60.f, SignalChain::DEFAULT_STATISTICS_WINDOW, 4);
+	EXPECT_LT(LeadIISwing(aboveLowPass, adcRate, 90.0, 4.0), 0.05f * inputSwing);
+}
+
+TEST(SignalChain, outputRateTooLow)
+{
+	// 250 Hz decimated by four leaves the notch and low-pass past Nyquist
+	EXPECT_THROW(SignalChain(250.f, 50.f, SignalChain::DEFAULT_STATISTICS_WINDOW, 4), core::InvalidParameter);
+	EXPECT_NO_THROW(SignalChain(1000.f, 60.f, SignalChain::DEFAULT_STATISTICS_WINDOW, 4));
+}
+
+TEST(SignalChain, offlineWithoutMonitoring)
+{
+	const float adcRate = 250.f;
+	SignalChain chain(adcRate, 50.f, SignalChain::DEFAULT_STATISTICS_WINDOW, 1, dsp::DecimatorKind::CIC, false);
+	EXPECT_FALSE(chain.IsMonitoring());
+	EXPECT_THROW(chain.GetTrends(), core::UsageError);
+	EXPECT_THROW(chain.GetAlarms(), core::UsageError);
+	chain.OnReadError(0);
+	// The channels are processed all the same
+	EXPECT_GT(LeadIISwing(chain, adcRate, 10.0, 4.0), 0.5f);
+}
+
+// Lead II codes over seconds from start, beats at bpm or flat when bpm is 0
+static std::vector<Sample> LeadII(float rate, double start, double seconds, double bpm, int flat = 128) {
+	std::vector<Sample> samples(static_cast<std::size_t>(seconds * rate));
+	for (std::size_t i = 0; i < samples.size(); ++i) {
+		double t = start + static_cast<double>(i) / rate;
+		samples[i].timestamp = static_cast<uint64_t>(t * 1e9);
+		samples[i].channels.fill(128);
+		if (bpm > 0.0) {
+			double phase = std::fmod(t, 60.0 / bpm);
+			double ecg = 0.5 + (phase < 0.04 ? 0.35 * std::sin(M_PI * phase / 0.04) : 0.0);
+			samples[i].channels[0] = static_cast<uint8_t>(std::lround(ecg * 255.0));
+		} else {
+			samples[i].channels[0] = static_cast<uint8_t>(flat);
+		}
+	}
+	return samples;
+}
+
+TEST(SignalChain, heartRateKnown)
+{
+	const float rate = 250.f;
+	SignalChain chain(rate);
+	EXPECT_FALSE(chain.IsHeartRateKnown());
+
+	chain.Process(LeadII(rate, 0.0, 15.0, 60.0));
+	EXPECT_TRUE(chain.IsHeartRateKnown());
+	EXPECT_NEAR(chain.GetHeartRate(), 60.f, 3.f);
+
+	// Asystole on a connected lead is a known rate of 0
+	chain.Process(LeadII(rate, 15.0, 8.0, 0.0));
+	EXPECT_TRUE(chain.IsHeartRateKnown());
+	EXPECT_EQ(chain.GetHeartRate(), 0.f);
+
+	// Leads off
+	chain.Process(LeadII(rate, 23.0, 1.0, 0.0, 0));
+	EXPECT_FALSE(chain.IsHeartRateKnown());
+}
+
+// Feeds samples the way Acquisition does, in blocks, with every failed
+// read reported as it happens
+static void Acquire(SignalChain &chain, const std::vector<Sample> &samples, const std::vector<bool> &failed) {
+	std::vector<Sample> block;
+	for (std::size_t i = 0; i < samples.size(); ++i) {
+		if (failed[i]) {
+			chain.OnReadError(samples[i].timestamp);
+			continue;
+		}
+		block.push_back(samples[i]);
+		if (block.size() == Acquisition::BLOCK_SIZE) {
+			chain.Process(block);
+			block.clear();
+		}
+	}
+	chain.Process(block);
+}
+
+TEST(SignalChain, intermittentAdcFailure)
+{
+	const float rate = 250.f;
+	SignalChain chain(rate);
+	std::vector<Sample> samples = LeadII(rate, 0.0, 2.0, 60.0);
+
+	// One read in ten failing, with plenty of good blocks in between
+	std::vector<bool> failed(samples.size());
+	for (std::size_t i = 0; i < failed.size(); ++i)
+		failed[i] = i % 10 == 5;
+	Acquire(chain, samples, failed);
+
+	AlarmStatus status = chain.GetAlarms().GetSnapshot().alarms[SignalChain::ADC_FAILURE];
+	EXPECT_EQ(status.state, AlarmState::ACTIVE);
+	EXPECT_NEAR(status.onset / 1e9, samples[5].timestamp / 1e9 + 0.5, 1.0 / rate);
+}
+
+TEST(SignalChain, adcGlitch)
+{
+	const float rate = 250.f;
+	SignalChain chain(rate);
+	std::vector<Sample> samples = LeadII(rate, 0.0, 3.0, 60.0);
+
+	// A lone failed read clears before the onset delay
+	std::vector<bool> failed(samples.size());
+	failed[250] = true;
+	Acquire(chain, samples, failed);
+	EXPECT_EQ(chain.GetAlarms().GetSnapshot().alarms[SignalChain::ADC_FAILURE].state, AlarmState::INACTIVE);
+}
+
+TEST(SignalChain, leadOffOnsetPerSample)
+{
+	const float rate = 250.f;
+	SignalChain chain(rate);
+	// The lead comes off part way through a block
+	const std::size_t off = 1003;
+	std::vector<Sample> samples = LeadII(rate, 0.0, 6.0, 60.0);
+	for (std::size_t i = off; i < samples.size(); ++i)
+		samples[i].channels[0] = 0;
+	chain.Process(samples);
+
+	AlarmStatus status = chain.GetAlarms().GetSnapshot().alarms[SignalChain::LEAD_OFF];
+	EXPECT_EQ(status.state, AlarmState::ACTIVE);
+	EXPECT_EQ(status.onset, samples[off + static_cast<std::size_t>(0.5f * rate)].timestamp);
+}
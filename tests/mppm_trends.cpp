@@ -0,0 +1,181 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/mppm/trends.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace cee;
+
+static constexpr uint64_t SECOND = TrendStore::SECOND;
+static constexpr uint64_t HOUR = 3600 * SECOND;
+
+// One value every 100 ms, a slow sine between 0 and 1 with a period of an hour
+static void Fill(TrendStore &store, uint64_t start, uint64_t end) {
+	for (uint64_t t = start; t < end; t += SECOND / 10) {
+		float value = 0.5f + 0.5f * static_cast<float>(std::sin(2.0 * M_PI * static_cast<double>(t) / static_cast<double>(HOUR)));
+		store.Push(0, value, t);
+	}
+}
+
+TEST(TrendStore, buckets)
+{
+	TrendStore store(2);
+	std::vector<float> values = { 1.f, 3.f, std::nanf(""), 2.f };
+	store.Push(1, values, 10 * SECOND);
+	store.Push(1, 5.f, 10 * SECOND + SECOND / 2);
+	store.Push(1, -1.f, 11 * SECOND);
+	// Open until the next second starts
+	store.Push(1, 0.f, 12 * SECOND);
+	EXPECT_EQ(store.GetLatest(), 12 * SECOND);
+
+	std::array<TrendPoint, 3> points;
+	store.Query(1, 10 * SECOND, 13 * SECOND, points);
+	ASSERT_TRUE(points[0].IsValid());
+	EXPECT_FLOAT_EQ(points[0].min, 1.f);
+	EXPECT_FLOAT_EQ(points[0].max, 5.f);
+	EXPECT_FLOAT_EQ(points[0].mean, 11.f / 4.f);
+	EXPECT_FLOAT_EQ(points[1].mean, -1.f);
+	EXPECT_FALSE(points[2].IsValid());
+
+	// Coarser levels are current as far as the finest
+	store.Query(1, 0, 60 * SECOND, std::span(points).first(1));
+	EXPECT_FLOAT_EQ(points[0].min, -1.f);
+	EXPECT_FLOAT_EQ(points[0].max, 5.f);
+	EXPECT_FLOAT_EQ(points[0].mean, 10.f / 5.f);
+
+	store.Query(0, 0, 60 * SECOND, points);
+	EXPECT_FALSE(points[0].IsValid());
+}
+
+TEST(TrendStore, day)
+{
+	TrendStore store(1);
+	const uint64_t start = 1000 * HOUR;
+	Fill(store, start, start + 24 * HOUR);
+
+	// Pixels of ten minutes and of a minute give the same envelope
+	std::vector<TrendPoint> coarse(144);
+	store.Query(0, start, start + 24 * HOUR, coarse);
+	std::vector<TrendPoint> fine(1440);
+	store.Query(0, start, start + 24 * HOUR, fine);
+	for (std::size_t i = 0; i < coarse.size(); ++i) {
+		ASSERT_TRUE(coarse[i].IsValid());
+		float min = fine[10 * i].min;
+		float max = fine[10 * i].max;
+		for (std::size_t j = 10 * i; j < 10 * i + 10; ++j) {
+			min = std::min(min, fine[j].min);
+			max = std::max(max, fine[j].max);
+		}
+		EXPECT_FLOAT_EQ(coarse[i].min, min);
+		EXPECT_FLOAT_EQ(coarse[i].max, max);
+		EXPECT_GE(coarse[i].mean, min);
+		EXPECT_LE(coarse[i].mean, max);
+	}
+	// Each hour spans the whole sine
+	std::vector<TrendPoint> hours(24);
+	store.Query(0, start, start + 24 * HOUR, hours);
+	for (const TrendPoint &point : hours) {
+		EXPECT_NEAR(point.min, 0.f, 1e-4f);
+		EXPECT_NEAR(point.max, 1.f, 1e-4f);
+		EXPECT_NEAR(point.mean, 0.5f, 1e-3f);
+	}
+
+	// The first hours have left the finest level, the pixels are still
+	// answered from the coarser ones
+	std::array<TrendPoint, 100> seconds;
+	store.Query(0, start, start + 100 * SECOND, seconds);
+	for (const TrendPoint &point : seconds)
+		EXPECT_TRUE(point.IsValid());
+	store.Query(0, start + 23 * HOUR, start + 23 * HOUR + 100 * SECOND, seconds);
+	for (const TrendPoint &point : seconds)
+		EXPECT_LT(point.max - point.min, 0.01f);
+}
+
+TEST(TrendStore, weightedMean)
+{
+	TrendStore store(1);
+	std::vector<float> values = { 1.f, 1.f, 1.f };
+	store.Push(0, values, 10 * SECOND);
+	store.Push(0, 5.f, 11 * SECOND);
+	store.Push(0, 0.f, 12 * SECOND);
+
+	// Both seconds in one point, weighted by how many values each holds
+	std::array<TrendPoint, 1> points;
+	store.Query(0, 10 * SECOND, 12 * SECOND, points);
+	ASSERT_TRUE(points[0].IsValid());
+	EXPECT_FLOAT_EQ(points[0].mean, 8.f / 4.f);
+}
+
+TEST(TrendStore, gaps)
+{
+	TrendStore store(1);
+	Fill(store, 0, HOUR);
+	Fill(store, 2 * HOUR, 3 * HOUR);
+	std::array<TrendPoint, 3> points;
+	store.Query(0, 0, 3 * HOUR, points);
+	EXPECT_TRUE(points[0].IsValid());
+	EXPECT_FALSE(points[1].IsValid());
+	EXPECT_TRUE(points[2].IsValid());
+
+	// A week later the ring slots have been reused
+	Fill(store, 7 * 24 * HOUR, 7 * 24 * HOUR + HOUR + SECOND);
+	store.Query(0, 0, 3 * HOUR, points);
+	EXPECT_FALSE(points[0].IsValid());
+
+	store.Reset();
+	EXPECT_EQ(store.GetLatest(), 0u);
+	store.Query(0, 7 * 24 * HOUR, 7 * 24 * HOUR + HOUR, points);
+	EXPECT_FALSE(points[0].IsValid());
+}
+
+TEST(TrendStore, concurrent)
+{
+	TrendStore store(1);
+	std::atomic<bool> done = false;
+	std::thread writer([&] {
+		// A constant per second, so any bucket mixing two stores would show
+		for (uint64_t t = 0; t < 2 * HOUR; t += SECOND / 4)
+			store.Push(0, static_cast<float>(t / SECOND), t);
+		done = true;
+	});
+
+	std::array<TrendPoint, 500> points;
+	while (!done) {
+		store.Query(0, 0, 2 * HOUR, points);
+		for (const TrendPoint &point : points) {
+			if (point.IsValid()) {
+				ASSERT_LE(point.min, point.max);
+			}
+		}
+		std::array<TrendPoint, 10> seconds;
+		uint64_t latest = store.GetLatest() / SECOND * SECOND;
+		store.Query(0, latest - std::min(latest, 10 * SECOND), latest, seconds);
+		for (const TrendPoint &point : seconds) {
+			if (point.IsValid()) {
+				ASSERT_EQ(point.min, point.max);
+			}
+		}
+	}
+	writer.join();
+}
@@ -0,0 +1,93 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/core/except.h>
+#include <cee/platform/i2c.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+using cee::platform::I2CContextType;
+using cee::platform::I2CController;
+using cee::platform::PCF8591;
+
+static std::unique_ptr<PCF8591> MakeAdc(const std::string &config) {
+	auto ctrl = I2CController::Create(config, I2CContextType::PLATFORM_I2C_CONTEXT_MOCK, nullptr);
+	return std::make_unique<PCF8591>(ctrl, 0x48);
+}
+
+TEST(MockI2C, constantChannels) {
+	auto adc = MakeAdc("ch0=dc::0:10,ch1=dc::0:20,ch2=dc::0:30,ch3=dc::0:40");
+	adc->StartScan();
+	std::array<uint8_t, PCF8591::MAX_CHANNELS> values;
+	for (int i = 0; i < 4; ++i) {
+		ASSERT_EQ(adc->Scan(values), 4);
+		EXPECT_EQ(values, (std::array<uint8_t, 4>{ 10, 20, 30, 40 }));
+	}
+}
+
+TEST(MockI2C, differentialModes) {
+	auto adc = MakeAdc("ch0=dc::0:10,ch1=dc::0:20,ch2=dc::0:30,ch3=dc::0:45");
+	std::array<uint8_t, PCF8591::MAX_CHANNELS> values;
+
+	adc->StartScan(PCF8591::InputMode::TWO_DIFFERENTIAL);
+	ASSERT_EQ(adc->Scan(values), 2);
+	EXPECT_EQ(static_cast<int8_t>(values[0]), -10);
+	EXPECT_EQ(static_cast<int8_t>(values[1]), -15);
+
+	adc->StartScan(PCF8591::InputMode::ONE_DIFFERENTIAL);
+	ASSERT_EQ(adc->Scan(values), 3);
+	EXPECT_EQ(values[0], 10);
+	EXPECT_EQ(values[1], 20);
+	EXPECT_EQ(static_cast<int8_t>(values[2]), -15);
+}
+
+TEST(MockI2C, simulatedClock) {
+	// 1 Hz square wave sampled at 128 Hz flips every 64 samples. The
+	// priming read in StartScan() takes the first sample.
+	auto adc = MakeAdc("rate=128,ch0=square:1:100:128");
+	adc->StartScan();
+	std::array<uint8_t, PCF8591::MAX_CHANNELS> values;
+	for (int i = 1; i <= 512; ++i) {
+		adc->Scan(values);
+		EXPECT_EQ(values[0], i % 128 < 64 ? 228 : 28) << "sample " << i;
+	}
+}
+
+TEST(MockI2C, reproducible) {
+	auto a = MakeAdc("ch0=ecg:1.3,ch2=triangle:0.7:50:100");
+	auto b = MakeAdc("ch0=ecg:1.3,ch2=triangle:0.7:50:100");
+	a->StartScan();
+	b->StartScan();
+	std::array<uint8_t, PCF8591::MAX_CHANNELS> va, vb;
+	for (int i = 0; i < 10000; ++i) {
+		a->Scan(va);
+		b->Scan(vb);
+		ASSERT_EQ(va, vb) << "sample " << i;
+	}
+}
+
+TEST(MockI2C, invalidConfig) {
+	EXPECT_THROW(MakeAdc("ch0=blip"), cee::core::InvalidParameter);
+	EXPECT_THROW(MakeAdc("ch4=sine"), cee::core::InvalidParameter);
+	EXPECT_THROW(MakeAdc("rate=0"), cee::core::InvalidParameter);
+	EXPECT_THROW(MakeAdc("ch0=sine:x"), cee::core::InvalidParameter);
+	EXPECT_THROW(MakeAdc("ch0=sine:1:2:3:4"), cee::core::InvalidParameter);
+}
@@ -0,0 +1,88 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cee/core/except.h>
+#include <cee/platform/i2c.h>
+#include <cee/platform/i2c_capture.h>
+
+#include <gtest/gtest.h>
+
+#include "test_utils.h"
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using cee::platform::I2CCaptureWriter;
+using cee::platform::I2CContextType;
+using cee::platform::I2CController;
+using cee::platform::PCF8591;
+using cee::test::TempPath;
+
+using Frame = std::array<uint8_t, PCF8591::MAX_CHANNELS>;
+
+static std::vector<Frame> CaptureMock(const std::string &path, int count) {
+	auto mock = I2CController::Create("ch0=ecg,ch1=sawtooth:3:100:128",
+			I2CContextType::PLATFORM_I2C_CONTEXT_MOCK);
+	PCF8591 adc(mock, 0x48);
+	adc.StartScan();
+	I2CCaptureWriter writer(path, 250.f);
+	std::vector<Frame> frames(count);
+	for (Frame &frame : frames) {
+		adc.Scan(frame);
+		writer.Write(frame);
+	}
+	return frames;
+}
+
+TEST(ReplayI2C, replaysCapture) {
+	std::string path = TempPath("cee_replay_test.cap");
+	std::vector<Frame> captured = CaptureMock(path, 500);
+
+	EXPECT_EQ(cee::platform::ReadI2CCaptureHeader(path).sampleRate, 250.f);
+
+	auto replay = I2CController::Create(path, I2CContextType::PLATFORM_I2C_CONTEXT_REPLAY);
+	ASSERT_TRUE(replay);
+	PCF8591 adc(replay, 0x48);
+	adc.StartScan();
+	Frame frame;
+	// Second pass checks playback loops
+	for (int pass = 0; pass < 2; ++pass) {
+		for (std::size_t i = 0; i < captured.size(); ++i) {
+			ASSERT_EQ(adc.Scan(frame), 4);
+			ASSERT_EQ(frame, captured[i]) << "frame " << i << " pass " << pass;
+		}
+	}
+	std::filesystem::remove(path);
+}
+
+TEST(ReplayI2C, rejectsInvalidFiles) {
+	std::string path = TempPath("cee_replay_invalid.cap");
+	{
+		std::ofstream out(path, std::ios::binary);
+		out << "definitely not a capture file, but long enough for a header";
+	}
+	EXPECT_THROW(I2CController::Create(path, I2CContextType::PLATFORM_I2C_CONTEXT_REPLAY),
+			cee::core::FileError);
+	EXPECT_THROW(cee::platform::ReadI2CCaptureHeader(path), cee::core::FileError);
+	std::filesystem::remove(path);
+
+	EXPECT_THROW(I2CController::Create(path, I2CContextType::PLATFORM_I2C_CONTEXT_REPLAY),
+			cee::core::FileError);
+}
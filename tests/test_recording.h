@@ -0,0 +1,72 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CEE_TESTS_TEST_RECORDING_H_
+#define CEE_TESTS_TEST_RECORDING_H_
+
+#include "test_utils.h"
+
+#include <cee/mppm/acquisition.h>
+#include <cee/mppm/recording.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cee {
+namespace test {
+	struct RecordingLayout {
+		float sampleRate = 250.f;
+		int channels = ADC_CHANNEL_COUNT;
+		std::size_t chunkSamples = 1024;
+		RecordingEncoding encoding = RecordingEncoding::PACKED;
+		std::size_t oversampling = 1;
+		dsp::DecimatorKind decimator = dsp::DecimatorKind::CIC;
+		// Timestamp of the first sample, nanoseconds
+		uint64_t start = 0;
+		// Samples from gapAt on are gap seconds late
+		double gap = 0.0;
+		uint64_t gapAt = 0;
+	};
+
+	// Writes total samples in chunks of layout.chunkSamples, channel c of
+	// sample i holding code(i, c)
+	template<typename F>
+	void WriteRecording(const std::string &path, uint64_t total, const RecordingLayout &layout, F code) {
+		RecordingWriter writer(path, layout.sampleRate, layout.channels, layout.encoding, layout.oversampling,
+				layout.decimator);
+		RecordingChunk chunk;
+		for (uint64_t first = 0; first < total; first += layout.chunkSamples) {
+			chunk.Clear();
+			chunk.firstSample = first;
+			chunk.channels.resize(layout.channels);
+			for (uint64_t i = first; i < std::min<uint64_t>(first + layout.chunkSamples, total); ++i) {
+				double seconds = static_cast<double>(i) / layout.sampleRate + (i >= layout.gapAt ? layout.gap : 0.0);
+				chunk.timestamps.push_back(layout.start + static_cast<uint64_t>(std::llround(seconds * 1e9)));
+				for (int c = 0; c < layout.channels; ++c)
+					chunk.channels[c].push_back(code(i, c));
+			}
+			writer.Write(chunk);
+		}
+		writer.Close();
+	}
+}
+}
+
+#endif
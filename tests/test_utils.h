@@ -0,0 +1,64 @@
+/*
+ * ceeMPPM
+ * Copyright (C) 2026 Chloe Eather
+ *
+ * This program is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef CEE_TESTS_TEST_UTILS_H_
+#define CEE_TESTS_TEST_UTILS_H_
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+namespace cee {
+namespace test {
+	namespace detail {
+		// Directory of this run's files, removed with everything in it
+		// when the tests exit
+		class TempDirectory {
+		public:
+			TempDirectory()
+			 : m_Path(std::filesystem::temp_directory_path() / ("cee_tests_" + std::to_string(::getpid()))) {
+				std::filesystem::create_directories(m_Path);
+			}
+
+			~TempDirectory() {
+				std::error_code error;
+				std::filesystem::remove_all(m_Path, error);
+			}
+
+			const std::filesystem::path &GetPath() const { return m_Path; }
+
+		private:
+			std::filesystem::path m_Path;
+		};
+
+		inline const TempDirectory &GetTempDirectory() {
+			static TempDirectory directory;
+			return directory;
+		}
+	}
+
+	// File in a temporary directory of this run's own, so concurrent runs
+	// don't share it
+	inline std::string TempPath(const std::string &name) {
+		return (detail::GetTempDirectory().GetPath() / name).string();
+	}
+}
+}
+
+#endif